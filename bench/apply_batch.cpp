@@ -0,0 +1,55 @@
+// apply_batch vs operator[] and erase, per op, on a map of argv[1] random int keys (default
+// 1M), for sorted batches of 100 to 1M ops: 80% upserts, 20% erases
+#include <algorithm>
+#include "bench/bench.hpp"
+#include "map.hpp"
+
+typedef ft::map<int, int> map_type;
+
+struct byKey
+{
+	bool operator()(const map_type::batch_op& a, const map_type::batch_op& b) const { return (a.key < b.key); }
+};
+
+int main(int ac, char** av)
+{
+	const int		n = static_cast<int>(bench::arg(ac, av, 1000000));
+	const size_t	batches = 20;
+	bench::rng		r(7);
+	map_type		base;
+
+	for (int i = 0; i < n; ++i)
+		base[static_cast<int>(r() % (2 * n))] = i;
+	printf("%zu entries, ns per op\n%9s %9s %11s\n", base.size(), "batch", "op loop", "apply_batch");
+	for (size_t size = 100; size <= 1000000; size *= 10){
+		std::vector<std::vector<map_type::batch_op> >	ops(batches);
+		map_type										a(base);
+		map_type										b(base);
+		double											t0, t1, t2;
+
+		for (size_t j = 0; j < batches; ++j){
+			for (size_t i = 0; i < size; ++i){
+				int k = static_cast<int>(r() % (2 * n));
+
+				if (r() % 5 == 0)
+					ops[j].push_back(map_type::batch_op(k));
+				else
+					ops[j].push_back(map_type::batch_op(k, static_cast<int>(i)));}
+			std::stable_sort(ops[j].begin(), ops[j].end(), byKey());}
+		t0 = bench::now();
+		for (size_t j = 0; j < batches; ++j)
+			for (size_t i = 0; i < size; ++i){
+				if (ops[j][i].erase)
+					a.erase(ops[j][i].key);
+				else
+					a[ops[j][i].key] = ops[j][i].value;}
+		t1 = bench::now();
+		for (size_t j = 0; j < batches; ++j)
+			b.apply_batch(ops[j].begin(), ops[j].end());
+		t2 = bench::now();
+		if (!(a == b))
+			printf("results differ\n");
+		printf("%9zu %9.0f %11.0f\n", size, (t1 - t0) / (size * batches), (t2 - t1) / (size * batches));
+	}
+	return (0);
+}
@@ -0,0 +1,86 @@
+// red_black vs avl vs wavl: average and worst depth, lookup throughput, and insert and erase
+// time and rotations per operation, on random keys or (with a second argument) sequential ones
+#include <map>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <stdexcept>
+#include "bench/bench.hpp"
+#define private public // the depth walk reads the nodes
+#include "map.hpp"
+#undef private
+
+static unsigned long g_rotations;
+
+// the same schemes, counting their rotations
+struct countedRedBlack: ft::red_black { static void rotated() { ++g_rotations; } };
+struct countedAvl: ft::avl { static void rotated() { ++g_rotations; } };
+struct countedWavl: ft::wavl { static void rotated() { ++g_rotations; } };
+
+template <class N>
+static int depth(const N* x, const N* nil, int d, double& sum)
+{
+	int l, r;
+
+	if (x == nil)
+		return (d - 1);
+	sum += d;
+	l = depth(x->left, nil, d + 1, sum);
+	r = depth(x->right, nil, d + 1, sum);
+	return (l > r ? l : r);
+}
+
+template <class B>
+static void run(const char* name, const std::vector<int>& keys)
+{
+	typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, ft::no_augment,
+		ft::inline_values, B> M;
+	size_t				n = keys.size();
+	std::vector<int>	query(2000000);
+	bench::rng			r(11);
+	M					m;
+	double				sum = 0;
+	int					height;
+	long				c = 0;
+	double				t0, t1, t2, t3, t4, insertRot, eraseRot;
+
+	for (size_t i = 0; i < query.size(); ++i)
+		query[i] = keys[r() % n];
+	g_rotations = 0;
+	t0 = bench::now();
+	for (size_t i = 0; i < n; ++i)
+		m.insert(ft::make_pair(keys[i], static_cast<int>(i)));
+	t1 = bench::now();
+	insertRot = static_cast<double>(g_rotations) / n;
+	height = depth(m._tree._root, m._tree._nil, 1, sum);
+	sum /= m.size();
+	t2 = bench::now();
+	for (size_t i = 0; i < query.size(); ++i)
+		c += m.count(query[i]);
+	t3 = bench::now();
+	g_rotations = 0;
+	for (size_t i = 0; i < n; i += 2)
+		c += m.erase(keys[i]);
+	t4 = bench::now();
+	eraseRot = static_cast<double>(g_rotations) / ((n + 1) / 2);
+	bench::keep(c);
+	printf("%-10s %6.2f %6d %9.1f %9.0f %8.3f %9.0f %8.3f\n", name, sum, height, query.size() / (t3 - t2) * 1e3,
+		(t1 - t0) / n, insertRot, (t4 - t3) / ((n + 1) / 2), eraseRot);
+}
+
+int main(int ac, char** av)
+{
+	size_t				n = bench::arg(ac, av, 1000000);
+	bool				sequential = ac > 2;
+	std::vector<int>	keys(n);
+	bench::rng			r(2);
+
+	for (size_t i = 0; i < n; ++i)
+		keys[i] = sequential ? static_cast<int>(i) : static_cast<int>(r() >> 33);
+	printf("%zu %s keys\n%-10s %6s %6s %9s %9s %8s %9s %8s\n", n, sequential ? "sequential" : "random", "",
+		"depth", "height", "M find/s", "insert ns", "rot/ins", "erase ns", "rot/era");
+	run<countedRedBlack>("red_black", keys);
+	run<countedAvl>("avl", keys);
+	run<countedWavl>("wavl", keys);
+	return (0);
+}
@@ -0,0 +1,67 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <stdint.h>
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#ifdef __GLIBC__
+# include <malloc.h>
+#endif
+
+// shared by the benchmark drivers: a monotonic clock, a sink the optimizer cannot drop,
+// and a reproducible key generator
+namespace bench
+{
+	inline double now() {
+		timespec t;
+
+		clock_gettime(CLOCK_MONOTONIC, &t);
+		return (t.tv_sec * 1e9 + t.tv_nsec);
+	}
+
+	template <class T>
+	inline void keep(const T& x) { asm volatile("" : : "g"(&x) : "memory"); }
+
+	// xorshift64*, so every run and every driver sees the same keys
+	struct rng
+	{
+		uint64_t s;
+
+		explicit rng(uint64_t seed = 88172645463325252ULL): s(seed) {}
+		uint64_t operator()() {
+			s ^= s >> 12;
+			s ^= s << 25;
+			s ^= s >> 27;
+			return (s * 2685821657736338717ULL);
+		}
+	};
+
+	// n distinct-ish random keys of type K
+	template <class K>
+	std::vector<K> randomKeys(size_t n, uint64_t seed = 1) {
+		std::vector<K> v(n);
+		rng r(seed);
+
+		for (size_t i = 0; i < n; ++i)
+			v[i] = static_cast<K>(r());
+		return (v);
+	}
+
+	// bytes the heap has handed out, chunk headers included (0 outside glibc)
+	inline size_t heapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+		struct mallinfo2 m = mallinfo2();
+
+		return (m.uordblks + m.hblkhd);
+#else
+		return (0);
+#endif
+	}
+
+	// size from argv[1], so a run can be made smaller or larger than the default
+	inline size_t arg(int ac, char** av, size_t def) { return (ac > 1 ? strtoul(av[1], 0, 10) : def); }
+}
+
+#endif
@@ -0,0 +1,60 @@
+// map with and without a bloom_filter: insert, then count() over probe streams from all
+// hits to all misses, at sizes from 10k up to argv[1] (default 4M) long keys
+#include "bench/bench.hpp"
+#include "map.hpp"
+
+typedef ft::map<long, long>	plainMap;
+typedef ft::map<long, long, std::less<long>, std::allocator<ft::pair<const long, long> >,
+	ft::no_augment, ft::inline_values, ft::red_black, ft::bloom_filter>	filteredMap;
+
+static const size_t	probes = 1000000;
+static const int	missPercents[] = { 0, 50, 90, 100 };
+
+// probe streams with a given share of misses: stored keys are even, misses odd, so both
+// descend the same tree
+template <class M>
+static void run(const char* name, const std::vector<long>& keys, const std::vector<std::vector<long> >& streams)
+{
+	size_t	n = keys.size();
+	long	c = 0;
+	double	t0, t1;
+	M		m;
+
+	t0 = bench::now();
+	for (size_t i = 0; i < n; ++i)
+		m.insert(ft::make_pair(keys[i], static_cast<long>(i)));
+	t1 = bench::now();
+	printf("%9zu %-8s %9.0f", n, name, (t1 - t0) / n);
+	for (size_t s = 0; s < streams.size(); ++s){
+		t0 = bench::now();
+		for (size_t i = 0; i < probes; ++i)
+			c += m.count(streams[s][i]);
+		t1 = bench::now();
+		printf(" %9.0f", (t1 - t0) / probes);}
+	printf("\n");
+	bench::keep(c);
+}
+
+int main(int ac, char** av)
+{
+	size_t		max = bench::arg(ac, av, 4000000);
+	bench::rng	r(5);
+
+	printf("%9s %-8s %9s", "entries", "", "insert ns");
+	for (size_t s = 0; s < sizeof(missPercents) / sizeof(*missPercents); ++s)
+		printf("  miss %3d%%", missPercents[s]);
+	printf("   (ns per count)\n");
+	for (size_t n = 10000; n <= max; n *= 20){
+		std::vector<long>				keys = bench::randomKeys<long>(n);
+		std::vector<std::vector<long> >	streams(sizeof(missPercents) / sizeof(*missPercents), std::vector<long>(probes));
+
+		for (size_t i = 0; i < n; ++i)
+			keys[i] &= ~1L;
+		for (size_t s = 0; s < streams.size(); ++s)
+			for (size_t i = 0; i < probes; ++i)
+				streams[s][i] = keys[r() % n] | (static_cast<int>(r() % 100) < missPercents[s]);
+		run<plainMap>("plain", keys, streams);
+		run<filteredMap>("bloom", keys, streams);
+	}
+	return (0);
+}
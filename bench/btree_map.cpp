@@ -0,0 +1,44 @@
+// btree_map vs map on random int keys: insert, find, in-order scan and heap bytes per entry
+#include "bench/bench.hpp"
+#include "btree_map.hpp"
+#include "map.hpp"
+
+template <class M>
+void run(const char* name, const std::vector<int>& keys)
+{
+	size_t	n = keys.size();
+	size_t	heap0 = bench::heapInUse();
+	long	sum = 0;
+	double	t0, t1, t2, t3;
+	size_t	mem;
+
+	{
+		M m;
+		t0 = bench::now();
+		for (size_t i = 0; i < n; ++i)
+			m.insert(ft::make_pair(keys[i], static_cast<int>(i)));
+		t1 = bench::now();
+		mem = bench::heapInUse() - heap0;
+		for (size_t i = 0; i < n; ++i)
+			sum += (*m.find(keys[(i * 7919) % n])).second;
+		t2 = bench::now();
+		for (typename M::iterator it = m.begin(); it != m.end(); ++it)
+			sum += (*it).first;
+		t3 = bench::now();
+		bench::keep(sum);
+	}
+	printf("%-12s %9.0f %9.0f %10.1f %10.1f\n", name, (t1 - t0) / n, (t2 - t1) / n, (t3 - t2) / n,
+		static_cast<double>(mem) / n);
+}
+
+int main(int ac, char** av)
+{
+	size_t				n = bench::arg(ac, av, 4000000);
+	std::vector<int>	keys = bench::randomKeys<int>(n);
+
+	printf("%zu random int keys\n%-12s %9s %9s %10s %10s\n", n, "", "insert ns", "find ns", "scan ns", "B/entry");
+	run<ft::map<int, int> >("map", keys);
+	run<ft::btree_map<int, int> >("btree 256B", keys);
+	run<ft::btree_map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, 512> >("btree 512B", keys);
+	return (0);
+}
@@ -0,0 +1,105 @@
+// concurrent_map throughput for 95/5 and 50/50 read/write mixes at 1 to 64 threads, next
+// to one ft::map behind one mutex (what it replaces)
+#include <pthread.h>
+#include "bench/bench.hpp"
+#include "concurrent_map.hpp"
+#include "map.hpp"
+
+static const int	keySpace = 100000;
+static const long	opsPerThread = 200000;
+
+struct lockedMap
+{
+	pthread_mutex_t				lock;
+	ft::map<int, long>			map;
+
+	lockedMap() { pthread_mutex_init(&lock, 0); }
+	~lockedMap() { pthread_mutex_destroy(&lock); }
+	void insert(int k) { pthread_mutex_lock(&lock); map.insert(ft::make_pair(k, static_cast<long>(k))); pthread_mutex_unlock(&lock); }
+	void erase(int k) { pthread_mutex_lock(&lock); map.erase(k); pthread_mutex_unlock(&lock); }
+	bool find(int k, long& v) {
+		pthread_mutex_lock(&lock);
+		ft::map<int, long>::iterator it = map.find(k);
+		bool found = it != map.end();
+		if (found)
+			v = it->second;
+		pthread_mutex_unlock(&lock);
+		return (found); }
+};
+
+struct sharded
+{
+	ft::concurrent_map<int, long>	map;
+
+	explicit sharded(size_t shards): map(shards) {}
+	void insert(int k) { map.insert(ft::make_pair(k, static_cast<long>(k))); }
+	void erase(int k) { map.erase(k); }
+	bool find(int k, long& v) { return (map.find(k, v)); }
+};
+
+template <class M>
+struct job
+{
+	M*			map;
+	int			writePct;
+	uint64_t	seed;
+};
+
+template <class M>
+void* work(void* arg)
+{
+	job<M>*		j = static_cast<job<M>*>(arg);
+	bench::rng	r(j->seed);
+	long		v = 0;
+
+	for (long i = 0; i < opsPerThread; ++i){
+		uint64_t	x = r();
+		int			k = static_cast<int>(x % keySpace);
+		if (static_cast<int>((x >> 32) % 100) < j->writePct){
+			if (x & (1ULL << 63))
+				j->map->insert(k);
+			else
+				j->map->erase(k);}
+		else
+			j->map->find(k, v);
+	}
+	bench::keep(v);
+	return (0);
+}
+
+template <class M>
+double run(M& m, int threads, int writePct)
+{
+	std::vector<pthread_t>	th(threads);
+	std::vector<job<M> >	jobs(threads);
+	double					t0;
+
+	for (int k = 0; k < keySpace; k += 2)
+		m.insert(k);
+	t0 = bench::now();
+	for (int i = 0; i < threads; ++i){
+		jobs[i].map = &m;
+		jobs[i].writePct = writePct;
+		jobs[i].seed = i + 1;
+		pthread_create(&th[i], 0, work<M>, &jobs[i]);}
+	for (int i = 0; i < threads; ++i)
+		pthread_join(th[i], 0);
+	return (threads * opsPerThread / (bench::now() - t0) * 1e3);
+}
+
+int main(int ac, char** av)
+{
+	size_t shards = bench::arg(ac, av, 64);
+
+	printf("Mops/s, %d keys, %zu shards\n%8s %8s %14s %14s\n", keySpace, shards, "mix", "threads", "mutex+map", "concurrent_map");
+	for (int writePct = 5; writePct <= 50; writePct += 45){
+		for (int threads = 1; threads <= 64; threads *= 2){
+			lockedMap	a;
+			sharded		b(shards);
+			double		ta = run(a, threads, writePct);
+			double		tb = run(b, threads, writePct);
+			printf("%5d/%-2d %8d %14.2f %14.2f\n", 100 - writePct, writePct, threads, ta, tb);
+		}
+	}
+	return (0);
+}
@@ -0,0 +1,43 @@
+// find_batch and count_batch vs a loop of find on a map larger than the last-level cache
+// (the default 8M long entries take about 400 MB of nodes); half the probes miss
+#include "bench/bench.hpp"
+#include "map.hpp"
+
+typedef ft::map<long, long>	map_type;
+
+int main(int ac, char** av)
+{
+	size_t						n = bench::arg(ac, av, 8000000);
+	size_t						probes = 1000000;
+	std::vector<long>			keys = bench::randomKeys<long>(n);
+	std::vector<long>			query(probes);
+	std::vector<map_type::iterator>	found(probes);
+	map_type					m;
+	bench::rng					r(7);
+	long						sum = 0;
+	size_t						heap0 = bench::heapInUse();
+	double						t0, t1, t2, t3;
+
+	// even keys are stored, odd keys miss, so misses descend the same tree as hits
+	for (size_t i = 0; i < n; ++i)
+		m.insert(ft::make_pair(keys[i] & ~1L, static_cast<long>(i)));
+	for (size_t i = 0; i < probes; ++i)
+		query[i] = (keys[r() % n] & ~1L) | static_cast<long>(i & 1);
+	printf("%zu random long keys, %.0f MB of nodes, %zu probes\n", m.size(),
+		static_cast<double>(bench::heapInUse() - heap0) / (1 << 20), probes);
+
+	t0 = bench::now();
+	for (size_t i = 0; i < probes; ++i)
+		found[i] = m.find(query[i]);
+	t1 = bench::now();
+	m.find_batch(query.begin(), query.end(), found.begin());
+	t2 = bench::now();
+	sum += m.count_batch(query.begin(), query.end());
+	t3 = bench::now();
+	bench::keep(sum);
+	bench::keep(found);
+
+	printf("find loop   %6.0f ns/key\nfind_batch  %6.0f ns/key\ncount_batch %6.0f ns/key\n",
+		(t1 - t0) / probes, (t2 - t1) / probes, (t3 - t2) / probes);
+	return (0);
+}
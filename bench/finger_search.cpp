@@ -0,0 +1,159 @@
+// find and lower_bound from the root vs from a finger (the previous result) on sequential,
+// clustered (a +-64 random walk) and random streams of present keys, and appends with an
+// end() hint. argv[1] entries (default 1M); with a second argument the map is compacted
+// first. A finger search cannot start before the last one ends, so the root searches are
+// timed both independent (their misses overlap) and chained to the previous result.
+// Last, insert(hint, v) against insert(v) with hints that are right, and useless
+#include <algorithm>
+#include "bench/bench.hpp"
+#include "map.hpp"
+
+typedef ft::map<int, int> map_type;
+
+struct byFind
+{
+	static map_type::iterator root(map_type& m, int k) { return (m.find(k)); }
+	static map_type::iterator finger(map_type& m, map_type::iterator h, int k) { return (m.find(h, k)); }
+};
+
+struct byLowerBound
+{
+	static map_type::iterator root(map_type& m, int k) { return (m.lower_bound(k)); }
+	static map_type::iterator finger(map_type& m, map_type::iterator h, int k) { return (m.lower_bound(h, k)); }
+};
+
+// ns per lookup: independent from the root, chained from the root, from the finger
+template <class Search>
+static void lookups(map_type& m, const std::vector<int>& keys, double* ns)
+{
+	volatile int		zero = 0;
+	int					z = zero;
+	int					prev = 0;
+	size_t				q = keys.size();
+	long				sink = 0;
+	map_type::iterator	h;
+	map_type::iterator	f;
+	double				t0, t1, t2, t3;
+
+	t0 = bench::now();
+	for (size_t i = 0; i < q; ++i)
+		sink += Search::root(m, keys[i]) != m.end();
+	t1 = bench::now();
+	for (size_t i = 0; i < q; ++i){
+		f = Search::root(m, keys[i] + (prev & z));
+		if (f != m.end())
+			prev = f->second;}
+	t2 = bench::now();
+	h = m.begin();
+	for (size_t i = 0; i < q; ++i){
+		f = Search::finger(m, h, keys[i]);
+		if (f != m.end())
+			h = f;}
+	t3 = bench::now();
+	bench::keep(sink);
+	bench::keep(prev);
+	bench::keep(h);
+	ns[0] = (t1 - t0) / q;
+	ns[1] = (t2 - t1) / q;
+	ns[2] = (t3 - t2) / q;
+}
+
+static void stream(const char* name, map_type& m, const std::vector<int>& keys)
+{
+	double f[3], l[3];
+
+	lookups<byFind>(m, keys, f);
+	lookups<byLowerBound>(m, keys, l);
+	printf("%-11s %7.0f %7.0f %7.0f   %7.0f %7.0f %7.0f\n", name, f[0], f[1], f[2], l[0], l[1], l[2]);
+}
+
+// ns per insert (each key erased right after, so the map keeps its shape) of odd keys: in
+// order with the hint just after the key, and in random order with begin() as the hint,
+// each against plain insert. Blocks of the two take turns, each going first as often
+static void hintedInserts(map_type& m, int n, bench::rng& r)
+{
+	static const int	block = 20000;
+	double				ns[4] = { 0, 0, 0, 0 };
+	map_type::iterator	h = m.find(0);
+	map_type::iterator	first = m.begin();
+	std::vector<int>	keys(block);
+	double				t0;
+	int					next = 0;
+
+	for (int turn = 0; turn < 200; ++turn){
+		int		pass = (turn / 4 % 2) * 2 + ((turn % 4 == 1 || turn % 4 == 2) ? 1 : 0);
+		bool	inOrder = pass < 2;
+
+		for (int i = 0; i < block; ++i)
+			keys[i] = inOrder ? (next + i) % (n - 1) * 2 + 1 : static_cast<int>(r() % n) * 2 + 1;
+		if (inOrder)
+			h = m.find(keys[0] + 1);
+		t0 = bench::now();
+		for (int i = 0; i < block; ++i){
+			ft::pair<const int, int> v(keys[i], i);
+
+			if (pass == 0 || pass == 2)
+				m.erase(m.insert(v).first);
+			else if (pass == 1){
+				m.erase(m.insert(h, v));
+				if (++h == m.end())
+					h = m.find(2);}
+			else
+				m.erase(m.insert(first, v));}
+		ns[pass] += bench::now() - t0;
+		if (inOrder && pass == 1)
+			next = (next + block) % (n - 1);}
+	printf("insert in order %.0f ns, hint after the key %.0f ns; in random order %.0f ns, hint begin() %.0f ns\n",
+		ns[0] / (50 * block), ns[1] / (50 * block), ns[2] / (50 * block), ns[3] / (50 * block));
+}
+
+int main(int ac, char** av)
+{
+	const int			n = static_cast<int>(bench::arg(ac, av, 1000000));
+	const size_t		q = 2000000;
+	std::vector<int>	order(n);
+	std::vector<int>	seq(q), clustered(q), random(q);
+	bench::rng			r(3);
+	map_type			m;
+	int					w = n / 2;
+	double				t0, t1, t2;
+
+	// keys 0, 2, 4... inserted in random order, so the nodes are scattered in memory
+	for (int i = 0; i < n; ++i)
+		order[i] = i;
+	for (int i = n - 1; i > 0; --i)
+		std::swap(order[i], order[r() % (i + 1)]);
+	for (int i = 0; i < n; ++i)
+		m[order[i] * 2] = i;
+	if (ac > 2)
+		m.compact();
+	for (size_t i = 0; i < q; ++i){
+		seq[i] = static_cast<int>(i % n) * 2;
+		w += static_cast<int>(r() % 65) - 32;
+		w = w < 0 ? 0 : (w >= n ? n - 1 : w);
+		clustered[i] = w * 2;
+		random[i] = static_cast<int>(r() % n) * 2;}
+
+	printf("%d entries%s, ns per lookup\n%-11s %23s   %23s\n%-11s %7s %7s %7s   %7s %7s %7s\n", n,
+		ac > 2 ? " (compacted)" : "", "", "find", "lower_bound", "", "root", "chained", "finger", "root", "chained", "finger");
+	stream("sequential", m, seq);
+	stream("clustered", m, clustered);
+	stream("random", m, random);
+
+	t0 = bench::now();
+	{
+		map_type a;
+		for (int i = 0; i < n; ++i)
+			a.insert(ft::make_pair(i, i));
+	}
+	t1 = bench::now();
+	{
+		map_type a;
+		for (int i = 0; i < n; ++i)
+			a.insert(a.end(), ft::make_pair(i, i));
+	}
+	t2 = bench::now();
+	printf("sequential insert %.0f ns, with an end() hint %.0f ns\n", (t1 - t0) / n, (t2 - t1) / n);
+	hintedInserts(m, n, r);
+	return (0);
+}
@@ -0,0 +1,39 @@
+// flat_map vs map: random finds of present keys at growing sizes, to find the size where
+// the sorted array overtakes the tree
+#include "bench/bench.hpp"
+#include "flat_map.hpp"
+#include "map.hpp"
+
+int main(int ac, char** av)
+{
+	size_t				maxN = bench::arg(ac, av, 1 << 22);
+	size_t				queries = 1000000;
+	bench::rng			r(7);
+
+	printf("%10s %12s %12s\n", "entries", "flat_map ns", "map ns");
+	for (size_t n = 16; n <= maxN; n *= 4){
+		std::vector<int>					keys = bench::randomKeys<int>(n, n);
+		std::vector<std::pair<int, int> >	in;
+		std::vector<int>					q;
+		ft::map<int, int>					m;
+		long								sum = 0;
+		double								t0, t1, t2;
+
+		for (size_t i = 0; i < n; ++i){
+			in.push_back(std::make_pair(keys[i], static_cast<int>(i)));
+			m.insert(ft::make_pair(keys[i], static_cast<int>(i)));}
+		ft::flat_map<int, int> f(in.begin(), in.end());
+		for (size_t i = 0; i < queries; ++i)
+			q.push_back(keys[r() % n]);
+		t0 = bench::now();
+		for (size_t i = 0; i < queries; ++i)
+			sum += f.find(q[i])->second;
+		t1 = bench::now();
+		for (size_t i = 0; i < queries; ++i)
+			sum += m.find(q[i])->second;
+		t2 = bench::now();
+		bench::keep(sum);
+		printf("%10zu %12.1f %12.1f\n", n, (t1 - t0) / queries, (t2 - t1) / queries);
+	}
+	return (0);
+}
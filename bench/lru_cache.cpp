@@ -0,0 +1,138 @@
+// lru_cache, concurrent_lru_cache (16 shards, one thread) and a hand-made map + std::list
+// cache on a Zipfian key stream: get, and put on a miss. ns per request and hit rate for
+// skews 0.99 and 0.8, caches of 1% and 10% of a 1M-key universe
+#include <list>
+#include <cmath>
+#include <algorithm>
+#include "bench/bench.hpp"
+#include "lru_cache.hpp"
+#include "map.hpp"
+
+static const size_t	universe = 1000000;
+static const size_t	requests = 3000000;
+
+// the usual cache by hand: a map to the entry's list position, the list in recency order
+struct handCache
+{
+	typedef std::list<std::pair<long, long> >	recency;
+	typedef ft::map<long, recency::iterator>	index;
+
+	size_t		cap;
+	recency		l;
+	index		m;
+	size_t		hits;
+	size_t		misses;
+
+	handCache(size_t c): cap(c), hits(0), misses(0) {}
+
+	bool get(long k, long& v) {
+		index::iterator it = m.find(k);
+
+		if (it == m.end()){
+			++misses;
+			return (false);}
+		++hits;
+		l.splice(l.begin(), l, it->second);
+		v = it->second->second;
+		return (true);
+	}
+
+	void put(long k, long v) {
+		l.push_front(std::make_pair(k, v));
+		m.insert(ft::make_pair(k, l.begin()));
+		while (m.size() > cap){
+			m.erase(l.back().first);
+			l.pop_back();}
+	}
+
+	double hitRate() const { return (static_cast<double>(hits) / (hits + misses)); }
+};
+
+// the same interface over both ft caches
+template <class C>
+struct ftCache
+{
+	C c;
+
+	ftCache(size_t cap): c(cap) {}
+	bool get(long k, long& v) {
+		long* p = c.get(k);
+
+		if (p)
+			v = *p;
+		return (p != 0);
+	}
+	void put(long k, long v) { c.put(k, v); }
+	double hitRate() const { return (c.stats().hit_rate()); }
+};
+
+template <>
+struct ftCache<ft::concurrent_lru_cache<long, long> >
+{
+	ft::concurrent_lru_cache<long, long> c;
+
+	ftCache(size_t cap): c(cap, 16) {}
+	bool get(long k, long& v) { return (c.get(k, v)); }
+	void put(long k, long v) { c.put(k, v); }
+	double hitRate() const { return (c.stats().hit_rate()); }
+};
+
+// rank i is drawn with probability proportional to 1 / (i + 1)^s; ranks map to scattered keys
+static std::vector<long> zipf(double s, bench::rng& r)
+{
+	std::vector<double>	cdf(universe);
+	std::vector<long>	key(universe);
+	std::vector<long>	out(requests);
+	double				sum = 0;
+
+	for (size_t i = 0; i < universe; ++i){
+		sum += 1.0 / pow(static_cast<double>(i + 1), s);
+		cdf[i] = sum;
+		key[i] = static_cast<long>(r() >> 1);}
+	for (size_t i = 0; i < requests; ++i){
+		double u = static_cast<double>(r() >> 11) / (1ULL << 53) * sum;
+		out[i] = key[std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin()];}
+	return (out);
+}
+
+template <class C>
+static void run(size_t cap, const std::vector<long>& stream)
+{
+	C		c(cap);
+	long	v = 0, acc = 0;
+	double	t0, t1;
+
+	t0 = bench::now();
+	for (size_t i = 0; i < stream.size(); ++i){
+		if (c.get(stream[i], v))
+			acc += v;
+		else
+			c.put(stream[i], stream[i]);}
+	t1 = bench::now();
+	bench::keep(acc);
+	printf(" %9.1f %6.3f", (t1 - t0) / stream.size(), c.hitRate());
+}
+
+int main()
+{
+	static const double	skews[] = { 0.99, 0.8 };
+	static const size_t	caps[] = { universe / 100, universe / 10 };
+	bench::rng			r(11);
+
+	printf("%5s %7s %16s %16s %16s\n", "", "", "lru_cache", "concurrent (16)", "map + std::list");
+	printf("%5s %7s", "skew", "cache");
+	for (int i = 0; i < 3; ++i)
+		printf(" %9s %6s", "ns", "hits");
+	printf("\n");
+	for (size_t s = 0; s < 2; ++s){
+		std::vector<long> stream = zipf(skews[s], r);
+
+		for (size_t c = 0; c < 2; ++c){
+			printf("%5.2f %7zu", skews[s], caps[c]);
+			run<ftCache<ft::lru_cache<long, long> > >(caps[c], stream);
+			run<ftCache<ft::concurrent_lru_cache<long, long> > >(caps[c], stream);
+			run<handCache>(caps[c], stream);
+			printf("\n");}
+	}
+	return (0);
+}
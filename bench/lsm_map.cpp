@@ -0,0 +1,106 @@
+// lsm_map vs map: random writes (blind upserts, a quarter of them erases), then find on hits
+// and misses, a full scan, and find again after lsm_map::compact(); sizes from 100k up to
+// argv[1] (default 4M) long keys
+#include "bench/bench.hpp"
+#include "lsm_map.hpp"
+#include "map.hpp"
+
+static const size_t probes = 1000000;
+
+struct result
+{
+	double write;
+	double hit;
+	double miss;
+	double scan;
+	double compacted;	// find after compact(), lsm_map only
+	size_t runs;		// before compact()
+};
+
+template <class M>
+static void upsert(M& m, long k, long v) { m.insert_or_assign(k, v); }
+
+template <>
+void upsert(ft::map<long, long>& m, long k, long v) { m[k] = v; }
+
+template <class M>
+static double finds(const M& m, const std::vector<long>& q)
+{
+	long	c = 0;
+	double	t0 = bench::now();
+
+	for (size_t i = 0; i < q.size(); ++i)
+		c += m.find(q[i]) != m.end();
+	bench::keep(c);
+	return ((bench::now() - t0) / q.size());
+}
+
+template <class M>
+static size_t compactIf(M&) { return (0); }
+
+static size_t compactIf(ft::lsm_map<long, long>& m) {
+	size_t runs = m.run_count();
+
+	m.compact();
+	return (runs);
+}
+
+template <class M>
+static result run(M& m, const std::vector<long>& keys, const std::vector<long>& hits, const std::vector<long>& misses)
+{
+	result	r;
+	long	c = 0;
+	size_t	n = 0;
+	double	t0;
+
+	t0 = bench::now();
+	for (size_t i = 0; i < keys.size(); ++i){
+		if (i % 4 == 3)
+			m.erase(keys[i - 2]);
+		else
+			upsert(m, keys[i], static_cast<long>(i));}
+	r.write = (bench::now() - t0) / keys.size();
+	r.hit = finds(m, hits);
+	r.miss = finds(m, misses);
+	t0 = bench::now();
+	for (typename M::const_iterator it = m.begin(); it != m.end(); ++it, ++n)
+		c += it->second;
+	r.scan = (bench::now() - t0) / n;
+	bench::keep(c);
+	r.runs = compactIf(m);
+	r.compacted = finds(m, hits);
+	return (r);
+}
+
+int main(int ac, char** av)
+{
+	size_t		max = bench::arg(ac, av, 4000000);
+	bench::rng	r(7);
+
+	printf("%9s %-9s %9s %9s %9s %9s %11s   (ns per op)\n", "writes", "", "write", "find hit", "find miss", "scan", "compacted");
+	for (size_t n = 100000; n <= max; n *= 4){
+		std::vector<long>	keys = bench::randomKeys<long>(n);
+		std::vector<long>	hits(probes), misses(probes);
+
+		// even keys are written, odd keys miss; the hits skip the erased keys (i % 4 == 1)
+		for (size_t i = 0; i < n; ++i)
+			keys[i] &= ~1L;
+		for (size_t i = 0; i < probes; ++i){
+			size_t j = r() % n;
+			hits[i] = keys[j % 4 == 1 ? j - 1 : j];
+			misses[i] = keys[r() % n] | 1;}
+		{
+			ft::lsm_map<long, long>	m;
+			result					x = run(m, keys, hits, misses);
+
+			printf("%9zu %-9s %9.0f %9.0f %9.0f %9.1f %11.0f   %zu runs\n", n, "lsm_map", x.write, x.hit, x.miss, x.scan, x.compacted, x.runs);
+		}
+		{
+			ft::map<long, long>	m;
+			result				x = run(m, keys, hits, misses);
+
+			printf("%9zu %-9s %9.0f %9.0f %9.0f %9.1f %11s\n", n, "map", x.write, x.hit, x.miss, x.scan, "");
+		}
+	}
+	return (0);
+}
@@ -0,0 +1,52 @@
+// node size, heap bytes per entry and random lookup time of map<int, int> and
+// map<uint64_t, uint64_t>, where the node overhead outweighs the payload; std::map for scale
+#include <map>
+#include "bench/bench.hpp"
+#include "map.hpp"
+
+template <class M, class K>
+static void run(const char* name, size_t nodeSize, size_t n)
+{
+	std::vector<K>	keys = bench::randomKeys<K>(n);
+	std::vector<K>	query(1000000);
+	bench::rng		r(5);
+	size_t			heap0 = bench::heapInUse();
+	size_t			mem;
+	K				sum = 0;
+	double			t0, t1;
+
+	for (size_t i = 0; i < query.size(); ++i)
+		query[i] = keys[r() % n];
+	{
+		M m;
+		for (size_t i = 0; i < n; ++i)
+			m[keys[i]] = static_cast<K>(i);
+		mem = bench::heapInUse() - heap0;
+		t0 = bench::now();
+		for (size_t i = 0; i < query.size(); ++i)
+			sum += m.find(query[i])->second;
+		t1 = bench::now();
+		bench::keep(sum);
+		n = m.size();
+	}
+	if (nodeSize)
+		printf("%-28s %8zu %6zu %9.1f %8.0f\n", name, n, nodeSize, static_cast<double>(mem) / n, (t1 - t0) / query.size());
+	else
+		printf("%-28s %8zu %6s %9.1f %8.0f\n", name, n, "-", static_cast<double>(mem) / n, (t1 - t0) / query.size());
+}
+
+int main(int ac, char** av)
+{
+	typedef ft::map<int, int>				ftInt;
+	typedef ft::map<uint64_t, uint64_t>		ftWide;
+	size_t									max = bench::arg(ac, av, 1000000);
+
+	printf("%-28s %8s %6s %9s %8s\n", "", "entries", "node", "B/entry", "find ns");
+	for (size_t n = 1000; n <= max; n *= 10){
+		run<ftInt, int>("ft::map<int, int>", sizeof(ftInt::node_type), n);
+		run<std::map<int, int>, int>("std::map<int, int>", 0, n);
+		run<ftWide, uint64_t>("ft::map<uint64_t, uint64_t>", sizeof(ftWide::node_type), n);
+		run<std::map<uint64_t, uint64_t>, uint64_t>("std::map<uint64_t, uint64_t>", 0, n);
+	}
+	return (0);
+}
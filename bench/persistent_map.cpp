@@ -0,0 +1,65 @@
+// write path of persistent_map against copy-on-snapshot (ft::map copied whole): random
+// insert_or_assign / erase with a snapshot taken every 100 updates and the last 4 kept
+#include "bench/bench.hpp"
+#include "persistent_map.hpp"
+#include "map.hpp"
+
+static const int updates = 20000;
+static const int every = 100;
+
+template <class M>
+static void update(M& m, int k, int i) {
+	if (i & 1)
+		m[k] = i;
+	else
+		m.erase(k);
+}
+
+template <class K, class T>
+static void update(ft::persistent_map<K, T>& m, int k, int i) {
+	if (i & 1)
+		m.insert_or_assign(k, i);
+	else
+		m.erase(k);
+}
+
+// ns per update, snapshot costs included; every == 0 takes none
+template <class M>
+static double run(M& m, int n, int snapshotEvery, uint64_t seed)
+{
+	bench::rng		r(seed);
+	std::vector<M>	keep;
+	double			t0 = bench::now();
+
+	for (int i = 0; i < updates; ++i){
+		update(m, static_cast<int>(r() % (2 * n)), i);
+		if (snapshotEvery && i % snapshotEvery == 0){
+			keep.push_back(m);
+			if (keep.size() > 4)
+				keep.erase(keep.begin());}
+	}
+	return ((bench::now() - t0) / updates);
+}
+
+int main(int ac, char** av)
+{
+	int maxN = static_cast<int>(bench::arg(ac, av, 1000000));
+
+	printf("ns per update, snapshot every %d updates\n%9s %16s %16s %16s %16s\n", every, "entries",
+		"persistent+snap", "persistent", "map+copy", "map");
+	for (int n = 10000; n <= maxN; n *= 10){
+		ft::persistent_map<int, int>	p;
+		ft::map<int, int>				m;
+		double							a, b, c, d;
+
+		for (int i = 0; i < n; ++i){
+			p.insert(ft::make_pair(i * 2, i));
+			m.insert(ft::make_pair(i * 2, i));}
+		a = run(p, n, every, 1);
+		b = run(p, n, 0, 2);
+		c = run(m, n, every, 1);
+		d = run(m, n, 0, 2);
+		printf("%9d %16.0f %16.0f %16.0f %16.0f\n", n, a, b, c, d);
+	}
+	return (0);
+}
@@ -0,0 +1,103 @@
+// radix_map vs map on 1M URLs under four hosts (argv[1] entries) and on 1M random ints:
+// insert, find, miss, lower_bound, an in-order scan, and bytes per entry. The bytes are
+// those the containers ask their allocator for (the keys' own string buffers excluded);
+// the heap column adds malloc's chunk overhead
+#include <string>
+#include "bench/bench.hpp"
+#include "radix_map.hpp"
+#include "map.hpp"
+
+static size_t g_requested;
+
+template <class T>
+struct countingAllocator: std::allocator<T>
+{
+	template <class U> struct rebind { typedef countingAllocator<U> other; };
+
+	countingAllocator() {}
+	template <class U> countingAllocator(const countingAllocator<U>&) {}
+
+	T* allocate(size_t n, const void* = 0) {
+		g_requested += n * sizeof(T);
+		return (std::allocator<T>().allocate(n)); }
+	void deallocate(T* p, size_t n) {
+		g_requested -= n * sizeof(T);
+		std::allocator<T>().deallocate(p, n); }
+};
+
+template <class M, class K>
+static void run(const char* name, const std::vector<K>& keys, const std::vector<K>& hits, const std::vector<K>& misses)
+{
+	size_t	n = keys.size();
+	size_t	q = hits.size();
+	size_t	heap0 = bench::heapInUse();
+	size_t	requested, heap;
+	long	sum = 0;
+	double	t0, t1, t2, t3, t4, t5;
+
+	g_requested = 0;
+	{
+		M m;
+		t0 = bench::now();
+		for (size_t i = 0; i < n; ++i)
+			m.insert(ft::make_pair(keys[i], static_cast<int>(i)));
+		t1 = bench::now();
+		requested = g_requested;
+		heap = bench::heapInUse() - heap0;
+		for (size_t i = 0; i < q; ++i)
+			sum += m.find(hits[i])->second;
+		t2 = bench::now();
+		for (size_t i = 0; i < q; ++i)
+			sum += m.count(misses[i]);
+		t3 = bench::now();
+		for (size_t i = 0; i < q; ++i){
+			typename M::iterator it = m.lower_bound(misses[i]);
+			sum += it == m.end() ? 0 : it->second;}
+		t4 = bench::now();
+		for (typename M::iterator it = m.begin(); it != m.end(); ++it)
+			sum += it->second;
+		t5 = bench::now();
+		bench::keep(sum);
+		n = m.size();
+	}
+	printf("%-16s %9.0f %9.0f %9.0f %9.0f %9.1f %9.1f %9.1f\n", name, (t1 - t0) / keys.size(), (t2 - t1) / q,
+		(t3 - t2) / q, (t4 - t3) / q, (t5 - t4) / n, static_cast<double>(requested) / n, static_cast<double>(heap) / n);
+}
+
+static void header(const char* what)
+{
+	printf("%s\n%-16s %9s %9s %9s %9s %9s %9s %9s\n", what, "", "insert", "find", "miss", "lower_b", "scan", "B/entry", "heap B");
+}
+
+int main(int ac, char** av)
+{
+	typedef countingAllocator<ft::pair<const std::string, int> >	stringAlloc;
+	typedef countingAllocator<ft::pair<const int, int> >			intAlloc;
+	const size_t					n = bench::arg(ac, av, 1000000);
+	const char*						hosts[] = { "https://www.example.com/", "https://static.example.com/assets/",
+		"https://api.example.org/v2/users/", "http://news.site.net/2024/" };
+	std::vector<std::string>		urls, urlHits, urlMisses;
+	std::vector<int>				ints = bench::randomKeys<int>(n, 5);
+	std::vector<int>				intHits, intMisses;
+	bench::rng						r(3);
+	char							b[96];
+
+	for (size_t i = 0; i < n; ++i){
+		sprintf(b, "%s%08x/item-%zu", hosts[r() % 4], static_cast<unsigned>(r() % 0x100000), i);
+		urls.push_back(b);}
+	for (size_t i = 0; i < n; ++i){
+		urlHits.push_back(urls[r() % n]);
+		urlMisses.push_back(urls[r() % n] + "x");
+		ints[i] &= ~1;}
+	for (size_t i = 0; i < n; ++i){
+		intHits.push_back(ints[r() % n]);
+		intMisses.push_back(ints[r() % n] | 1);}
+
+	header("URL keys, ns per op");
+	run<ft::map<std::string, int, std::less<std::string>, stringAlloc> >("map", urls, urlHits, urlMisses);
+	run<ft::radix_map<std::string, int, stringAlloc> >("radix_map", urls, urlHits, urlMisses);
+	header("random int keys, ns per op");
+	run<ft::map<int, int, std::less<int>, intAlloc> >("map", ints, intHits, intMisses);
+	run<ft::radix_map<int, int, intAlloc> >("radix_map", ints, intHits, intMisses);
+	return (0);
+}
@@ -0,0 +1,59 @@
+// inline_values vs split_values with 8-byte keys and 256-byte values: insert, a hit that
+// reads the value, a miss, and heap bytes per entry, at argv[1] entries (default 1M).
+// One size per run: the split layout's pool keeps freed pairs, so a second split map in
+// the same process would not show its memory
+#include "bench/bench.hpp"
+#include "map.hpp"
+
+struct big { char b[256]; };
+
+typedef std::allocator<ft::pair<const uint64_t, big> >								allocator_type;
+typedef ft::map<uint64_t, big, std::less<uint64_t>, allocator_type>						inlineMap;
+typedef ft::map<uint64_t, big, std::less<uint64_t>, allocator_type, ft::no_augment, ft::split_values>	splitMap;
+
+template <class M>
+static void run(const char* name, size_t n)
+{
+	std::vector<uint64_t>	keys = bench::randomKeys<uint64_t>(n);
+	std::vector<uint64_t>	query(2000000);
+	bench::rng				r(9);
+	big						v = big();
+	size_t					heap0 = bench::heapInUse();
+	size_t					mem;
+	long					sum = 0;
+	double					t0, t1, t2, t3;
+
+	// even keys are stored, odd keys miss
+	for (size_t i = 0; i < n; ++i)
+		keys[i] &= ~1ULL;
+	for (size_t i = 0; i < query.size(); ++i)
+		query[i] = keys[r() % n];
+	{
+		M m;
+		t0 = bench::now();
+		for (size_t i = 0; i < n; ++i){
+			v.b[0] = static_cast<char>(i);
+			m.insert(ft::make_pair(keys[i], v));}
+		t1 = bench::now();
+		mem = bench::heapInUse() - heap0;
+		for (size_t i = 0; i < query.size(); ++i)
+			sum += m.find(query[i])->second.b[0] + 1;
+		t2 = bench::now();
+		for (size_t i = 0; i < query.size(); ++i)
+			sum += m.count(query[i] | 1);
+		t3 = bench::now();
+		bench::keep(sum);
+	}
+	printf("%-8s %9zu %9.0f %9.0f %9.0f %9.1f\n", name, n, (t1 - t0) / n, (t2 - t1) / query.size(),
+		(t3 - t2) / query.size(), static_cast<double>(mem) / n);
+}
+
+int main(int ac, char** av)
+{
+	size_t n = bench::arg(ac, av, 1000000);
+
+	printf("%-8s %9s %9s %9s %9s %9s\n", "", "entries", "insert ns", "hit ns", "miss ns", "B/entry");
+	run<inlineMap>("inline", n);
+	run<splitMap>("split", n);
+	return (0);
+}
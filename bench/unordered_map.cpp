@@ -0,0 +1,57 @@
+// unordered_map vs map vs std::unordered_map on random int keys: insert, hit and miss
+// lookups, at table sizes from 1k up to argv[1] (default 10M)
+#include <unordered_map>
+#include "bench/bench.hpp"
+#include "unordered_map.hpp"
+#include "map.hpp"
+
+static const size_t probes = 1000000;
+
+template <class M>
+static void run(const char* name, const std::vector<int>& keys, const std::vector<int>& hits,
+	const std::vector<int>& misses)
+{
+	size_t	n = keys.size();
+	long	c = 0;
+	double	t0, t1, t2, t3;
+
+	{
+		M m;
+		t0 = bench::now();
+		for (size_t i = 0; i < n; ++i)
+			m[keys[i]] = static_cast<int>(i);
+		t1 = bench::now();
+		for (size_t i = 0; i < probes; ++i)
+			c += m.find(hits[i]) != m.end();
+		t2 = bench::now();
+		for (size_t i = 0; i < probes; ++i)
+			c += m.find(misses[i]) != m.end();
+		t3 = bench::now();
+		bench::keep(c);
+	}
+	printf("%9zu %-20s %9.0f %9.0f %9.0f\n", n, name, (t1 - t0) / n, (t2 - t1) / probes, (t3 - t2) / probes);
+}
+
+int main(int ac, char** av)
+{
+	size_t		max = bench::arg(ac, av, 10000000);
+	bench::rng	r(3);
+
+	printf("%9s %-20s %9s %9s %9s\n", "entries", "", "insert ns", "hit ns", "miss ns");
+	for (size_t n = 1000; n <= max; n *= 10){
+		std::vector<int>	keys = bench::randomKeys<int>(n);
+		std::vector<int>	hits(probes);
+		std::vector<int>	misses(probes);
+
+		// even keys are stored, odd keys miss
+		for (size_t i = 0; i < n; ++i)
+			keys[i] &= ~1;
+		for (size_t i = 0; i < probes; ++i){
+			hits[i] = keys[r() % n];
+			misses[i] = keys[r() % n] | 1;}
+		run<ft::unordered_map<int, int> >("ft::unordered_map", keys, hits, misses);
+		run<std::unordered_map<int, int> >("std::unordered_map", keys, hits, misses);
+		run<ft::map<int, int> >("ft::map", keys, hits, misses);
+	}
+	return (0);
+}
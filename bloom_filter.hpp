@@ -0,0 +1,161 @@
+#ifndef BLOOM_FILTER_HPP
+#define BLOOM_FILTER_HPP
+
+#include <stdint.h>
+#include <algorithm>
+#include "utils.hpp"
+#include "vector.hpp"
+
+namespace ft
+{
+	// counters of a map's membership filter, see map::filter_stats
+	struct filter_stats
+	{
+		size_t	bits;				// size of the filter
+		size_t	keys;				// keys added since the last rebuild, erased ones included
+		size_t	lookups;			// find, count and erase calls that asked the filter
+		size_t	rejected;			// of those, answered by the filter alone
+		size_t	false_positives;	// let through by the filter for a key that was not there
+
+		filter_stats(): bits(0), keys(0), lookups(0), rejected(0), false_positives(0) {}
+
+		// share of the misses that still searched the tree
+		double false_positive_rate() const {
+			return (rejected + false_positives ? static_cast<double>(false_positives) / (rejected + false_positives) : 0.0); }
+	};
+
+	// The Filter parameter of map: what a lookup asks before searching the tree. The map adds
+	// every inserted key, reports erased ones, and rebuilds the filter from the tree when
+	// rebuildDue says so.
+
+	// no filter (the default): every lookup searches the tree
+	struct no_filter
+	{
+		static const bool enabled = false;
+
+		template <class K> bool mayContain(const K&) const { return (true); }
+		void missed() const {}
+		template <class K> void add(const K&) {}
+		void erased(size_t) {}
+		bool rebuildDue() const { return (false); }
+		void reset(size_t) {}
+		void bitsPerKey(size_t) {}
+		void swap(no_filter&) {}
+		filter_stats stats() const { return (filter_stats()); }
+	};
+
+	// Split block Bloom filter: a key (hashed with ft::hash) selects one 32-byte block and
+	// sets one bit in each of its eight 32-bit words, so a lookup reads half a cache line,
+	// and about 1% of the misses get through at 10 bits per key. Bits cannot be cleared:
+	// erased keys stay in until a rebuild, which the map does once they outnumber the live
+	// ones, or when more keys were added than the filter was sized for (it is sized for twice
+	// the keys it was rebuilt with, so rebuilds are amortized O(1) per insert).
+	class bloom_filter
+	{
+		static const size_t		blockBits = 256;
+
+		size_t				_bitsPerKey;
+		ft::vector<uint32_t>	_words;		// 7 spare words to align the blocks to 32 bytes
+		size_t				_blocks;
+		size_t				_capacity;	// keys the filter was sized for
+		size_t				_added;
+		size_t				_erased;
+		mutable size_t		_lookups;
+		mutable size_t		_rejected;
+		mutable size_t		_falsePositives;
+
+		const uint32_t* block(uint64_t h) const {
+			uintptr_t base = (reinterpret_cast<uintptr_t>(_words.data()) + 31) & ~static_cast<uintptr_t>(31);
+
+			return (reinterpret_cast<const uint32_t*>(base) + 8 * static_cast<size_t>(((h >> 32) * _blocks) >> 32));
+		}
+
+		// bit i of the block: one per word, from the low half of the hash
+		static uint32_t bit(uint32_t x, int i) {
+			static const uint32_t salt[8] = { 0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+				0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U };
+
+			return (static_cast<uint32_t>(1) << ((x * salt[i]) >> 27));
+		}
+
+	public:
+		static const bool enabled = true;
+
+		bloom_filter(): _bitsPerKey(10), _blocks(0), _capacity(0), _added(0), _erased(0),
+			_lookups(0), _rejected(0), _falsePositives(0) {}
+
+		template <class K>
+		bool mayContain(const K& k) const {
+			const uint64_t	h = ft::hash<K>()(k);
+			const uint32_t*	w;
+			uint32_t		miss = 0;
+
+			++_lookups;
+			if (_blocks == 0){ // nothing added since the last rebuild
+				++_rejected;
+				return (false);}
+			w = block(h);
+			for (int i = 0; i < 8; ++i)
+				miss |= bit(static_cast<uint32_t>(h), i) & ~w[i];
+			_rejected += (miss != 0);
+			return (miss == 0);
+		}
+
+		void missed() const { ++_falsePositives; }
+
+		// with no blocks yet the key only counts, and rebuildDue asks for a rebuild
+		template <class K>
+		void add(const K& k) {
+			const uint64_t	h = ft::hash<K>()(k);
+			uint32_t*		w;
+
+			++_added;
+			if (_blocks == 0)
+				return ;
+			w = const_cast<uint32_t*>(block(h));
+			for (int i = 0; i < 8; ++i)
+				w[i] |= bit(static_cast<uint32_t>(h), i);
+		}
+
+		void erased(size_t n) { _erased += n; }
+
+		bool rebuildDue() const { return (_added > _capacity || _erased * 2 > _added); }
+
+		// empty, sized for twice n keys
+		void reset(size_t n) {
+			_blocks = n ? (2 * n * _bitsPerKey + blockBits - 1) / blockBits : 0;
+			_capacity = _blocks * blockBits / _bitsPerKey;
+			_words.assign(_blocks ? _blocks * 8 + 7 : 0, 0);
+			_added = 0;
+			_erased = 0;
+		}
+
+		void bitsPerKey(size_t bits) { _bitsPerKey = bits ? bits : 1; }
+
+		void swap(bloom_filter& x) {
+			std::swap(_bitsPerKey, x._bitsPerKey);
+			_words.swap(x._words);
+			std::swap(_blocks, x._blocks);
+			std::swap(_capacity, x._capacity);
+			std::swap(_added, x._added);
+			std::swap(_erased, x._erased);
+			std::swap(_lookups, x._lookups);
+			std::swap(_rejected, x._rejected);
+			std::swap(_falsePositives, x._falsePositives);
+		}
+
+		filter_stats stats() const {
+			filter_stats s;
+
+			s.bits = _blocks * blockBits;
+			s.keys = _added;
+			s.lookups = _lookups;
+			s.rejected = _rejected;
+			s.false_positives = _falsePositives;
+			return (s);
+		}
+	};
+
+}
+
+#endif
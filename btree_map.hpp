@@ -0,0 +1,694 @@
+#ifndef BTREE_MAP_HPP
+#define BTREE_MAP_HPP
+
+#include <memory>
+#include <functional>
+#include <stdexcept>
+#include "utils.hpp"
+#include "iterator.hpp"
+
+namespace ft
+{
+	union btreeAlign { long double ld; long long ll; void* p; };
+
+	// uninitialized, suitably aligned room for Bytes bytes of keys or values
+	template <size_t Bytes>
+	union btreeStorage
+	{
+		unsigned char	bytes[Bytes];
+		btreeAlign		align;
+	};
+
+	// how many entries fit in a node of about Bytes bytes, never less than 3
+	template <size_t Bytes, size_t Entry>
+	struct btreeSlots
+	{
+		static const size_t value = (Bytes > 32 + 3 * Entry) ? (Bytes - 32) / Entry : 3;
+	};
+
+	// leaf node; keys and values are two contiguous arrays so a node search only touches keys
+	template <class Key, class T, size_t Slots>
+	struct btreeNode
+	{
+		btreeNode*							parent;
+		unsigned short						position; // index in parent->children()
+		unsigned short						count;
+		bool								leaf;
+		btreeStorage<sizeof(Key) * Slots>	keyStorage;
+		btreeStorage<sizeof(T) * Slots>		valueStorage;
+
+		btreeNode(bool isLeaf): parent(0), position(0), count(0), leaf(isLeaf){};
+
+		Key* keys() { return reinterpret_cast<Key*>(keyStorage.bytes); }
+		const Key* keys() const { return reinterpret_cast<const Key*>(keyStorage.bytes); }
+		T* values() { return reinterpret_cast<T*>(valueStorage.bytes); }
+		const T* values() const { return reinterpret_cast<const T*>(valueStorage.bytes); }
+
+		btreeNode** children();
+		btreeNode* const* children() const;
+	};
+
+	template <class Key, class T, size_t Slots>
+	struct btreeInternal : public btreeNode<Key, T, Slots>
+	{
+		btreeNode<Key, T, Slots>*	child[Slots + 1];
+
+		btreeInternal(): btreeNode<Key, T, Slots>(false){};
+	};
+
+	template <class Key, class T, size_t Slots>
+	btreeNode<Key, T, Slots>** btreeNode<Key, T, Slots>::children() { return static_cast<btreeInternal<Key, T, Slots>*>(this)->child; }
+
+	template <class Key, class T, size_t Slots>
+	btreeNode<Key, T, Slots>* const* btreeNode<Key, T, Slots>::children() const { return static_cast<const btreeInternal<Key, T, Slots>*>(this)->child; }
+
+
+	// (node, slot) position; end() is one past the last slot of the rightmost leaf
+	template <class Node, class Key, class T>
+	struct btreeIterator
+	{
+		public:
+			typedef ft::pair<const Key, typename remove_const<T>::type>	value_type;
+			typedef pairRef<Key, T>										reference;
+			typedef pairRefArrow<Key, T>								pointer;
+			typedef bidirectional_iterator_tag							iterator_category;
+			typedef ptrdiff_t											difference_type;
+
+		private:
+			Node*	_node;
+			int		_pos;
+
+		public:
+			btreeIterator(Node* n = 0, int pos = 0): _node(n), _pos(pos){};
+
+			template <class Np, class Tp>
+			btreeIterator(const btreeIterator<Np, Key, Tp>& cp): _node(cp.base()), _pos(cp.slot()){};
+
+			Node* base() const { return _node; }
+			int slot() const { return _pos; }
+
+			reference operator*() const { return reference(_node->keys()[_pos], _node->values()[_pos]); }
+			pointer operator->() const { return pointer(operator*()); }
+
+			btreeIterator& operator++() {
+				if (!_node->leaf) {
+					_node = _node->children()[_pos + 1];
+					while (!_node->leaf)
+						_node = _node->children()[0];
+					_pos = 0;
+					return (*this); }
+				if (++_pos < _node->count)
+					return (*this);
+				Node*	save = _node;
+				int		savePos = _pos;
+				while (_pos == _node->count && _node->parent) {
+					_pos = _node->position;
+					_node = _node->parent; }
+				if (_pos == _node->count) { // was the last element, stay on end()
+					_node = save;
+					_pos = savePos; }
+				return (*this);
+			}
+
+			btreeIterator operator++(int) { btreeIterator tmp(*this); ++(*this); return tmp; }
+
+			btreeIterator& operator--() {
+				if (!_node->leaf) {
+					_node = _node->children()[_pos];
+					while (!_node->leaf)
+						_node = _node->children()[_node->count];
+					_pos = _node->count - 1;
+					return (*this); }
+				if (_pos > 0) {
+					--_pos;
+					return (*this); }
+				while (_pos == 0 && _node->parent) {
+					_pos = _node->position;
+					_node = _node->parent; }
+				--_pos;
+				return (*this);
+			}
+
+			btreeIterator operator--(int) { btreeIterator tmp(*this); --(*this); return tmp; }
+
+			template <class Np, class Tp>
+			bool operator==(const btreeIterator<Np, Key, Tp>& it) const { return (_node == it.base() && _pos == it.slot()); }
+			template <class Np, class Tp>
+			bool operator!=(const btreeIterator<Np, Key, Tp>& it) const { return !(*this == it); }
+	};
+
+
+	// ordered map on a B-tree; NodeBytes sets the target node size, and with it the fan-out
+	template <class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<pair<const Key, T> >, size_t NodeBytes = 256>
+	class btree_map
+	{
+
+	public:
+		typedef Key																key_type;
+		typedef T																mapped_type;
+		typedef ft::pair<const key_type, mapped_type>							value_type;
+		typedef Compare															key_compare;
+		typedef Allocator														allocator_type;
+		typedef size_t															size_type;
+		typedef ptrdiff_t														difference_type;
+
+		static const size_t		node_slots = btreeSlots<NodeBytes, sizeof(Key) + sizeof(T)>::value;
+
+	private:
+		typedef btreeNode<key_type, mapped_type, node_slots>					node;
+		typedef btreeInternal<key_type, mapped_type, node_slots>				internal;
+		typedef typename Allocator::template rebind<node>::other				allocatorLeaf;
+		typedef typename Allocator::template rebind<internal>::other			allocatorInternal;
+
+		static const int		minSlots = (node_slots - 1) / 2;
+
+	public:
+		typedef ft::btreeIterator<node, key_type, mapped_type>					iterator;
+		typedef ft::btreeIterator<const node, key_type, const mapped_type>		const_iterator;
+		typedef ft::reverse_iterator<iterator>									reverse_iterator;
+		typedef ft::reverse_iterator<const_iterator>							const_reverse_iterator;
+		typedef typename iterator::reference									reference;
+		typedef typename const_iterator::reference								const_reference;
+
+		class value_compare : public std::binary_function<value_type, value_type, bool>
+		{
+			friend class btree_map;
+		protected:
+			Compare comp;
+			value_compare(Compare c) : comp(c) {}
+
+		public:
+			bool operator() (const value_type& x, const value_type& y) const
+			{ return comp(x.first, y.first); }
+		};
+
+	private:
+		key_compare				_comp;
+		allocator_type			_alloc;
+		allocatorLeaf			_leafAlloc;
+		allocatorInternal		_internalAlloc;
+		node*					_root;
+		size_type				_size;
+
+	public:
+
+		explicit btree_map (const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type()):
+			_comp(comp), _alloc(alloc), _root(0), _size(0) {};
+
+		template <class InputIterator>
+			btree_map (InputIterator first, InputIterator last, const key_compare& comp = key_compare(),
+			const allocator_type& alloc = allocator_type()):
+			_comp(comp), _alloc(alloc), _root(0), _size(0)
+		{ insert(first, last); };
+
+		btree_map(const btree_map& x): _comp(x._comp), _alloc(x._alloc), _root(0), _size(0) {
+			if (x._root)
+				_root = cloneNode(x._root, 0);
+			_size = x._size;
+		};
+
+		btree_map &operator=(const btree_map& x) {
+			if (this != &x){
+				clear();
+				_comp = x._comp;
+				if (x._root)
+					_root = cloneNode(x._root, 0);
+				_size = x._size;
+			}
+			return *this;
+		};
+
+		~btree_map(){ clear(); };
+
+		// Iterators
+		iterator begin() { return (iterator(leftmost(), 0)); };
+		const_iterator begin() const { return (const_iterator(leftmost(), 0)); };
+		iterator end() { node* n = rightmost(); return (iterator(n, n ? n->count : 0)); };
+		const_iterator end() const { node* n = rightmost(); return (const_iterator(n, n ? n->count : 0)); };
+
+		reverse_iterator rbegin() { return reverse_iterator(end()); };
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); };
+		reverse_iterator rend() { return reverse_iterator(begin()); };
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); };
+
+		// Capacity
+		bool empty() const { return (_size ? false : true); };
+		size_type size() const { return _size; };
+		size_type max_size() const { return (allocatorLeaf().max_size() * (node_slots / 2)); };
+
+		// Element access
+		mapped_type& operator[] (const key_type& k) {
+			return ((*insert(value_type(k, mapped_type())).first).second);
+		}
+
+		mapped_type& at (const key_type& k) {
+			iterator tmp = find(k);
+
+			if (tmp == end())
+				throw std::out_of_range("");
+			return ((*tmp).second);
+		}
+
+		const mapped_type& at (const key_type& k) const {
+			const_iterator tmp = find(k);
+
+			if (tmp == end())
+				throw std::out_of_range("");
+			return ((*tmp).second);
+		}
+
+		// Modifiers
+		ft::pair<iterator, bool> insert(const value_type& v) {
+			node*	n;
+			int		i;
+
+			if (!_root)
+				_root = newNode(true);
+			n = _root;
+			while (true) {
+				i = lowerInNode(n, v.first);
+				if (i < n->count && !_comp(v.first, n->keys()[i]))
+					return (ft::make_pair(iterator(n, i), false));
+				if (n->leaf)
+					break ;
+				n = n->children()[i]; }
+			if (n->count == node_slots) {
+				node* right = splitNode(n);
+				if (i > n->count) {
+					i -= n->count + 1;
+					n = right; }
+			}
+			insertValue(n, i, v.first, v.second);
+			++_size;
+			return (ft::make_pair(iterator(n, i), true));
+		}
+
+		iterator insert (iterator position, const value_type& val) {
+			(void)position;
+			return (insert(val).first);
+		}
+
+		template <class InputIterator>
+		void insert (InputIterator first, InputIterator last) {
+			while (first != last){
+				insert(value_type(first->first, first->second));
+				++first;}
+		}
+
+		void erase (iterator position) { eraseAt(position.base(), position.slot()); }
+
+		size_type erase (const key_type& k) {
+			iterator it = find(k);
+
+			if (it == end())
+				return 0;
+			eraseAt(it.base(), it.slot());
+			return 1;
+		}
+
+		void erase (iterator first, iterator last) {
+			size_type n = 0;
+
+			if (first == begin() && last == end()) {
+				clear();
+				return ; }
+			for (iterator it = first; it != last; ++it)
+				++n;
+			for (; n > 0; --n)
+				first = eraseNext(first);
+		}
+
+		void swap (btree_map& x) {
+			std::swap(_comp, x._comp);
+			std::swap(_root, x._root);
+			std::swap(_size, x._size);
+		}
+
+		void clear() {
+			if (_root)
+				destroyNode(_root);
+			_root = 0;
+			_size = 0;
+		}
+
+		// Lookup
+		iterator find (const key_type& k) { return (iterator(findNode(k))); }
+		const_iterator find (const key_type& k) const { return (const_iterator(const_cast<btree_map*>(this)->find(k))); }
+
+		size_type count (const key_type& k) const { return (find(k) == end() ? 0 : 1); }
+
+		iterator lower_bound (const key_type& k) {
+			node*	n = _root;
+			node*	hit = 0;
+			int		hitPos = 0;
+
+			while (n) {
+				int i = lowerInNode(n, k);
+				if (i < n->count) {
+					hit = n;
+					hitPos = i;
+					if (!_comp(k, n->keys()[i]))
+						break ; }
+				n = n->leaf ? 0 : n->children()[i]; }
+			return (hit ? iterator(hit, hitPos) : end());
+		}
+
+		const_iterator lower_bound (const key_type& k) const { return (const_cast<btree_map*>(this)->lower_bound(k)); };
+
+		iterator upper_bound (const key_type& k) {
+			node*	n = _root;
+			node*	hit = 0;
+			int		hitPos = 0;
+
+			while (n) {
+				int i = upperInNode(n, k);
+				if (i < n->count) {
+					hit = n;
+					hitPos = i; }
+				n = n->leaf ? 0 : n->children()[i]; }
+			return (hit ? iterator(hit, hitPos) : end());
+		}
+
+		const_iterator upper_bound (const key_type& k) const { return (const_cast<btree_map*>(this)->upper_bound(k)); };
+
+		pair<iterator,iterator> equal_range (const key_type& k) {
+			iterator first = lower_bound(k);
+			iterator last = first;
+
+			if (first != end() && !_comp(k, (*first).first))
+				++last;
+			return (ft::make_pair(first, last));
+		}
+
+		pair<const_iterator,const_iterator> equal_range (const key_type& k) const {
+			pair<iterator,iterator> r = const_cast<btree_map*>(this)->equal_range(k);
+			return (ft::make_pair(const_iterator(r.first), const_iterator(r.second)));
+		}
+
+		allocator_type get_allocator() const { return (_alloc); };
+
+		// Observers
+		key_compare key_comp() const { return (_comp); };
+		value_compare value_comp() const { return value_compare(key_comp()); }
+
+		// Non-member functions:
+		friend bool	operator == (const btree_map& x, const btree_map& y){
+			if (x.size() != y.size())
+				return false;
+			const_iterator itx = x.begin();
+			const_iterator ity = y.begin();
+			for (; itx != x.end(); ++itx, ++ity)
+				if (!((*itx).first == (*ity).first) || !((*itx).second == (*ity).second))
+					return false;
+			return true;
+		};
+
+		friend bool	operator != (const btree_map& x, const btree_map& y){ return !(x == y); };
+
+		friend bool	operator < (const btree_map& x, const btree_map& y){
+			const_iterator itx = x.begin();
+			const_iterator ity = y.begin();
+
+			while (itx != x.end() && ity != y.end()) {
+				if ((*itx).first != (*ity).first)
+					return ((*itx).first < (*ity).first);
+				else if ((*itx).second != (*ity).second)
+					return ((*itx).second < (*ity).second);
+				++itx;
+				++ity;
+			}
+			return (x.size() < y.size());
+		};
+
+		friend bool	operator > (const btree_map& x, const btree_map& y){ return (y < x); };
+		friend bool	operator <= (const btree_map& x, const btree_map& y){ return !(y < x); };
+		friend bool	operator >= (const btree_map& x, const btree_map& y){ return !(x < y); };
+
+	private:
+		node* leftmost() const {
+			node* n = _root;
+
+			while (n && !n->leaf)
+				n = n->children()[0];
+			return (n);
+		}
+
+		node* rightmost() const {
+			node* n = _root;
+
+			while (n && !n->leaf)
+				n = n->children()[n->count];
+			return (n);
+		}
+
+		int lowerInNode(const node* n, const key_type& k) const {
+			int lo = 0;
+			int hi = n->count;
+
+			while (lo < hi) {
+				int mid = (lo + hi) / 2;
+				if (_comp(n->keys()[mid], k))
+					lo = mid + 1;
+				else
+					hi = mid; }
+			return (lo);
+		}
+
+		int upperInNode(const node* n, const key_type& k) const {
+			int lo = 0;
+			int hi = n->count;
+
+			while (lo < hi) {
+				int mid = (lo + hi) / 2;
+				if (_comp(k, n->keys()[mid]))
+					hi = mid;
+				else
+					lo = mid + 1; }
+			return (lo);
+		}
+
+		iterator findNode(const key_type& k) {
+			node* n = _root;
+
+			while (n) {
+				int i = lowerInNode(n, k);
+				if (i < n->count && !_comp(k, n->keys()[i]))
+					return (iterator(n, i));
+				n = n->leaf ? 0 : n->children()[i]; }
+			return (end());
+		}
+
+		node* newNode(bool leaf) {
+			if (leaf) {
+				node* n = _leafAlloc.allocate(1);
+				_leafAlloc.construct(n, node(true));
+				return (n); }
+			internal* n = _internalAlloc.allocate(1);
+			_internalAlloc.construct(n, internal());
+			return (n);
+		}
+
+		// frees the node itself; keys and values must already be destroyed
+		void freeNode(node* n) {
+			if (n->leaf) {
+				_leafAlloc.destroy(n);
+				_leafAlloc.deallocate(n, 1);
+				return ; }
+			internal* in = static_cast<internal*>(n);
+			_internalAlloc.destroy(in);
+			_internalAlloc.deallocate(in, 1);
+		}
+
+		void destroyNode(node* n) {
+			if (!n->leaf)
+				for (int i = 0; i <= n->count; ++i)
+					destroyNode(n->children()[i]);
+			for (int i = 0; i < n->count; ++i) {
+				n->keys()[i].~key_type();
+				n->values()[i].~mapped_type(); }
+			freeNode(n);
+		}
+
+		node* cloneNode(const node* src, node* parent) {
+			node* n = newNode(src->leaf);
+
+			for (int i = 0; i < src->count; ++i) {
+				new (n->keys() + i) key_type(src->keys()[i]);
+				new (n->values() + i) mapped_type(src->values()[i]); }
+			n->count = src->count;
+			n->parent = parent;
+			n->position = src->position;
+			if (!n->leaf)
+				for (int i = 0; i <= n->count; ++i)
+					n->children()[i] = cloneNode(src->children()[i], n);
+			return (n);
+		}
+
+		void setChild(node* p, int i, node* c) {
+			p->children()[i] = c;
+			c->parent = p;
+			c->position = i;
+		}
+
+		// shifts slots [i, count) right by one and stores (k, v) at i; children are left alone
+		void insertValue(node* n, int i, const key_type& k, const mapped_type& v) {
+			int c = n->count;
+
+			if (i == c) {
+				new (n->keys() + c) key_type(k);
+				new (n->values() + c) mapped_type(v); }
+			else {
+				new (n->keys() + c) key_type(n->keys()[c - 1]);
+				new (n->values() + c) mapped_type(n->values()[c - 1]);
+				for (int j = c - 1; j > i; --j) {
+					n->keys()[j] = n->keys()[j - 1];
+					n->values()[j] = n->values()[j - 1]; }
+				n->keys()[i] = k;
+				n->values()[i] = v; }
+			++n->count;
+		}
+
+		// removes slot i, shifting the following slots left; children are left alone
+		void eraseValue(node* n, int i) {
+			int c = --n->count;
+
+			for (int j = i; j < c; ++j) {
+				n->keys()[j] = n->keys()[j + 1];
+				n->values()[j] = n->values()[j + 1]; }
+			n->keys()[c].~key_type();
+			n->values()[c].~mapped_type();
+		}
+
+		// moves the upper half of a full node into a new right sibling and the median into the parent
+		node* splitNode(node* n) {
+			int		mid = node_slots / 2;
+			node*	right;
+
+			if (n->parent && n->parent->count == node_slots)
+				splitNode(n->parent);
+			if (!n->parent) {
+				_root = newNode(false);
+				setChild(_root, 0, n); }
+			right = newNode(n->leaf);
+			for (int j = mid + 1; j < n->count; ++j)
+				insertValue(right, right->count, n->keys()[j], n->values()[j]);
+			if (!n->leaf)
+				for (int j = mid + 1; j <= n->count; ++j)
+					setChild(right, j - mid - 1, n->children()[j]);
+			while (n->count > mid + 1)
+				eraseValue(n, n->count - 1);
+
+			node*	p = n->parent;
+			int		pos = n->position;
+			insertValue(p, pos, n->keys()[mid], n->values()[mid]);
+			for (int j = p->count; j > pos + 1; --j)
+				setChild(p, j, p->children()[j - 1]);
+			setChild(p, pos + 1, right);
+			eraseValue(n, mid);
+			return (right);
+		}
+
+		void eraseAt(node* n, int i) {
+			if (!n->leaf) { // swap in the predecessor, which always sits in a leaf
+				node* l = n->children()[i];
+				while (!l->leaf)
+					l = l->children()[l->count];
+				n->keys()[i] = l->keys()[l->count - 1];
+				n->values()[i] = l->values()[l->count - 1];
+				n = l;
+				i = l->count - 1; }
+			eraseValue(n, i);
+			--_size;
+			rebalance(n);
+		}
+
+		// erases *it and returns the element that followed it
+		iterator eraseNext(iterator it) {
+			iterator next = it;
+
+			if (++next == end()) {
+				eraseAt(it.base(), it.slot());
+				return (end()); }
+			key_type k = (*next).first;
+			eraseAt(it.base(), it.slot());
+			return (findNode(k));
+		}
+
+		void rebalance(node* n) {
+			while (n != _root && n->count < minSlots) {
+				node*	p = n->parent;
+				int		pos = n->position;
+				node*	left = pos > 0 ? p->children()[pos - 1] : 0;
+				node*	right = pos < p->count ? p->children()[pos + 1] : 0;
+
+				if (left && left->count > minSlots) {
+					rotateRight(p, pos - 1);
+					return ; }
+				if (right && right->count > minSlots) {
+					rotateLeft(p, pos);
+					return ; }
+				mergeChildren(p, left ? pos - 1 : pos);
+				n = p; }
+			if (_root->count == 0) {
+				node* old = _root;
+				_root = old->leaf ? 0 : old->children()[0];
+				if (_root)
+					_root->parent = 0;
+				freeNode(old); }
+		}
+
+		// moves the separator p[i] down into the right child and the left child's last entry up
+		void rotateRight(node* p, int i) {
+			node* l = p->children()[i];
+			node* r = p->children()[i + 1];
+
+			insertValue(r, 0, p->keys()[i], p->values()[i]);
+			if (!r->leaf) {
+				for (int j = r->count; j > 0; --j)
+					setChild(r, j, r->children()[j - 1]);
+				setChild(r, 0, l->children()[l->count]); }
+			p->keys()[i] = l->keys()[l->count - 1];
+			p->values()[i] = l->values()[l->count - 1];
+			eraseValue(l, l->count - 1);
+		}
+
+		void rotateLeft(node* p, int i) {
+			node* l = p->children()[i];
+			node* r = p->children()[i + 1];
+
+			insertValue(l, l->count, p->keys()[i], p->values()[i]);
+			if (!l->leaf) {
+				setChild(l, l->count, r->children()[0]);
+				for (int j = 0; j < r->count; ++j)
+					setChild(r, j, r->children()[j + 1]); }
+			p->keys()[i] = r->keys()[0];
+			p->values()[i] = r->values()[0];
+			eraseValue(r, 0);
+		}
+
+		// folds child i + 1 and the separator p[i] into child i
+		void mergeChildren(node* p, int i) {
+			node*	l = p->children()[i];
+			node*	r = p->children()[i + 1];
+			int		base;
+
+			insertValue(l, l->count, p->keys()[i], p->values()[i]);
+			base = l->count;
+			for (int j = 0; j < r->count; ++j)
+				insertValue(l, l->count, r->keys()[j], r->values()[j]);
+			if (!l->leaf)
+				for (int j = 0; j <= r->count; ++j)
+					setChild(l, base + j, r->children()[j]);
+			eraseValue(p, i);
+			for (int j = i + 1; j <= p->count; ++j)
+				setChild(p, j, p->children()[j + 1]);
+			while (r->count > 0)
+				eraseValue(r, r->count - 1);
+			freeNode(r);
+		}
+
+	};
+
+}
+
+#endif
@@ -0,0 +1,406 @@
+#ifndef CONCURRENT_MAP_HPP
+#define CONCURRENT_MAP_HPP
+
+#include <memory>
+#include <new>
+#include <functional>
+#include <utility>
+#include <stdexcept>
+#include <pthread.h>
+#include "utils.hpp"
+#include "vector.hpp"
+#include "tree.hpp"
+
+namespace ft
+{
+	// Ordered map for concurrent use: keys are spread by hash over independent red-black
+	// trees (shards), each behind its own reader-writer lock. Single-key operations lock one
+	// shard, the batch operations lock every shard they touch once, and ordered traversal
+	// read-locks all shards and merges them.
+	// Nothing hands out references or iterators into the shards: lookups copy the mapped
+	// value out and in-place changes go through update().
+	template <class Key, class T, class Compare = std::less<Key>, class Hash = ft::hash<Key>,
+		class Allocator = std::allocator<pair<const Key, T> > >
+	class concurrent_map
+	{
+
+	public:
+		typedef Key																key_type;
+		typedef T																mapped_type;
+		typedef ft::pair<const key_type, mapped_type>							value_type;
+		typedef Compare															key_compare;
+		typedef Hash															hasher;
+		typedef Allocator														allocator_type;
+		typedef size_t															size_type;
+
+	private:
+		typedef ft::node<value_type>											node_type;
+		typedef typename Allocator::template rebind<node_type>::other			allocatorNode;
+		typedef ft::tree<value_type, allocatorNode, key_compare>				tree_type;
+		typedef ft::pair<key_type, mapped_type>									entry;
+
+		// one lock and one tree, padded so that two shards never share a cache line
+		struct shard
+		{
+			pthread_rwlock_t	lock;
+			tree_type			tree;
+			char				pad[64];
+
+			shard(const key_compare& comp): tree(comp) {
+				if (pthread_rwlock_init(&lock, NULL) != 0)
+					throw std::runtime_error("concurrent_map: pthread_rwlock_init"); }
+			~shard() { pthread_rwlock_destroy(&lock); }
+		};
+
+		typedef typename Allocator::template rebind<shard>::other				allocatorShard;
+
+		struct readGuard
+		{
+			pthread_rwlock_t* l;
+			readGuard(pthread_rwlock_t* lock): l(lock) { pthread_rwlock_rdlock(l); }
+			~readGuard() { pthread_rwlock_unlock(l); }
+		};
+
+		struct writeGuard
+		{
+			pthread_rwlock_t* l;
+			writeGuard(pthread_rwlock_t* lock): l(lock) { pthread_rwlock_wrlock(l); }
+			~writeGuard() { pthread_rwlock_unlock(l); }
+		};
+
+		// read-locks every shard in index order (the only multi-shard lock order used)
+		struct readAllGuard
+		{
+			shard*	s;
+			size_t	n;
+			readAllGuard(shard* shards, size_t count): s(shards), n(count) {
+				for (size_t i = 0; i < n; ++i)
+					pthread_rwlock_rdlock(&s[i].lock); }
+			~readAllGuard() {
+				for (size_t i = n; i > 0; --i)
+					pthread_rwlock_unlock(&s[i - 1].lock); }
+		};
+
+		key_compare			_comp;
+		hasher				_hash;
+		allocatorShard		_alloc;
+		shard*				_shards;
+		size_t				_count;		// power of two
+		size_t				_shift;		// shard index = top bits of the hash
+
+		concurrent_map(const concurrent_map&);
+		concurrent_map& operator=(const concurrent_map&);
+
+	public:
+
+		// shards is rounded up to a power of two; a few per core keeps writers apart
+		explicit concurrent_map(size_type shards = 16, const key_compare& comp = key_compare(),
+			const hasher& hash = hasher(), const allocator_type& alloc = allocator_type()):
+			_comp(comp), _hash(hash), _alloc(alloc), _shards(0), _count(1), _shift(sizeof(size_t) * 8)
+		{
+			size_t i = 0;
+
+			while (_count < shards){
+				_count <<= 1;
+				--_shift;}
+			_shards = _alloc.allocate(_count);
+			try {
+				for (; i < _count; ++i)
+					new (&_shards[i]) shard(_comp);
+			}
+			catch (...) {
+				while (i > 0)
+					_shards[--i].~shard();
+				_alloc.deallocate(_shards, _count);
+				throw ;
+			}
+		}
+
+		~concurrent_map() {
+			for (size_t i = 0; i < _count; ++i)
+				_shards[i].~shard();
+			_alloc.deallocate(_shards, _count);
+		}
+
+		// Capacity (a moment's view: other threads may change it right after)
+		size_type size() const {
+			size_type n = 0;
+
+			for (size_t i = 0; i < _count; ++i){
+				readGuard g(&_shards[i].lock);
+				n += _shards[i].tree.size();}
+			return (n);
+		}
+
+		bool empty() const { return (size() == 0); }
+
+		size_type shard_count() const { return (_count); }
+
+		// Single-key operations, each locks one shard
+
+		// false when k is already present (its value is left alone)
+		bool insert(const value_type& v) {
+			shard&		s = shardOf(v.first);
+			writeGuard	g(&s.lock);
+
+			return (s.tree.insertNode(v).second);
+		}
+
+		// true when k was inserted, false when an existing value was overwritten
+		bool insert_or_assign(const key_type& k, const mapped_type& v) {
+			shard&		s = shardOf(k);
+			writeGuard	g(&s.lock);
+			ft::pair<node_type*, bool> res = s.tree.insertNode(value_type(k, v));
+
+			if (!res.second)
+				res.first->value().second = v;
+			return (res.second);
+		}
+
+		// copies the mapped value of k into value
+		bool find(const key_type& k, mapped_type& value) const {
+			shard&		s = shardOf(k);
+			readGuard	g(&s.lock);
+			node_type*	x = s.tree.treeSearch(k);
+
+			if (x == s.tree.end())
+				return (false);
+			value = x->value().second;
+			return (true);
+		}
+
+		size_type count(const key_type& k) const {
+			shard&		s = shardOf(k);
+			readGuard	g(&s.lock);
+
+			return (s.tree.treeSearch(k) == s.tree.end() ? 0 : 1);
+		}
+
+		// calls f(mapped_type&) under the shard's write lock; false when k is absent
+		template <class Function>
+		bool update(const key_type& k, Function f) {
+			shard&		s = shardOf(k);
+			writeGuard	g(&s.lock);
+			node_type*	x = s.tree.treeSearch(k);
+
+			if (x == s.tree.end())
+				return (false);
+			f(x->value().second);
+			return (true);
+		}
+
+		size_type erase(const key_type& k) {
+			shard&		s = shardOf(k);
+			writeGuard	g(&s.lock);
+			node_type*	x = s.tree.treeSearch(k);
+
+			if (x == s.tree.end())
+				return (0);
+			s.tree.rbTreeDelete(x);
+			return (1);
+		}
+
+		void clear() {
+			for (size_t i = 0; i < _count; ++i){
+				writeGuard g(&_shards[i].lock);
+				_shards[i].tree.clear();}
+		}
+
+		// Batch operations: the input is bucketed by shard first, then each shard is locked
+		// once for all of its keys. The batch is not atomic as a whole, only per shard.
+
+		// returns the number of inserted elements; equal keys in the batch keep the first one
+		template <class InputIterator>
+		size_type insert_batch(InputIterator first, InputIterator last) {
+			ft::vector<entry>		items;
+			ft::vector<size_t>		order;
+			ft::vector<size_t>		start;
+			size_type				n = 0;
+
+			for (; first != last; ++first)
+				items.push_back(entry(first->first, first->second));
+			bucket(items, start, order);
+			for (size_t i = 0; i < _count; ++i){
+				if (start[i] == start[i + 1])
+					continue ;
+				writeGuard g(&_shards[i].lock);
+				for (size_t j = start[i]; j < start[i + 1]; ++j)
+					n += _shards[i].tree.insertNode(value_type(items[order[j]].first, items[order[j]].second)).second;
+			}
+			return (n);
+		}
+
+		// returns the number of erased keys
+		template <class KeyIterator>
+		size_type erase_batch(KeyIterator first, KeyIterator last) {
+			ft::vector<key_type>	keys;
+			ft::vector<size_t>		order;
+			ft::vector<size_t>		start;
+			size_type				n = 0;
+
+			for (; first != last; ++first)
+				keys.push_back(*first);
+			bucket(keys, start, order);
+			for (size_t i = 0; i < _count; ++i){
+				if (start[i] == start[i + 1])
+					continue ;
+				writeGuard g(&_shards[i].lock);
+				for (size_t j = start[i]; j < start[i + 1]; ++j){
+					node_type* x = _shards[i].tree.treeSearch(keys[order[j]]);
+					if (x != _shards[i].tree.end()){
+						_shards[i].tree.rbTreeDelete(x);
+						++n;}
+				}
+			}
+			return (n);
+		}
+
+		// writes one ft::pair<bool, mapped_type> per key to out, in input order
+		// ((false, mapped_type()) for a missing key); returns the number of keys found
+		template <class KeyIterator, class OutputIterator>
+		size_type find_batch(KeyIterator first, KeyIterator last, OutputIterator out) const {
+			ft::vector<key_type>							keys;
+			ft::vector<ft::pair<bool, mapped_type> >		res;
+			ft::vector<size_t>								order;
+			ft::vector<size_t>								start;
+			size_type										n = 0;
+
+			for (; first != last; ++first)
+				keys.push_back(*first);
+			res.resize(keys.size());
+			bucket(keys, start, order);
+			for (size_t i = 0; i < _count; ++i){
+				if (start[i] == start[i + 1])
+					continue ;
+				readGuard g(&_shards[i].lock);
+				for (size_t j = start[i]; j < start[i + 1]; ++j){
+					node_type* x = _shards[i].tree.treeSearch(keys[order[j]]);
+					if (x != _shards[i].tree.end()){
+						res[order[j]].first = true;
+						res[order[j]].second = x->value().second;
+						++n;}
+				}
+			}
+			for (size_t j = 0; j < res.size(); ++j)
+				*out++ = res[j];
+			return (n);
+		}
+
+		// Ordered traversal: all shards are read-locked for the whole walk and merged with a
+		// heap of one cursor per shard, so f sees a consistent snapshot in key order.
+		// f must not call back into this map.
+		template <class Function>
+		void for_each(Function f) const {
+			readAllGuard	g(_shards, _count);
+			cursorHeap		heap(_comp);
+
+			for (size_t i = 0; i < _count; ++i)
+				heap.push(&_shards[i].tree, _shards[i].tree.begin());
+			walk(heap, 0, f);
+		}
+
+		// same over the keys in [lo, hi)
+		template <class Function>
+		void for_each(const key_type& lo, const key_type& hi, Function f) const {
+			readAllGuard	g(_shards, _count);
+			cursorHeap		heap(_comp);
+
+			for (size_t i = 0; i < _count; ++i)
+				heap.push(&_shards[i].tree, _shards[i].tree.lower_bound(lo));
+			walk(heap, &hi, f);
+		}
+
+		// Observers
+		key_compare key_comp() const { return (_comp); }
+		hasher hash_function() const { return (_hash); }
+
+	private:
+		// the shift would be the full word width for a single shard
+		size_t shardIndex(const key_type& k) const { return (_count == 1 ? 0 : _hash(k) >> _shift); }
+
+		shard& shardOf(const key_type& k) const { return (_shards[shardIndex(k)]); }
+		size_t shardIndex(const entry& e) const { return (shardIndex(e.first)); }
+
+		// counting sort of the batch by shard: order[start[i] .. start[i + 1]) are the
+		// positions of the items that belong to shard i, in input order
+		template <class Items>
+		void bucket(const Items& items, ft::vector<size_t>& start, ft::vector<size_t>& order) const {
+			ft::vector<size_t> idx(items.size());
+
+			start.assign(_count + 1, 0);
+			for (size_t j = 0; j < items.size(); ++j){
+				idx[j] = shardIndex(items[j]);
+				++start[idx[j] + 1];}
+			for (size_t i = 0; i < _count; ++i)
+				start[i + 1] += start[i];
+			order.resize(items.size());
+			ft::vector<size_t> fill(start.begin(), start.end() - 1);
+			for (size_t j = 0; j < items.size(); ++j)
+				order[fill[idx[j]]++] = j;
+		}
+
+		// min-heap of shard cursors ordered by their current key
+		struct cursor
+		{
+			const tree_type*	tree;
+			node_type*			x;
+		};
+
+		struct cursorHeap
+		{
+			ft::vector<cursor>	c;
+			key_compare			comp;
+
+			cursorHeap(const key_compare& cmp): comp(cmp) {}
+
+			bool less(size_t a, size_t b) const { return (comp(c[a].x->key(), c[b].x->key())); }
+
+			void push(const tree_type* t, node_type* x) {
+				cursor	cur;
+				size_t	i;
+
+				if (x == t->end())
+					return ;
+				cur.tree = t;
+				cur.x = x;
+				c.push_back(cur);
+				for (i = c.size() - 1; i > 0 && less(i, (i - 1) / 2); i = (i - 1) / 2)
+					std::swap(c[i], c[(i - 1) / 2]);
+			}
+
+			// advances the top cursor, dropping it when its shard is exhausted
+			void next() {
+				size_t i = 0;
+				size_t m;
+
+				c[0].x = c[0].tree->successor(c[0].x);
+				if (c[0].x == c[0].tree->end()){
+					c[0] = c.back();
+					c.pop_back();}
+				while ((m = 2 * i + 1) < c.size()){
+					if (m + 1 < c.size() && less(m + 1, m))
+						++m;
+					if (!less(m, i))
+						break ;
+					std::swap(c[i], c[m]);
+					i = m;
+				}
+			}
+		};
+
+		template <class Function>
+		void walk(cursorHeap& heap, const key_type* hi, Function& f) const {
+			while (!heap.c.empty()){
+				const value_type& v = heap.c[0].x->value();
+				if (hi && !_comp(v.first, *hi))
+					break ;
+				f(v);
+				heap.next();
+			}
+		}
+
+	};
+
+}
+
+#endif
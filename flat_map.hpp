@@ -0,0 +1,351 @@
+#ifndef FLAT_MAP_HPP
+#define FLAT_MAP_HPP
+
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+#include "utils.hpp"
+#include "iterator.hpp"
+#include "vector.hpp"
+
+namespace ft
+{
+	// sorted-array map: keys and mapped values live in two parallel vectors,
+	// so a lookup only walks the key array
+	template <class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<pair<const Key, T> > >
+	class flat_map
+	{
+
+	public:
+		typedef Key																key_type;
+		typedef T																mapped_type;
+		typedef ft::pair<const key_type, mapped_type>							value_type;
+		typedef Compare															key_compare;
+		typedef Allocator														allocator_type;
+		typedef size_t															size_type;
+		typedef ptrdiff_t														difference_type;
+
+		typedef ft::flatMapIterator<key_type, mapped_type>						iterator;
+		typedef ft::flatMapIterator<key_type, const mapped_type>				const_iterator;
+		typedef ft::reverse_iterator<iterator>									reverse_iterator;
+		typedef ft::reverse_iterator<const_iterator>							const_reverse_iterator;
+		typedef typename iterator::reference									reference;
+		typedef typename const_iterator::reference								const_reference;
+
+		class value_compare : public std::binary_function<value_type, value_type, bool>
+		{
+			friend class flat_map;
+		protected:
+			Compare comp;
+			value_compare(Compare c) : comp(c) {}
+
+		public:
+			bool operator() (const value_type& x, const value_type& y) const
+			{ return comp(x.first, y.first); }
+		};
+
+	private:
+		typedef typename Allocator::template rebind<key_type>::other			allocatorKey;
+		typedef typename Allocator::template rebind<mapped_type>::other			allocatorMapped;
+		typedef ft::pair<key_type, mapped_type>									entry;
+
+		// orders a bulk-insert buffer by key only, so stable_sort keeps the first duplicate in front
+		struct entryCompare
+		{
+			Compare comp;
+			entryCompare(Compare c) : comp(c) {}
+			bool operator() (const entry& x, const entry& y) const { return comp(x.first, y.first); }
+		};
+
+		key_compare								_comp;
+		allocator_type							_alloc;
+		ft::vector<key_type, allocatorKey>		_keys;
+		ft::vector<mapped_type, allocatorMapped>	_values;
+
+	public:
+
+		explicit flat_map (const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type()):
+			_comp(comp), _alloc(alloc) {};
+
+		template <class InputIterator>
+			flat_map (InputIterator first, InputIterator last, const key_compare& comp = key_compare(),
+			const allocator_type& alloc = allocator_type()):
+			_comp(comp), _alloc(alloc)
+		{ insert(first, last); };
+
+		flat_map(const flat_map& x): _comp(x._comp), _alloc(x._alloc), _keys(x._keys), _values(x._values) {};
+
+		flat_map &operator=(const flat_map& x) {
+			if (this != &x){
+				_comp = x._comp;
+				_keys = x._keys;
+				_values = x._values;
+			}
+			return *this;
+		};
+
+		~flat_map(){ };
+
+		// Iterators
+		iterator begin() { return iterator(_keys.data(), _values.data()); };
+		const_iterator begin() const { return const_iterator(_keys.data(), _values.data()); };
+		iterator end() { return begin() + size(); };
+		const_iterator end() const { return begin() + size(); };
+
+		reverse_iterator rbegin() { return reverse_iterator(end()); };
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); };
+		reverse_iterator rend() { return reverse_iterator(begin()); };
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); };
+
+		// Capacity
+		bool empty() const { return (_keys.size() ? false : true); };
+		size_type size() const { return _keys.size(); };
+		size_type max_size() const { return (allocatorMapped().max_size()); };
+		size_type capacity() const { return _keys.capacity(); };
+		void reserve(size_type n) { _keys.reserve(n); _values.reserve(n); };
+
+		// Element access
+		mapped_type& operator[] (const key_type& k) {
+			size_type i = lowerIndex(k);
+
+			if (i == size() || _comp(k, _keys[i]))
+				insertAt(i, k, mapped_type());
+			return (_values[i]);
+		}
+
+		mapped_type& at (const key_type& k) {
+			size_type i = findIndex(k);
+
+			if (i == size())
+				throw std::out_of_range("");
+			return (_values[i]);
+		}
+
+		const mapped_type& at (const key_type& k) const {
+			size_type i = findIndex(k);
+
+			if (i == size())
+				throw std::out_of_range("");
+			return (_values[i]);
+		}
+
+		// Modifiers
+		ft::pair<iterator, bool> insert(const value_type& v) {
+			size_type i = lowerIndex(v.first);
+
+			if (i < size() && !_comp(v.first, _keys[i]))
+				return (ft::make_pair(begin() + i, false));
+			insertAt(i, v.first, v.second);
+			return (ft::make_pair(begin() + i, true));
+		}
+
+		iterator insert (iterator position, const value_type& val) {
+			(void)position;
+			return (insert(val).first);
+		}
+
+		// sorts and deduplicates the range (first occurrence wins), then merges it in one pass
+		template <class InputIterator>
+		void insert (InputIterator first, InputIterator last) {
+			ft::vector<entry> run;
+
+			for (; first != last; ++first)
+				run.push_back(entry(first->first, first->second));
+			if (run.empty())
+				return ;
+			std::stable_sort(run.data(), run.data() + run.size(), entryCompare(_comp));
+			mergeRun(run.data(), run.data() + run.size());
+		}
+
+		// [first, last) must already be sorted by key; equal keys keep the first one
+		template <class InputIterator>
+		void insert_sorted (InputIterator first, InputIterator last) { mergeRun(first, last); }
+
+		void erase (iterator position) { eraseAt(position - begin(), 1); }
+
+		size_type erase (const key_type& k) {
+			size_type i = findIndex(k);
+
+			if (i == size())
+				return 0;
+			eraseAt(i, 1);
+			return 1;
+		}
+
+		void erase (iterator first, iterator last) { eraseAt(first - begin(), last - first); }
+
+		void swap (flat_map& x) {
+			std::swap(_comp, x._comp);
+			_keys.swap(x._keys);
+			_values.swap(x._values);
+		}
+
+		void clear() { _keys.clear(); _values.clear(); }
+
+		// Lookup
+		iterator find (const key_type& k) { return (begin() + findIndex(k)); }
+		const_iterator find (const key_type& k) const { return (begin() + findIndex(k)); }
+
+		size_type count (const key_type& k) const { return (findIndex(k) == size() ? 0 : 1); }
+
+		iterator lower_bound (const key_type& k) { return (begin() + lowerIndex(k)); };
+		const_iterator lower_bound (const key_type& k) const { return (begin() + lowerIndex(k)); };
+		iterator upper_bound (const key_type& k) { return (begin() + upperIndex(k)); };
+		const_iterator upper_bound (const key_type& k) const { return (begin() + upperIndex(k)); };
+
+		pair<iterator,iterator> equal_range (const key_type& k) {
+			size_type i = lowerIndex(k);
+			size_type j = (i < size() && !_comp(k, _keys[i])) ? i + 1 : i;
+			return (ft::make_pair(begin() + i, begin() + j));
+		}
+
+		pair<const_iterator,const_iterator> equal_range (const key_type& k) const {
+			size_type i = lowerIndex(k);
+			size_type j = (i < size() && !_comp(k, _keys[i])) ? i + 1 : i;
+			return (ft::make_pair(begin() + i, begin() + j));
+		}
+
+		allocator_type get_allocator() const { return (_alloc); };
+
+		// Observers
+		key_compare key_comp() const { return (_comp); };
+		value_compare value_comp() const { return value_compare(key_comp()); }
+
+		// Non-member functions:
+		friend bool	operator == (const flat_map& x, const flat_map& y){
+			if (x.size() != y.size())
+				return false;
+			for (size_type i = 0; i < x.size(); ++i)
+				if (!(x._keys[i] == y._keys[i]) || !(x._values[i] == y._values[i]))
+					return false;
+			return true;
+		};
+
+		friend bool	operator != (const flat_map& x, const flat_map& y){ return !(x == y); };
+
+		friend bool	operator < (const flat_map& x, const flat_map& y){
+			size_type n = x.size() < y.size() ? x.size() : y.size();
+
+			for (size_type i = 0; i < n; ++i) {
+				if (x._keys[i] != y._keys[i])
+					return (x._keys[i] < y._keys[i]);
+				else if (x._values[i] != y._values[i])
+					return (x._values[i] < y._values[i]);
+			}
+			return (x.size() < y.size());
+		};
+
+		friend bool	operator > (const flat_map& x, const flat_map& y){ return (y < x); };
+		friend bool	operator <= (const flat_map& x, const flat_map& y){ return !(y < x); };
+		friend bool	operator >= (const flat_map& x, const flat_map& y){ return !(x < y); };
+
+	private:
+		// branchless binary search: the loop only narrows [base, base + len),
+		// the comparison result selects the step instead of a branch
+		size_type lowerIndex(const key_type& k) const {
+			size_type len = _keys.size();
+			const key_type* base = _keys.data();
+
+			if (len == 0)
+				return 0;
+			while (len > 1) {
+				size_type half = len / 2;
+				prefetch(base + half / 2 - 1);
+				prefetch(base + half + half / 2 - 1);
+				base += _comp(base[half - 1], k) ? half : 0;
+				len -= half;
+			}
+			base += _comp(*base, k);
+			return (base - _keys.data());
+		}
+
+		size_type upperIndex(const key_type& k) const {
+			size_type len = _keys.size();
+			const key_type* base = _keys.data();
+
+			if (len == 0)
+				return 0;
+			while (len > 1) {
+				size_type half = len / 2;
+				prefetch(base + half / 2 - 1);
+				prefetch(base + half + half / 2 - 1);
+				base += _comp(k, base[half - 1]) ? 0 : half;
+				len -= half;
+			}
+			base += !_comp(k, *base);
+			return (base - _keys.data());
+		}
+
+		// both possible next probes, so the next level is already on its way
+		static void prefetch(const key_type* p) {
+		#ifdef __GNUC__
+			__builtin_prefetch(p);
+		#else
+			(void)p;
+		#endif
+		}
+
+		// index of k, or size() when absent
+		size_type findIndex(const key_type& k) const {
+			size_type i = lowerIndex(k);
+
+			if (i < size() && !_comp(k, _keys[i]))
+				return i;
+			return size();
+		}
+
+		void insertAt(size_type i, const key_type& k, const mapped_type& v) {
+			_keys.push_back(k);
+			_values.push_back(v);
+			for (size_type j = size() - 1; j > i; --j) {
+				_keys[j] = _keys[j - 1];
+				_values[j] = _values[j - 1]; }
+			_keys[i] = k;
+			_values[i] = v;
+		}
+
+		void eraseAt(size_type i, size_type n) {
+			if (n == 0)
+				return ;
+			for (size_type j = i + n; j < size(); ++j) {
+				_keys[j - n] = _keys[j];
+				_values[j - n] = _values[j]; }
+			for (; n > 0; --n) {
+				_keys.pop_back();
+				_values.pop_back(); }
+		}
+
+		// one-pass merge of the current contents with a key-sorted run; existing keys win
+		template <class InputIterator>
+		void mergeRun(InputIterator first, InputIterator last) {
+			ft::vector<key_type, allocatorKey>			keys;
+			ft::vector<mapped_type, allocatorMapped>	values;
+			size_type									i = 0;
+
+			keys.reserve(size());
+			values.reserve(size());
+			while (first != last) {
+				if (i < size() && !_comp(first->first, _keys[i])) {
+					if (!_comp(_keys[i], first->first))
+						++first;
+					keys.push_back(_keys[i]);
+					values.push_back(_values[i++]);
+					continue; }
+				if (keys.empty() || _comp(keys.back(), first->first)) {
+					keys.push_back(first->first);
+					values.push_back(first->second); }
+				++first;
+			}
+			for (; i < size(); ++i) {
+				keys.push_back(_keys[i]);
+				values.push_back(_values[i]); }
+			_keys.swap(keys);
+			_values.swap(values);
+		}
+
+	};
+
+}
+
+#endif
@@ -0,0 +1,303 @@
+#ifndef FROZEN_MAP_HPP
+#define FROZEN_MAP_HPP
+
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include "utils.hpp"
+#include "iterator.hpp"
+#include "vector.hpp"
+
+namespace ft
+{
+	// Eytzinger order: position 1 is the root, the children of k are 2k and 2k + 1, so a
+	// search walks down the array with no pointers. These step through it in key order.
+	inline size_t eytzingerFirst(size_t n) {
+		size_t k = 1;
+
+		while (2 * k <= n)
+			k = 2 * k;
+		return (n ? k : 0);
+	}
+
+	inline size_t eytzingerLast(size_t n) {
+		size_t k = 1;
+
+		while (2 * k + 1 <= n)
+			k = 2 * k + 1;
+		return (n ? k : 0);
+	}
+
+	// successor of k, 0 past the last position
+	inline size_t eytzingerNext(size_t k, size_t n) {
+		if (2 * k + 1 <= n){
+			k = 2 * k + 1;
+			while (2 * k <= n)
+				k = 2 * k;
+			return (k);}
+		while (k & 1) // up while k is a right child, then once more
+			k >>= 1;
+		return (k >> 1);
+	}
+
+	// predecessor of k, the last position for k == 0
+	inline size_t eytzingerPrev(size_t k, size_t n) {
+		if (k == 0)
+			return (eytzingerLast(n));
+		if (2 * k <= n){
+			k = 2 * k;
+			while (2 * k + 1 <= n)
+				k = 2 * k + 1;
+			return (k);}
+		while (k && !(k & 1))
+			k >>= 1;
+		return (k >> 1);
+	}
+
+	template <class Key, class T>
+	class frozenMapIterator
+	{
+		public:
+			typedef ft::pair<const Key, T>					value_type;
+			typedef pairRef<Key, const T>					reference;
+			typedef pairRefArrow<Key, const T>				pointer;
+			typedef bidirectional_iterator_tag				iterator_category;
+			typedef ptrdiff_t								difference_type;
+
+		private:
+			const Key*		_keys;
+			const T*		_values;
+			size_t			_k;		// Eytzinger position, 0 is end()
+			size_t			_n;
+
+		public:
+			frozenMapIterator(const Key* keys = 0, const T* values = 0, size_t k = 0, size_t n = 0):
+				_keys(keys), _values(values), _k(k), _n(n){};
+
+			size_t position() const { return _k; }
+
+			reference operator*() const { return reference(_keys[_k], _values[_k - 1]); }
+			pointer operator->() const { return pointer(operator*()); }
+
+			frozenMapIterator& operator++() { _k = eytzingerNext(_k, _n); return (*this); }
+			frozenMapIterator operator++(int) { frozenMapIterator tmp(*this); ++(*this); return tmp; }
+			frozenMapIterator& operator--() { _k = eytzingerPrev(_k, _n); return (*this); }
+			frozenMapIterator operator--(int) { frozenMapIterator tmp(*this); --(*this); return tmp; }
+
+			bool operator==(const frozenMapIterator& it) const { return (_k == it._k); }
+			bool operator!=(const frozenMapIterator& it) const { return !(*this == it); }
+	};
+
+
+	// Immutable sorted map in Eytzinger layout (map::freeze): keys in one array in BFS order
+	// of the implicit search tree, mapped values in a parallel array, nothing else per entry.
+	// Searches are branchless and prefetch the block of descendants four levels down (for
+	// 4-byte keys; a cache line's worth in general), which is where the search will be by then.
+	// The key array starts at an offset into its buffer that puts position 0 on a cache line
+	// boundary, so each such block is one line when sizeof(Key) divides 64.
+	// Key and T must be default constructible.
+	template <class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<pair<const Key, T> > >
+	class frozen_map
+	{
+
+	public:
+		typedef Key																key_type;
+		typedef T																mapped_type;
+		typedef ft::pair<const key_type, mapped_type>							value_type;
+		typedef Compare															key_compare;
+		typedef Allocator														allocator_type;
+		typedef size_t															size_type;
+		typedef ptrdiff_t														difference_type;
+
+		typedef ft::frozenMapIterator<key_type, mapped_type>					const_iterator;
+		typedef const_iterator													iterator;
+		typedef ft::reverse_iterator<const_iterator>							const_reverse_iterator;
+		typedef const_reverse_iterator											reverse_iterator;
+		typedef typename const_iterator::reference								const_reference;
+		typedef const_reference													reference;
+
+	private:
+		typedef typename Allocator::template rebind<key_type>::other			allocatorKey;
+		typedef typename Allocator::template rebind<mapped_type>::other			allocatorMapped;
+
+		static const size_t		stride = sizeof(Key) < 64 ? 64 / sizeof(Key) : 1;
+
+		key_compare									_comp;
+		ft::vector<key_type, allocatorKey>			_keys;		// stride slots of slack for the alignment
+		ft::vector<mapped_type, allocatorMapped>	_values;	// _values[k - 1] belongs to keys()[k]
+		size_t										_origin;	// keys()[k] is _keys[_origin + k], keys()[0] is unused
+
+	public:
+		explicit frozen_map (const key_compare& comp = key_compare()): _comp(comp), _origin(0) {};
+
+		// the buffer of the copy may sit differently against the cache lines, so the keys move
+		frozen_map (const frozen_map& x): _comp(x._comp), _keys(x._keys), _values(x._values), _origin(x._origin) { realign(); };
+
+		frozen_map& operator= (const frozen_map& x) {
+			frozen_map tmp(x);
+
+			swap(tmp);
+			return (*this);
+		}
+
+		// [first, last) is a forward range sorted by key with no duplicates
+		template <class ForwardIterator>
+		frozen_map (ForwardIterator first, ForwardIterator last, const key_compare& comp = key_compare()): _comp(comp), _origin(0)
+		{
+			size_t		n = 0;
+			size_t		k;
+			key_type*	keys;
+
+			for (ForwardIterator it = first; it != last; ++it)
+				++n;
+			if (n == 0)
+				return ;
+			_keys.resize(n + 1 + stride);
+			_values.resize(n);
+			_origin = alignedOrigin();
+			keys = _keys.data() + _origin;
+			for (k = eytzingerFirst(n); first != last; ++first, k = eytzingerNext(k, n)){
+				keys[k] = first->first;
+				_values[k - 1] = first->second;}
+		};
+
+		// Iterators
+		const_iterator begin() const { return const_iterator(keys(), _values.data(), eytzingerFirst(size()), size()); };
+		const_iterator end() const { return const_iterator(keys(), _values.data(), 0, size()); };
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); };
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); };
+
+		// Capacity
+		bool empty() const { return (_values.empty()); };
+		size_type size() const { return (_values.size()); };
+		size_type max_size() const { return (allocatorMapped().max_size()); };
+
+		// Element access
+		const mapped_type& at (const key_type& k) const {
+			size_t i = findIndex(k);
+
+			if (i == 0)
+				throw std::out_of_range("");
+			return (_values[i - 1]);
+		}
+
+		void swap (frozen_map& x) {
+			std::swap(_comp, x._comp);
+			_keys.swap(x._keys);
+			_values.swap(x._values);
+			std::swap(_origin, x._origin);
+		}
+
+		// Lookup
+		const_iterator find (const key_type& k) const { return (iter(findIndex(k))); }
+		size_type count (const key_type& k) const { return (findIndex(k) ? 1 : 0); }
+		const_iterator lower_bound (const key_type& k) const { return (iter(lowerIndex(k))); };
+		const_iterator upper_bound (const key_type& k) const { return (iter(upperIndex(k))); };
+
+		pair<const_iterator, const_iterator> equal_range (const key_type& k) const {
+			size_t i = lowerIndex(k);
+			size_t j = (i && !_comp(k, keys()[i])) ? eytzingerNext(i, size()) : i;
+			return (ft::make_pair(iter(i), iter(j)));
+		}
+
+		allocator_type get_allocator() const { return (allocator_type()); };
+
+		// Observers
+		key_compare key_comp() const { return (_comp); };
+
+		// Non-member functions:
+		friend bool	operator == (const frozen_map& x, const frozen_map& y){
+			return (x.size() == y.size() && ft::equal(x._values.data(), x._values.data() + x.size(), y._values.data())
+				&& (x.empty() || ft::equal(x.keys() + 1, x.keys() + x.size() + 1, y.keys() + 1)));
+		};
+
+		friend bool	operator != (const frozen_map& x, const frozen_map& y){ return !(x == y); };
+
+	private:
+		const_iterator iter(size_t k) const { return const_iterator(keys(), _values.data(), k, size()); }
+
+		const key_type* keys() const { return (_keys.data() + _origin); }
+
+		// the slot of _keys that lands on a cache line boundary, 0 when none can
+		size_t alignedOrigin() const {
+			size_t off = (64 - reinterpret_cast<uintptr_t>(_keys.data()) % 64) % 64;
+
+			return (off % sizeof(key_type) == 0 && off / sizeof(key_type) < stride ? off / sizeof(key_type) : 0);
+		}
+
+		void realign() {
+			size_t		o = alignedOrigin();
+			key_type*	from = _keys.data() + _origin;
+			key_type*	to = _keys.data() + o;
+
+			if (empty())
+				return ;
+			if (o < _origin)
+				std::copy(from, from + size() + 1, to);
+			else if (o > _origin)
+				std::copy_backward(from, from + size() + 1, to + size() + 1);
+			_origin = o;
+		}
+
+		// The descent goes right while the key is smaller, so after it the path to the answer
+		// ends in a run of right turns plus one left turn: dropping them gives the position of
+		// the first key not less than k (0 when there is none).
+		size_t lowerIndex(const key_type& k) const {
+			const key_type*	keys = this->keys();
+			size_t			n = size();
+			size_t			i = 1;
+
+			while (i <= n){
+				prefetch(keys + i * stride);
+				i = 2 * i + _comp(keys[i], k);}
+			return (dropRightTurns(i));
+		}
+
+		size_t upperIndex(const key_type& k) const {
+			const key_type*	keys = this->keys();
+			size_t			n = size();
+			size_t			i = 1;
+
+			while (i <= n){
+				prefetch(keys + i * stride);
+				i = 2 * i + !_comp(k, keys[i]);}
+			return (dropRightTurns(i));
+		}
+
+		size_t findIndex(const key_type& k) const {
+			size_t i = lowerIndex(k);
+
+			return ((i && !_comp(k, keys()[i])) ? i : 0);
+		}
+
+		static size_t dropRightTurns(size_t i) {
+		#ifdef __GNUC__
+			return (i >> __builtin_ffsll(~static_cast<unsigned long long>(i)));
+		#else
+			while (i & 1)
+				i >>= 1;
+			return (i >> 1);
+		#endif
+		}
+
+		// may point past the array: a prefetch never faults
+		static void prefetch(const key_type* p) {
+		#ifdef __GNUC__
+			__builtin_prefetch(p);
+		#else
+			(void)p;
+		#endif
+		}
+
+	};
+
+	template <class Key, class T, class Compare, class Allocator>
+	void swap (frozen_map<Key, T, Compare, Allocator>& x, frozen_map<Key, T, Compare, Allocator>& y)
+	{
+		x.swap(y);
+	}
+
+}
+
+#endif
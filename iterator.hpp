@@ -11,6 +11,7 @@ namespace ft
 {
 	struct random_access_iterator_tag {};
 	struct bidirectional_iterator_tag {};
+	struct forward_iterator_tag {};
 
 	// iterator traits
 	// iterator_traits<Iterator> will only have the nested types if Iterator::iterator_category exists.
@@ -110,6 +111,17 @@ namespace ft
 	};
 
 
+	// operator-> of reverse_iterator: the element's address, or for iterators whose pointer
+	// is a proxy (pairRefArrow) the proxy built around the reference
+	template< class P > struct isRawPointer { static const bool value = false; };
+	template< class T > struct isRawPointer<T*> { static const bool value = true; };
+
+	template< class Pointer, class Reference >
+	inline typename enable_if<isRawPointer<Pointer>::value, Pointer>::type reverseArrow(Reference& ref) { return (&ref); }
+
+	template< class Pointer, class Reference >
+	inline typename enable_if<!isRawPointer<Pointer>::value, Pointer>::type reverseArrow(const Reference& ref) { return (Pointer(ref)); }
+
 	template< class T >
 	struct reverse_iterator
 	{
@@ -138,7 +150,7 @@ namespace ft
 			iterator_type base() const {return _elem;};
 			
 			reference operator*(void) const { iterator_type tmp = _elem; return *--tmp; };
-			pointer operator->() const {return &(operator*());};
+			pointer operator->() const {return reverseArrow<pointer>(operator*());};
 
 			reverse_iterator& operator++() {--_elem; return *this;};
 			reverse_iterator operator++(int) {reverse_iterator tmp(*this); --_elem; return tmp;};
@@ -177,12 +189,13 @@ namespace ft
 
 		private:
 			T _iter;
+			T _nil; // sentinel of the owning tree, nil is told apart by address
 
 		public:
-			mapIterator(T val = nullptr) : _iter(val){};
+			mapIterator(T val = nullptr, T nil = nullptr) : _iter(val), _nil(nil){};
 
 			template <class Tp, class Up>
-			mapIterator(const mapIterator<Tp, Up> &cp, typename std::enable_if<!ft::is_convertible<Up, iterator_type>::value>::type* = 0):_iter(cp.base()) {};
+			mapIterator(const mapIterator<Tp, Up> &cp, typename std::enable_if<!ft::is_convertible<Up, iterator_type>::value>::type* = 0):_iter(cp.base()), _nil(cp.nil()) {};
 
 			// mapIterator(const mapIterator &cp):_iter(cp._iter) {};
 			// mapIterator &operator=(mapIterator < typename ft::remove_const< T >::type,  U, Compare> const  &cp){
@@ -192,34 +205,36 @@ namespace ft
 
 			mapIterator &operator=(mapIterator const  &cp){
 				_iter = cp._iter;
+				_nil = cp._nil;
 				return (*this);
 			};
 			~mapIterator(){};
 
 			T base() const { return _iter; }			
+			T nil() const { return _nil; }
 
 			iterator_type min(iterator_type x)	{
-				while (x->left->isNil != true)
+				while (x->left != _nil)
 					x = x->left;
 				return (x);
 			}
 
 			iterator_type max(iterator_type x)
 			{
-				while (x->right->isNil != true)
+				while (x->right != _nil)
 					x = x->right;
 				return (x);
 			}
 
 			iterator_type next(){
 				iterator_type y;
-				if (_iter->right->isNil == false)
+				if (_iter->right != _nil)
 					return(min(_iter->right));
-				y = _iter->parent;
+				y = _iter->parent();
 			
-				while (y->isNil == false && _iter == y->right){ // for case if y is right kid of it's parent
+				while (y != _nil && _iter == y->right){ // for case if y is right kid of it's parent
 					_iter = y;
-					y = y->parent;
+					y = y->parent();
 				}
 				return (y);
 			}
@@ -227,12 +242,12 @@ namespace ft
 			iterator_type prev(){
 				iterator_type y;
 
-				if (_iter->isNil == true || _iter->left->isNil == false)
+				if (_iter == _nil || _iter->left != _nil)
 					return(max(_iter->left));
-				y = _iter->parent;
-				while (y->isNil == false && _iter == y->left){ // for case if y is left kid of it's parent
+				y = _iter->parent();
+				while (y != _nil && _iter == y->left){ // for case if y is left kid of it's parent
 					_iter = y;
-					y = y->parent;}
+					y = y->parent();}
 				return (y);
 			}
 
@@ -258,10 +273,10 @@ namespace ft
 				return tem;
 			}
 			
-			reference operator*() {return _iter->keyValue;}
-			const_reference operator*() const {return _iter->keyValue;}
-			pointer operator->() {return &(_iter->keyValue);}
-			const_pointer operator->() const {return &(_iter->keyValue);}
+			reference operator*() {return _iter->value();}
+			const_reference operator*() const {return _iter->value();}
+			pointer operator->() {return &(_iter->value());}
+			const_pointer operator->() const {return &(_iter->value());}
 
 			template <class Tp, class Up>
 			friend	bool operator==(const mapIterator& x, const mapIterator<Tp, Up>& y)
@@ -273,6 +288,84 @@ namespace ft
 
 	};
 
+
+	// reference to a key and a value stored apart (flat and node-array containers)
+	template< class K, class V >
+	struct pairRef
+	{
+		const K&	first;
+		V&			second;
+
+		pairRef(const K& k, V& v): first(k), second(v){};
+		operator ft::pair<K, typename remove_const<V>::type>() const { return ft::pair<K, typename remove_const<V>::type>(first, second); }
+	};
+
+	// operator-> of an iterator that returns pairRef by value
+	template< class K, class V >
+	struct pairRefArrow
+	{
+		pairRef<K, V> _ref;
+
+		pairRefArrow(const pairRef<K, V>& ref): _ref(ref){};
+		pairRef<K, V>* operator->() { return &_ref; }
+	};
+
+
+	template< class Key, class T >
+	struct flatMapIterator
+	{
+		public:
+			typedef ft::pair<const Key, typename remove_const<T>::type>	value_type;
+			typedef pairRef<Key, T>										reference;
+			typedef pairRefArrow<Key, T>								pointer;
+			typedef random_access_iterator_tag							iterator_category;
+			typedef ptrdiff_t											difference_type;
+
+		private:
+			const Key*	_key;
+			T*			_value;
+
+		public:
+			flatMapIterator(): _key(0), _value(0){};
+			flatMapIterator(const Key* k, T* v): _key(k), _value(v){};
+
+			template <class Up>
+			flatMapIterator(const flatMapIterator<Key, Up>& cp): _key(cp.keyBase()), _value(cp.valueBase()){};
+
+			const Key* keyBase() const { return _key; }
+			T* valueBase() const { return _value; }
+
+			reference operator*() const { return reference(*_key, *_value); }
+			pointer operator->() const { return pointer(reference(*_key, *_value)); }
+			reference operator[](difference_type n) const { return reference(_key[n], _value[n]); }
+
+			flatMapIterator &operator++(){ ++_key; ++_value; return (*this);};
+			flatMapIterator operator++(int){ flatMapIterator temp = *this; ++*this; return temp; };
+			flatMapIterator &operator--(){ --_key; --_value; return (*this);};
+			flatMapIterator operator--(int){ flatMapIterator temp = *this; --*this; return temp; };
+
+			flatMapIterator &operator+=(difference_type n){ _key += n; _value += n; return (*this);}
+			flatMapIterator &operator-=(difference_type n){ _key -= n; _value -= n; return (*this);}
+			flatMapIterator operator+(difference_type n) const { return (flatMapIterator(_key + n, _value + n)); }
+			flatMapIterator operator-(difference_type n) const { return (flatMapIterator(_key - n, _value - n)); }
+
+			template <class Up>
+			difference_type operator-(const flatMapIterator<Key, Up>& it) const { return (_key - it.keyBase()); };
+
+			template <class Up>
+			bool operator==(const flatMapIterator<Key, Up>& it) const {return (_key == it.keyBase());};
+			template <class Up>
+			bool operator!=(const flatMapIterator<Key, Up>& it) const {return (_key != it.keyBase());};
+			template <class Up>
+			bool operator<(const flatMapIterator<Key, Up>& it) const {return (_key < it.keyBase());};
+			template <class Up>
+			bool operator>(const flatMapIterator<Key, Up>& it) const {return (_key > it.keyBase());};
+			template <class Up>
+			bool operator<=(const flatMapIterator<Key, Up>& it) const {return (_key <= it.keyBase());};
+			template <class Up>
+			bool operator>=(const flatMapIterator<Key, Up>& it) const {return (_key >= it.keyBase());};
+	};
+
 }
 
 #endif
@@ -0,0 +1,452 @@
+#ifndef LRU_CACHE_HPP
+#define LRU_CACHE_HPP
+
+#include <memory>
+#include <new>
+#include <functional>
+#include <stdexcept>
+#include <pthread.h>
+#include "utils.hpp"
+#include "tree.hpp"
+
+namespace ft
+{
+	// Weighers: the share of the capacity an entry takes
+
+	// capacity in entries
+	struct lru_entries
+	{
+		template <class K, class V>
+		size_t operator()(const K&, const V&) const { return (1); }
+	};
+
+	// capacity in bytes of key and value; pass your own weigher for values that own heap
+	// memory (strings, vectors) to count it too
+	struct lru_bytes
+	{
+		template <class K, class V>
+		size_t operator()(const K&, const V&) const { return (sizeof(K) + sizeof(V)); }
+	};
+
+	// default eviction callback: does nothing
+	struct lru_ignore
+	{
+		template <class K, class V>
+		void operator()(const K&, V&) const {}
+	};
+
+	struct lru_stats
+	{
+		size_t	hits;
+		size_t	misses;
+		size_t	evictions;
+
+		lru_stats(): hits(0), misses(0), evictions(0) {}
+
+		double hit_rate() const { return (hits + misses ? static_cast<double>(hits) / (hits + misses) : 0.0); }
+	};
+
+	// the mapped part of a cache node: the value plus the recency links, so the tree node is
+	// the list node too and an entry costs one allocation
+	template <class Key, class T>
+	struct lruSlot
+	{
+		typedef ft::node<ft::pair<const Key, lruSlot> >	node_type;
+
+		T			value;
+		node_type*	newer;
+		node_type*	older;
+		size_t		weight;
+
+		lruSlot(): value(), newer(0), older(0), weight(0) {}
+		lruSlot(const T& v): value(v), newer(0), older(0), weight(0) {}
+	};
+
+	// Bounded ordered cache: a red-black tree keyed by Key whose nodes are also threaded on a
+	// doubly linked recency list. get and put search the tree once and relink in O(1); put
+	// evicts from the least recently used end until the total weight fits the capacity,
+	// calling Evict(key, value) for each entry pushed out (not for erase or clear).
+	// Pointers returned by get and peek stay valid until the entry is evicted or erased.
+	// Not thread safe, see concurrent_lru_cache.
+	template <class Key, class T, class Compare = std::less<Key>, class Weigher = ft::lru_entries,
+		class Evict = ft::lru_ignore, class Allocator = std::allocator<pair<const Key, T> > >
+	class lru_cache
+	{
+
+	public:
+		typedef Key																key_type;
+		typedef T																mapped_type;
+		typedef Compare															key_compare;
+		typedef Weigher															weigher_type;
+		typedef Evict															evict_type;
+		typedef Allocator														allocator_type;
+		typedef size_t															size_type;
+
+	private:
+		typedef ft::lruSlot<key_type, mapped_type>								slot;
+		typedef ft::pair<const key_type, slot>									entry;
+		typedef typename slot::node_type										node_type;
+		typedef typename Allocator::template rebind<node_type>::other			allocatorNode;
+		typedef ft::tree<entry, allocatorNode, key_compare>						tree_type;
+
+		key_compare		_comp;
+		tree_type		_tree;
+		node_type*		_newest;
+		node_type*		_oldest;
+		size_type		_capacity;
+		size_type		_weight;
+		weigher_type	_weigh;
+		evict_type		_evict;
+		lru_stats		_stats;
+
+		// the links point into the nodes of this tree
+		lru_cache(const lru_cache&);
+		lru_cache& operator=(const lru_cache&);
+
+	public:
+
+		// capacity is in the unit of the weigher: entries by default
+		explicit lru_cache(size_type capacity, const key_compare& comp = key_compare(),
+			const weigher_type& weigh = weigher_type(), const evict_type& evict = evict_type()):
+			_comp(comp), _tree(comp), _newest(0), _oldest(0), _capacity(capacity), _weight(0), _weigh(weigh), _evict(evict) {}
+
+		~lru_cache() {}
+
+		// Capacity
+		size_type size() const { return (_tree.size()); }
+		bool empty() const { return (_tree.size() == 0); }
+		size_type capacity() const { return (_capacity); }
+		size_type weight() const { return (_weight); }
+
+		// evicts down to the new capacity
+		void set_capacity(size_type capacity) {
+			_capacity = capacity;
+			shrink();
+		}
+
+		// Lookups
+
+		// the value of k, made the most recently used; NULL on a miss
+		mapped_type* get(const key_type& k) {
+			node_type* x = _tree.treeSearch(k);
+
+			if (x == _tree.end()){
+				++_stats.misses;
+				return (NULL);}
+			++_stats.hits;
+			promote(x);
+			return (&x->value().second.value);
+		}
+
+		// the value of k without touching its recency or the stats; NULL on a miss
+		const mapped_type* peek(const key_type& k) const {
+			node_type* x = _tree.treeSearch(k);
+
+			return (x == _tree.end() ? NULL : &x->value().second.value);
+		}
+
+		size_type count(const key_type& k) const { return (_tree.treeSearch(k) == _tree.end() ? 0 : 1); }
+
+		// Modifiers
+
+		// inserts or overwrites k, makes it the most recently used, then evicts least recently
+		// used entries while the weight is over capacity (k too, if it alone does not fit);
+		// true when k was inserted
+		bool put(const key_type& k, const mapped_type& v) {
+			ft::pair<node_type*, bool>	found = _tree.findSlot(k);
+			node_type*					x = found.first;
+
+			if (found.second){ // a hit overwrites in place, no entry is built
+				x->value().second.value = v;
+				_weight -= x->value().second.weight;
+				promote(x);}
+			else {
+				x = _tree.createNode(entry(k, slot(v)));
+				_tree.linkNode(x, found.first);
+				pushNewest(x);}
+			slot& s = x->value().second;
+			s.weight = _weigh(k, s.value);
+			_weight += s.weight;
+			shrink();
+			return (!found.second);
+		}
+
+		// removes k without calling the eviction callback
+		size_type erase(const key_type& k) {
+			node_type* x = _tree.treeSearch(k);
+
+			if (x == _tree.end())
+				return (0);
+			remove(x);
+			return (1);
+		}
+
+		void clear() {
+			_tree.clear();
+			_newest = 0;
+			_oldest = 0;
+			_weight = 0;
+		}
+
+		void swap(lru_cache& x) {
+			std::swap(_comp, x._comp);
+			_tree.swap(x._tree);
+			std::swap(_newest, x._newest);
+			std::swap(_oldest, x._oldest);
+			std::swap(_capacity, x._capacity);
+			std::swap(_weight, x._weight);
+			std::swap(_weigh, x._weigh);
+			std::swap(_evict, x._evict);
+			std::swap(_stats, x._stats);
+		}
+
+		// Traversal, neither touches recency
+
+		// f(key, value) in key order
+		template <class Function>
+		void for_each(Function f) const {
+			for (node_type* x = _tree.begin(); x != _tree.end(); x = _tree.successor(x))
+				f(x->value().first, static_cast<const mapped_type&>(x->value().second.value));
+		}
+
+		// f(key, value) from the most to the least recently used
+		template <class Function>
+		void for_each_recent(Function f) const {
+			for (node_type* x = _newest; x; x = x->value().second.older)
+				f(x->value().first, static_cast<const mapped_type&>(x->value().second.value));
+		}
+
+		// Observers
+		lru_stats stats() const { return (_stats); }
+		void reset_stats() { _stats = lru_stats(); }
+		key_compare key_comp() const { return (_comp); }
+		evict_type& evictor() { return (_evict); }
+
+	private:
+		void pushNewest(node_type* x) {
+			slot& s = x->value().second;
+
+			s.older = _newest;
+			s.newer = 0;
+			if (_newest)
+				_newest->value().second.newer = x;
+			else
+				_oldest = x;
+			_newest = x;
+		}
+
+		void unlink(node_type* x) {
+			slot& s = x->value().second;
+
+			if (s.newer)
+				s.newer->value().second.older = s.older;
+			else
+				_newest = s.older;
+			if (s.older)
+				s.older->value().second.newer = s.newer;
+			else
+				_oldest = s.newer;
+		}
+
+		void promote(node_type* x) {
+			if (x == _newest)
+				return ;
+			unlink(x);
+			pushNewest(x);
+		}
+
+		void remove(node_type* x) {
+			unlink(x);
+			_weight -= x->value().second.weight;
+			_tree.rbTreeDelete(x);
+		}
+
+		// the callback runs before the entry goes: if it throws, the entry stays
+		void shrink() {
+			while (_weight > _capacity && _oldest){
+				_evict(_oldest->value().first, _oldest->value().second.value);
+				++_stats.evictions;
+				remove(_oldest);}
+		}
+	};
+
+	template <class Key, class T, class Compare, class Weigher, class Evict, class Allocator>
+	void swap (lru_cache<Key, T, Compare, Weigher, Evict, Allocator>& x, lru_cache<Key, T, Compare, Weigher, Evict, Allocator>& y)
+	{
+		x.swap(y);
+	}
+
+	// lru_cache for concurrent use: keys are spread by hash over independent caches (shards),
+	// each behind its own mutex (a get relinks, so even lookups write) and with an equal share
+	// of the capacity. Recency is per shard, so the entry evicted is the least recently used
+	// of its shard, not of the whole cache. Lookups copy the value out; the eviction callback
+	// runs under the shard's lock and must not call back into the cache.
+	template <class Key, class T, class Compare = std::less<Key>, class Hash = ft::hash<Key>,
+		class Weigher = ft::lru_entries, class Evict = ft::lru_ignore,
+		class Allocator = std::allocator<pair<const Key, T> > >
+	class concurrent_lru_cache
+	{
+
+	public:
+		typedef Key																key_type;
+		typedef T																mapped_type;
+		typedef Compare															key_compare;
+		typedef Hash															hasher;
+		typedef Weigher															weigher_type;
+		typedef Evict															evict_type;
+		typedef Allocator														allocator_type;
+		typedef size_t															size_type;
+		typedef ft::lru_cache<Key, T, Compare, Weigher, Evict, Allocator>		cache_type;
+
+	private:
+		// one lock and one cache, padded so that two shards never share a cache line
+		struct shard
+		{
+			pthread_mutex_t		lock;
+			cache_type			cache;
+			char				pad[64];
+
+			shard(size_type capacity, const key_compare& comp, const weigher_type& weigh, const evict_type& evict):
+				cache(capacity, comp, weigh, evict) {
+				if (pthread_mutex_init(&lock, NULL) != 0)
+					throw std::runtime_error("concurrent_lru_cache: pthread_mutex_init"); }
+			~shard() { pthread_mutex_destroy(&lock); }
+		};
+
+		typedef typename Allocator::template rebind<shard>::other				allocatorShard;
+
+		struct guard
+		{
+			pthread_mutex_t* l;
+			guard(pthread_mutex_t* lock): l(lock) { pthread_mutex_lock(l); }
+			~guard() { pthread_mutex_unlock(l); }
+		};
+
+		hasher				_hash;
+		allocatorShard		_alloc;
+		shard*				_shards;
+		size_t				_count;		// power of two
+		size_t				_shift;		// shard index = top bits of the hash
+
+		concurrent_lru_cache(const concurrent_lru_cache&);
+		concurrent_lru_cache& operator=(const concurrent_lru_cache&);
+
+	public:
+
+		// shards is rounded up to a power of two, each gets capacity / shards (rounded up)
+		explicit concurrent_lru_cache(size_type capacity, size_type shards = 16, const key_compare& comp = key_compare(),
+			const hasher& hash = hasher(), const weigher_type& weigh = weigher_type(),
+			const evict_type& evict = evict_type(), const allocator_type& alloc = allocator_type()):
+			_hash(hash), _alloc(alloc), _shards(0), _count(1), _shift(sizeof(size_t) * 8)
+		{
+			size_t i = 0;
+
+			while (_count < shards){
+				_count <<= 1;
+				--_shift;}
+			_shards = _alloc.allocate(_count);
+			try {
+				for (; i < _count; ++i)
+					new (&_shards[i]) shard((capacity + _count - 1) / _count, comp, weigh, evict);
+			}
+			catch (...) {
+				while (i > 0)
+					_shards[--i].~shard();
+				_alloc.deallocate(_shards, _count);
+				throw ;
+			}
+		}
+
+		~concurrent_lru_cache() {
+			for (size_t i = 0; i < _count; ++i)
+				_shards[i].~shard();
+			_alloc.deallocate(_shards, _count);
+		}
+
+		// Capacity (a moment's view: other threads may change it right after)
+		size_type size() const { return (sum(&cache_type::size)); }
+		bool empty() const { return (size() == 0); }
+		size_type weight() const { return (sum(&cache_type::weight)); }
+		size_type capacity() const { return (sum(&cache_type::capacity)); }
+		size_type shard_count() const { return (_count); }
+
+		// Single-key operations, each locks one shard
+
+		// copies the value of k into value and makes it the most recently used of its shard
+		bool get(const key_type& k, mapped_type& value) {
+			shard&			s = shardOf(k);
+			guard			g(&s.lock);
+			mapped_type*	v = s.cache.get(k);
+
+			if (!v)
+				return (false);
+			value = *v;
+			return (true);
+		}
+
+		// same without touching recency or the stats
+		bool peek(const key_type& k, mapped_type& value) const {
+			shard&				s = shardOf(k);
+			guard				g(&s.lock);
+			const mapped_type*	v = s.cache.peek(k);
+
+			if (!v)
+				return (false);
+			value = *v;
+			return (true);
+		}
+
+		bool put(const key_type& k, const mapped_type& v) {
+			shard&	s = shardOf(k);
+			guard	g(&s.lock);
+
+			return (s.cache.put(k, v));
+		}
+
+		size_type erase(const key_type& k) {
+			shard&	s = shardOf(k);
+			guard	g(&s.lock);
+
+			return (s.cache.erase(k));
+		}
+
+		void clear() {
+			for (size_t i = 0; i < _count; ++i){
+				guard g(&_shards[i].lock);
+				_shards[i].cache.clear();}
+		}
+
+		// Observers
+		lru_stats stats() const {
+			lru_stats res;
+
+			for (size_t i = 0; i < _count; ++i){
+				guard		g(&_shards[i].lock);
+				lru_stats	s = _shards[i].cache.stats();
+				res.hits += s.hits;
+				res.misses += s.misses;
+				res.evictions += s.evictions;}
+			return (res);
+		}
+
+		hasher hash_function() const { return (_hash); }
+
+	private:
+		// the shift would be the full word width for a single shard
+		size_t shardIndex(const key_type& k) const { return (_count == 1 ? 0 : _hash(k) >> _shift); }
+
+		shard& shardOf(const key_type& k) const { return (_shards[shardIndex(k)]); }
+
+		size_type sum(size_type (cache_type::*f)() const) const {
+			size_type n = 0;
+
+			for (size_t i = 0; i < _count; ++i){
+				guard g(&_shards[i].lock);
+				n += (_shards[i].cache.*f)();}
+			return (n);
+		}
+	};
+
+}
+
+#endif
@@ -0,0 +1,524 @@
+#ifndef LSM_MAP_HPP
+#define LSM_MAP_HPP
+
+#include <memory>
+#include <new>
+#include <functional>
+#include <stdexcept>
+#include "utils.hpp"
+#include "iterator.hpp"
+#include "vector.hpp"
+#include "btree_map.hpp"
+
+namespace ft
+{
+	// a buffered write: the new value, or a tombstone that hides the key in older runs
+	template <class T>
+	struct lsmSlot
+	{
+		T		value;
+		bool	dead;
+
+		lsmSlot(): value(), dead(false) {}
+		lsmSlot(const T& v, bool d): value(v), dead(d) {}
+	};
+
+	// k-way merge over the buffer and every run. At each step the smallest key wins, the
+	// newest source among equal keys; the older copies are skipped, and so are tombstones.
+	// -- finds the largest key below the current one in every source and restarts the merge
+	// there, O(runs log n) per step
+	template <class Map, class Key, class T, class BufferIterator>
+	struct lsmMapIterator
+	{
+		public:
+			typedef Key													key_type;
+			typedef T													mapped_type;
+			typedef ft::pair<const key_type, mapped_type>				value_type;
+			typedef pairRef<key_type, const mapped_type>				reference;
+			typedef pairRefArrow<key_type, const mapped_type>			pointer;
+			typedef bidirectional_iterator_tag							iterator_category;
+			typedef ptrdiff_t											difference_type;
+
+		private:
+			typedef BufferIterator										bufferIterator;
+
+			static const size_t	npos = static_cast<size_t>(-1);
+
+			const Map*			_map;
+			ft::vector<size_t>	_pos;	// one cursor per run
+			bufferIterator		_buf;
+			bufferIterator		_bufEnd;
+			size_t				_cur;	// source of the current entry: a run index, _pos.size() for the buffer, npos at the end
+
+			bool exhausted(size_t s) const { return (s < _pos.size() ? _pos[s] == _map->_runs[s]->keys.size() : _buf == _bufEnd); }
+			const key_type& key(size_t s) const { return (s < _pos.size() ? _map->_runs[s]->keys[_pos[s]] : (*_buf).first); }
+			bool dead(size_t s) const { return (s < _pos.size() ? _map->_runs[s]->dead[_pos[s]] : (*_buf).second.dead); }
+
+			void advance(size_t s) {
+				if (s < _pos.size())
+					++_pos[s];
+				else
+					++_buf;
+			}
+
+			// moves every source past the key of s, s itself last so the key stays valid
+			void skip(size_t s) {
+				for (size_t i = 0; i <= _pos.size(); ++i)
+					if (i != s && !exhausted(i) && !_map->_comp(key(s), key(i)))
+						advance(i);
+				advance(s);
+			}
+
+			// newest first: the buffer, then the runs from the newest down
+			void settle() {
+				size_t best;
+
+				while (true){
+					best = npos;
+					for (size_t s = _pos.size() + 1; s-- > 0;)
+						if (!exhausted(s) && (best == npos || _map->_comp(key(s), key(best))))
+							best = s;
+					if (best == npos || !dead(best)){
+						_cur = best;
+						return ;}
+					skip(best);
+				}
+			}
+
+			// the last live key below *limit, or below everything when limit is 0; a key whose
+			// newest version is a tombstone sends the search further down
+			void retreat(const key_type* limit) {
+				const key_type*			best;
+				bufferIterator			b;
+				size_t					i;
+
+				while (true){
+					best = 0;
+					for (size_t s = 0; s < _map->_runs.size(); ++s){
+						const typename Map::run& r = *_map->_runs[s];
+						i = limit ? Map::lowerIndex(r, *limit, _map->_comp) : r.keys.size();
+						if (i > 0 && (!best || _map->_comp(*best, r.keys[i - 1])))
+							best = &r.keys[i - 1];}
+					b = limit ? _map->_buffer.lower_bound(*limit) : _map->_buffer.end();
+					if (b != _map->_buffer.begin() && (--b, !best || _map->_comp(*best, (*b).first)))
+						best = &(*b).first;
+					if (!best){ // nothing below: -- on begin()
+						*this = lsmMapIterator(_map);
+						return ;}
+					*this = lsmMapIterator(_map, best);
+					if (_cur != npos && !_map->_comp(*best, key(_cur)))
+						return ;
+					limit = best;
+				}
+			}
+
+		public:
+			lsmMapIterator(): _map(0), _cur(npos){};
+			lsmMapIterator(const Map* m): _map(m), _cur(npos){};
+
+			// every source positioned at its first key not less than k (any key when k is 0)
+			lsmMapIterator(const Map* m, const key_type* k): _map(m), _pos(m->_runs.size(), 0),
+				_buf(k ? m->_buffer.lower_bound(*k) : m->_buffer.begin()), _bufEnd(m->_buffer.end()), _cur(npos) {
+				if (k)
+					for (size_t s = 0; s < _pos.size(); ++s)
+						_pos[s] = Map::lowerIndex(*m->_runs[s], *k, m->_comp);
+				settle();
+			}
+
+			reference operator*() const {
+				if (_cur < _pos.size())
+					return (reference(_map->_runs[_cur]->keys[_pos[_cur]], _map->_runs[_cur]->values[_pos[_cur]]));
+				return (reference((*_buf).first, (*_buf).second.value));
+			}
+			pointer operator->() const { return pointer(operator*()); }
+
+			lsmMapIterator& operator++() {
+				skip(_cur);
+				settle();
+				return (*this);
+			}
+			lsmMapIterator operator++(int) { lsmMapIterator tmp(*this); ++(*this); return tmp; }
+
+			lsmMapIterator& operator--() {
+				retreat(_cur == npos ? 0 : &key(_cur));
+				return (*this);
+			}
+			lsmMapIterator operator--(int) { lsmMapIterator tmp(*this); --(*this); return tmp; }
+
+			bool operator==(const lsmMapIterator& it) const {
+				if (_cur == npos || it._cur == npos)
+					return (_cur == it._cur);
+				return (_cur == it._cur && (_cur < _pos.size() ? _pos[_cur] == it._pos[_cur] : _buf == it._buf));
+			}
+			bool operator!=(const lsmMapIterator& it) const { return !(*this == it); }
+	};
+
+
+	// Write-optimized ordered map (log-structured merge). Writes go into a small in-memory
+	// btree_map (the buffer); when it holds buffer_size() entries it is flushed into an
+	// immutable sorted run, keys and values in two ft::vector arrays. Runs are compacted by
+	// size tier: every flush makes a tier-0 run, and fanout runs of the same tier are merged
+	// into one run of the next tier, so there are O(log n) runs and each entry is rewritten
+	// O(log n) times. Erasing writes a tombstone, dropped once a merge reaches the oldest run.
+	// insert_or_assign and erase are blind writes: they never look at the runs. Lookups check
+	// the buffer, then the runs from the newest, each with one binary search. Iteration is a
+	// k-way merge of the buffer and the runs; iterators are const and bidirectional (-- costs
+	// a search per run), and any write invalidates them. size() walks the whole map, since blind writes do not know
+	// whether a key was already there.
+	template <class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<pair<const Key, T> > >
+	class lsm_map
+	{
+
+	public:
+		typedef Key																key_type;
+		typedef T																mapped_type;
+		typedef ft::pair<const key_type, mapped_type>							value_type;
+		typedef Compare															key_compare;
+		typedef Allocator														allocator_type;
+		typedef size_t															size_type;
+		typedef ptrdiff_t														difference_type;
+
+		static const size_t		fanout = 2;
+
+	private:
+		template <class Map, class K, class V, class BufferIterator>
+		friend struct lsmMapIterator;
+
+		typedef typename Allocator::template rebind<key_type>::other				allocatorKey;
+		typedef typename Allocator::template rebind<mapped_type>::other				allocatorMapped;
+		typedef lsmSlot<mapped_type>												slot;
+		typedef typename Allocator::template rebind<pair<const key_type, slot> >::other	allocatorBuffer;
+		typedef ft::btree_map<key_type, slot, key_compare, allocatorBuffer>			buffer_type;
+
+	public:
+		typedef ft::lsmMapIterator<lsm_map, key_type, mapped_type, typename buffer_type::const_iterator>	const_iterator;
+		typedef const_iterator													iterator;
+		typedef ft::reverse_iterator<const_iterator>							const_reverse_iterator;
+		typedef const_reverse_iterator											reverse_iterator;
+		typedef typename const_iterator::reference								const_reference;
+		typedef const_reference													reference;
+
+	private:
+		// an immutable sorted run; dead marks the tombstones
+		struct run
+		{
+			ft::vector<key_type, allocatorKey>			keys;
+			ft::vector<mapped_type, allocatorMapped>	values;
+			ft::vector<char>							dead;
+			size_t										tier;
+
+			run(size_t t): tier(t) {}
+
+			void reserve(size_t n) {
+				keys.reserve(n);
+				values.reserve(n);
+				dead.reserve(n);
+			}
+
+			void push(const key_type& k, const mapped_type& v, bool d) {
+				keys.push_back(k);
+				values.push_back(v);
+				dead.push_back(d);
+			}
+		};
+
+		typedef typename Allocator::template rebind<run>::other					allocatorRun;
+
+		key_compare			_comp;
+		allocator_type		_alloc;
+		size_type			_bufferSize;
+		buffer_type			_buffer;
+		ft::vector<run*>	_runs;		// oldest first
+
+	public:
+
+		// buffer is the number of writes held before a flush
+		explicit lsm_map (size_type buffer = 4096, const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type()):
+			_comp(comp), _alloc(alloc), _bufferSize(buffer ? buffer : 1), _buffer(comp) {};
+
+		lsm_map(const lsm_map& x): _comp(x._comp), _alloc(x._alloc), _bufferSize(x._bufferSize), _buffer(x._buffer) { copyRuns(x); };
+
+		// built aside and swapped in, so a throwing copy leaves this map as it was
+		lsm_map &operator=(const lsm_map& x) {
+			if (this != &x){
+				lsm_map tmp(x);
+				swap(tmp);
+			}
+			return *this;
+		};
+
+		~lsm_map(){ clear(); };
+
+		// Iterators
+		const_iterator begin() const { return (const_iterator(this, 0)); };
+		const_iterator end() const { return (const_iterator(this)); };
+		const_reverse_iterator rbegin() const { return (const_reverse_iterator(end())); };
+		const_reverse_iterator rend() const { return (const_reverse_iterator(begin())); };
+
+		// Capacity
+		bool empty() const { return (begin() == end()); };
+
+		// O(n): counts the live keys of the merge
+		size_type size() const {
+			size_type n = 0;
+
+			for (const_iterator it = begin(); it != end(); ++it)
+				++n;
+			return (n);
+		};
+
+		size_type max_size() const { return (allocatorMapped().max_size()); };
+		size_type buffer_size() const { return (_bufferSize); };
+		size_type run_count() const { return (_runs.size()); };
+
+		// Element access
+		const mapped_type& at (const key_type& k) const {
+			const mapped_type* v = lookup(k);
+
+			if (!v)
+				throw std::out_of_range("");
+			return (*v);
+		}
+
+		// Modifiers
+
+		// false when k is already present (its value is left alone); unlike insert_or_assign
+		// it has to look k up first
+		bool insert(const value_type& v) {
+			if (lookup(v.first))
+				return (false);
+			insert_or_assign(v.first, v.second);
+			return (true);
+		}
+
+		void insert_or_assign(const key_type& k, const mapped_type& v) { write(k, slot(v, false)); }
+
+		// with no runs yet the key only has to leave the buffer
+		void erase(const key_type& k) {
+			if (_runs.empty())
+				_buffer.erase(k);
+			else
+				write(k, slot(mapped_type(), true));
+		}
+
+		void swap (lsm_map& x) {
+			std::swap(_comp, x._comp);
+			std::swap(_alloc, x._alloc);
+			std::swap(_bufferSize, x._bufferSize);
+			_buffer.swap(x._buffer);
+			_runs.swap(x._runs);
+		}
+
+		void clear() {
+			_buffer.clear();
+			for (size_t i = 0; i < _runs.size(); ++i)
+				deleteRun(_runs[i]);
+			_runs.clear();
+		}
+
+		// turns the buffer into a run now
+		void flush() {
+			run* r;
+
+			if (_buffer.empty())
+				return ;
+			r = newRun(0);
+			try {
+				r->reserve(_buffer.size());
+				for (typename buffer_type::const_iterator it = _buffer.begin(); it != _buffer.end(); ++it)
+					if (!_runs.empty() || !(*it).second.dead)
+						r->push((*it).first, (*it).second.value, (*it).second.dead);
+				_runs.push_back(r);
+			}
+			catch (...) { deleteRun(r); throw ; }
+			_buffer.clear();
+			while (tierTail() >= fanout)
+				mergeTail(_runs.size() - tierTail());
+		}
+
+		// flushes and merges everything into one run without tombstones, for read-mostly phases
+		void compact() {
+			flush();
+			if (_runs.size() > 1 || (_runs.size() == 1 && hasTombstones(*_runs[0])))
+				mergeTail(0);
+		}
+
+		// Lookup
+		const_iterator find (const key_type& k) const { return (lookup(k) ? lower_bound(k) : end()); }
+
+		size_type count (const key_type& k) const { return (lookup(k) ? 1 : 0); }
+
+		const_iterator lower_bound (const key_type& k) const { return (const_iterator(this, &k)); };
+
+		const_iterator upper_bound (const key_type& k) const {
+			const_iterator it = lower_bound(k);
+
+			if (it != end() && !_comp(k, it->first))
+				++it;
+			return (it);
+		};
+
+		pair<const_iterator,const_iterator> equal_range (const key_type& k) const { return (ft::make_pair(lower_bound(k), upper_bound(k))); }
+
+		allocator_type get_allocator() const { return (_alloc); };
+
+		// Observers
+		key_compare key_comp() const { return (_comp); };
+
+	private:
+		void write(const key_type& k, const slot& s) {
+			ft::pair<typename buffer_type::iterator, bool> res = _buffer.insert(ft::pair<const key_type, slot>(k, s));
+
+			if (!res.second)
+				(*res.first).second = s;
+			if (_buffer.size() >= _bufferSize)
+				flush();
+		}
+
+		// the newest version of k, 0 when absent or erased
+		const mapped_type* lookup(const key_type& k) const {
+			typename buffer_type::const_iterator it = _buffer.find(k);
+			size_t i;
+
+			if (it != _buffer.end())
+				return ((*it).second.dead ? 0 : &(*it).second.value);
+			for (size_t s = _runs.size(); s-- > 0;){
+				const run& r = *_runs[s];
+				if (r.keys.empty() || _comp(k, r.keys[0]) || _comp(r.keys.back(), k))
+					continue ;
+				i = lowerIndex(r, k, _comp);
+				if (!_comp(k, r.keys[i]))
+					return (r.dead[i] ? 0 : &r.values[i]);
+			}
+			return (0);
+		}
+
+		// branchless binary search over the key array of a run, as in flat_map
+		static size_t lowerIndex(const run& r, const key_type& k, const key_compare& comp) {
+			size_t			len = r.keys.size();
+			const key_type*	base = r.keys.data();
+
+			if (len == 0)
+				return 0;
+			while (len > 1) {
+				size_t half = len / 2;
+				prefetch(base + half / 2 - 1);
+				prefetch(base + half + half / 2 - 1);
+				base += comp(base[half - 1], k) ? half : 0;
+				len -= half;
+			}
+			base += comp(*base, k);
+			return (base - r.keys.data());
+		}
+
+		static void prefetch(const key_type* p) {
+		#ifdef __GNUC__
+			__builtin_prefetch(p);
+		#else
+			(void)p;
+		#endif
+		}
+
+		// how many runs at the end share the newest run's tier
+		size_t tierTail() const {
+			size_t n = 0;
+
+			while (n < _runs.size() && _runs[_runs.size() - 1 - n]->tier == _runs.back()->tier)
+				++n;
+			return (n);
+		}
+
+		static bool hasTombstones(const run& r) {
+			for (size_t i = 0; i < r.dead.size(); ++i)
+				if (r.dead[i])
+					return (true);
+			return (false);
+		}
+
+		// merges runs [from, end) into one run of the next tier, the newest copy of each key
+		// winning; tombstones go when nothing older is left underneath
+		void mergeTail(size_t from) {
+			const size_t		k = _runs.size() - from;
+			const bool			bottom = (from == 0);
+			ft::vector<size_t>	pos(k, 0);
+			size_t				total = 0;
+			size_t				tier = 0;
+			size_t				best;
+			run*				out;
+
+			for (size_t s = from; s < _runs.size(); ++s){
+				total += _runs[s]->keys.size();
+				if (_runs[s]->tier >= tier)
+					tier = _runs[s]->tier + 1;}
+			out = newRun(tier);
+			try {
+				out->reserve(total);
+				while (true){
+					best = k;
+					for (size_t s = k; s-- > 0;)
+						if (pos[s] < _runs[from + s]->keys.size() && (best == k
+							|| _comp(_runs[from + s]->keys[pos[s]], _runs[from + best]->keys[pos[best]])))
+							best = s;
+					if (best == k)
+						break ;
+					const run&		b = *_runs[from + best];
+					const size_t	i = pos[best];
+					if (!(bottom && b.dead[i]))
+						out->push(b.keys[i], b.values[i], b.dead[i]);
+					for (size_t s = 0; s < k; ++s)
+						if (s != best && pos[s] < _runs[from + s]->keys.size() && !_comp(b.keys[i], _runs[from + s]->keys[pos[s]]))
+							++pos[s];
+					++pos[best];
+				}
+			}
+			catch (...) { deleteRun(out); throw ; }
+			for (size_t s = from; s < _runs.size(); ++s)
+				deleteRun(_runs[s]);
+			_runs.resize(from);
+			if (out->keys.empty())
+				deleteRun(out);
+			else
+				_runs.push_back(out);
+		}
+
+		run* newRun(size_t tier) {
+			allocatorRun	a(_alloc);
+			run*			r = a.allocate(1);
+
+			new (r) run(tier);
+			return (r);
+		}
+
+		void deleteRun(run* r) {
+			allocatorRun a(_alloc);
+
+			r->~run();
+			a.deallocate(r, 1);
+		}
+
+		// for the copy constructor, where no destructor runs on a throw: the runs copied so
+		// far are freed before the exception goes on
+		void copyRuns(const lsm_map& x) {
+			run* r;
+
+			_runs.reserve(x._runs.size());
+			try {
+				for (size_t s = 0; s < x._runs.size(); ++s){
+					r = newRun(x._runs[s]->tier);
+					try { *r = *x._runs[s]; }
+					catch (...) { deleteRun(r); throw ; }
+					_runs.push_back(r);}
+			}
+			catch (...) {
+				for (size_t s = 0; s < _runs.size(); ++s)
+					deleteRun(_runs[s]);
+				_runs.clear();
+				throw ;
+			}
+		}
+
+	};
+
+}
+
+#endif
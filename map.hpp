@@ -4,13 +4,84 @@
 #include <iostream> 
 #include <memory> 
 #include <functional>
+#include <utility>
 #include "utils.hpp"
 #include "iterator.hpp"
 #include "tree.hpp"
+#include "frozen_map.hpp"
+#include "parallel_sort.hpp"
+#include "bloom_filter.hpp"
  
 namespace ft 
 { 
-	template <class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<pair<const Key, T> > >
+#if __cplusplus >= 201103L
+	// owns a node taken out of a map by map::extract until it is inserted into a map of the
+	// same type or destroyed; the key may be changed in between
+	template <class Key, class T, class Node, class NodeAllocator>
+	class mapNodeHandle
+	{
+
+	public:
+		typedef Key				key_type;
+		typedef T				mapped_type;
+		typedef NodeAllocator	allocator_type;
+
+	private:
+		template <class, class, class, class, class, class, class, class> friend class map;
+
+		Node*			_node;
+		NodeAllocator	_alloc;
+
+		mapNodeHandle(Node* n, const NodeAllocator& alloc): _node(n), _alloc(alloc) {};
+
+		Node* release() { Node* n = _node; _node = 0; return (n); }
+
+		void reset() {
+			if (_node){
+				releaseNode(_alloc, _node);
+				_node = 0;}
+		}
+
+	public:
+		mapNodeHandle(): _node(0) {};
+		mapNodeHandle(mapNodeHandle&& x): _node(x._node), _alloc(x._alloc) { x._node = 0; };
+		mapNodeHandle(const mapNodeHandle&) = delete;
+		mapNodeHandle& operator=(const mapNodeHandle&) = delete;
+
+		mapNodeHandle& operator=(mapNodeHandle&& x) {
+			if (this != &x){
+				reset();
+				_node = x.release();
+				_alloc = x._alloc;}
+			return (*this);
+		};
+
+		~mapNodeHandle() { reset(); };
+
+		bool empty() const { return (_node == 0); };
+		explicit operator bool() const { return (_node != 0); };
+
+		// the node is out of any tree, so its key may be rewritten before it goes back in
+		key_type& key() const { return (const_cast<key_type&>(_node->value().first)); };
+		mapped_type& mapped() const { return (_node->value().second); };
+		allocator_type get_allocator() const { return (_alloc); };
+
+		void swap(mapNodeHandle& x) {
+			std::swap(_node, x._node);
+			std::swap(_alloc, x._alloc); };
+	};
+#endif
+
+	// Augment selects what every node summarizes (see tree.hpp): ft::no_augment by default,
+	// ft::order_statistics for nth/rank/distance, ft::range_aggregate<T> for aggregate.
+	// Layout places the values: inline in the node (ft::inline_values, the default) or out of
+	// line behind a compact node of links and key (ft::split_values) for large mapped types.
+	// Balance picks the tree: ft::red_black (default), ft::avl or ft::wavl.
+	// Filter is asked by find, count and erase before the tree: ft::no_filter (default) or
+	// ft::bloom_filter, for maps where most lookups miss (keys need an ft::hash)
+	template <class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<pair<const Key, T> >,
+		class Augment = ft::no_augment, class Layout = ft::inline_values, class Balance = ft::red_black,
+		class Filter = ft::no_filter >
 	class map
 	{
 
@@ -27,8 +98,10 @@ namespace ft
 		typedef typename Allocator::size_type														size_type;
 		typedef typename Allocator::difference_type													difference_type;
 
-		typedef typename ft::mapIterator<node<value_type>*, value_type>								iterator;
-		typedef typename ft::mapIterator<const node<value_type>*, const value_type>					const_iterator;
+		typedef typename Layout::template apply<value_type, typename Augment::summary>::type			node_type;
+		typedef typename Augment::summary															summary_type;
+		typedef typename ft::mapIterator<node_type*, value_type>									iterator;
+		typedef typename ft::mapIterator<const node_type*, const value_type>						const_iterator;
 		typedef ft::reverse_iterator<iterator>														reverse_iterator;
 		typedef ft::reverse_iterator<const_iterator>												const_reverse_iterator;
 
@@ -48,49 +121,66 @@ namespace ft
 
 		// construct:
 	private:
-		typedef typename Allocator::template rebind< node<value_type> >::other		allocatorNode;
+		typedef typename Allocator::template rebind< node_type >::other		allocatorNode;
+		typedef ft::tree<value_type, allocatorNode, key_compare, Augment, Layout, Balance>	tree_type;
 		Compare _comp; 
 		allocator_type _alloc;		
-		ft::tree<value_type, allocatorNode, value_compare> _tree;
+		tree_type _tree;
+		Filter _filter;
 
 
 	public:
 
 		explicit map (const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type()):
-			_comp(comp), _alloc(alloc), _tree(value_compare(comp)) {};
+			_comp(comp), _alloc(alloc), _tree(comp) {};
 	
 
 		template <class InputIterator>
 			map (InputIterator first, InputIterator last, const key_compare& comp = key_compare(),
 			const allocator_type& alloc = allocator_type()): 
-			_comp(comp), _tree(value_compare(comp)), _alloc(alloc)
+			_comp(comp), _alloc(alloc), _tree(comp)
 		{ insert(first, last);};
 
 
-		map(const map& x):_comp(x._comp), _tree(value_compare(x._comp)){ _tree = x._tree; };
+		map(const map& x):_comp(x._comp), _tree(x._comp), _filter(x._filter){ _tree = x._tree; };
 
 		map &operator=(const map& x) {
-			if (this != & x){		
-				if (size() > 0)
-					_tree.clear();
+			if (this != & x){
 				_comp = x._comp;
 				_tree = x._tree;
+				_filter = x._filter;
 			}
 			return *this;
 		};
 
+#if __cplusplus >= 201103L
+		map(map&& x):_comp(x._comp), _alloc(x._alloc), _tree(std::move(x._tree)){
+			_filter.swap(x._filter);
+			x._filter.reset(0); };
+
+		map &operator=(map&& x) {
+			if (this != & x){
+				_comp = x._comp;
+				_tree = std::move(x._tree);
+				_filter.swap(x._filter);
+				x._filter.reset(0);
+			}
+			return *this;
+		};
+#endif
+
 		~map(){	};
 
 		// Iterators
-		iterator begin() { return iterator(_tree.begin()); };
-		const_iterator begin() const { return const_iterator(_tree.begin()); };			
-		iterator end()  { return iterator(_tree.end()); };
-		const_iterator end() const { return const_iterator(_tree.end()); };
+		iterator begin() { return _tree.iter(_tree.begin()); };
+		const_iterator begin() const { return const_iterator(_tree.iter(_tree.begin())); };			
+		iterator end()  { return _tree.iter(_tree.end()); };
+		const_iterator end() const { return const_iterator(_tree.iter(_tree.end())); };
 
-		reverse_iterator rbegin() { return reverse_iterator(iterator(_tree.end()));};
-		const_reverse_iterator rbegin() const  { return const_reverse_iterator(const_iterator(_tree.end()));};
-		reverse_iterator rend()  { return reverse_iterator(iterator(_tree.begin()));};
-		const_reverse_iterator rend() const { return const_reverse_iterator(const_iterator(_tree.begin()));};
+		reverse_iterator rbegin() { return reverse_iterator(end());};
+		const_reverse_iterator rbegin() const  { return const_reverse_iterator(end());};
+		reverse_iterator rend()  { return reverse_iterator(begin());};
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin());};
 
 		// Capacity
 		bool empty() const { return (_tree.size() ? false : true); };
@@ -124,69 +214,384 @@ namespace ft
 		}
 
 		// Modifiers
-		ft::pair<iterator,bool> insert(const value_type& v) { return (_tree.insertNode(v)); }
+		ft::pair<iterator,bool> insert(const value_type& v) {
+			ft::pair<node_type*, bool> res = _tree.insertNode(v);
+
+			if (res.second)
+				filterAdd(v.first);
+			return (ft::make_pair(_tree.iter(res.first), res.second)); }
 
 		template <class InputIterator>
 		void insert (InputIterator first, InputIterator last){
 			while (first != last){
-				_tree.insertNode(value_type(first->first, first->second));
+				if (_tree.insertNode(value_type(first->first, first->second)).second)
+					filterAdd(first->first);
 				++first;}
 		}
 
+		// O(1) amortized when val's key goes right before or right after position (end() for
+		// appends); any other hint falls back to a search from the root (see tree::hintSlot)
 		iterator insert (iterator position, const value_type& val){
-			(void)position;		
-			return (iterator(_tree.insertNode(val).first));
+			ft::pair<node_type*, bool> res = _tree.insertNodeFrom(position.base(), val);
+
+			if (res.second)
+				filterAdd(val.first);
+			return (_tree.iter(res.first));
+		}
+
+#if __cplusplus >= 201103L
+		// Node handles: nodes move between maps of the same type with no allocation and no
+		// copy of the key or the value
+		typedef ft::mapNodeHandle<key_type, mapped_type, node_type, allocatorNode>				node_handle;
+
+		struct insert_return_type
+		{
+			iterator	position;
+			bool		inserted;
+			node_handle	node;
+		};
+
+		node_handle extract (iterator position) {
+			node_handle nh(_tree.extractNode(position.base()), _tree._alloc);
+
+			filterErase(1);
+			return (nh);
+		}
+
+		node_handle extract (const key_type& k) {
+			node_type* x = search(k);
+
+			if (x == _tree.end())
+				return (node_handle());
+			node_handle nh(_tree.extractNode(x), _tree._alloc);
+			filterErase(1);
+			return (nh);
+		}
+
+		// on an existing key the handle comes back in the result, still owning its node
+		insert_return_type insert (node_handle&& nh) {
+			insert_return_type			res;
+			ft::pair<node_type*, bool>	r;
+
+			res.inserted = false;
+			if (nh.empty()){
+				res.position = end();
+				return (res);}
+			r = _tree.insertDetached(nh._node);
+			res.position = _tree.iter(r.first);
+			if (r.second){
+				nh.release();
+				res.inserted = true;
+				filterAdd(r.first->value().first);}
+			else
+				res.node = std::move(nh);
+			return (res);
+		}
+
+		iterator insert (iterator position, node_handle&& nh) {
+			ft::pair<node_type*, bool> r;
+
+			if (nh.empty())
+				return (end());
+			r = _tree.insertDetached(nh._node, position.base());
+			if (r.second){
+				nh.release();
+				filterAdd(r.first->value().first);}
+			return (_tree.iter(r.first));
+		}
+
+		// one entry of a change set for apply_batch: an upsert sets key to value, inserting it
+		// when absent; an erase removes key when present
+		struct batch_op
+		{
+			key_type	key;
+			mapped_type	value;	// unused by an erase
+			bool		erase;
+
+			batch_op(): key(), value(), erase(false) {};
+			batch_op(const key_type& k, const mapped_type& v): key(k), value(v), erase(false) {};
+			explicit batch_op(const key_type& k): key(k), value(), erase(true) {};
+		};
+
+		// Applies a change set sorted by key (ops on an equal key apply in order) in one sweep:
+		// each op's search starts from the previous op's node and climbs only to their common
+		// ancestor, O(log d) for keys d elements apart instead of a descent from the root.
+		// Batches with more than 4 entries per op search from the root instead: below that
+		// density the climb costs more than it saves. On a map of 800k entries an op then
+		// costs 0.8-0.9x operator[]/erase for batches of 100 to 100k ops and 0.6x for 1M
+		// (bench/apply_batch.cpp).
+		// Any random access range of elements with key, value and erase members will do.
+		// Throws std::invalid_argument on unsorted input, before changing anything; if an
+		// insert throws, the ops before it stay applied.
+		template <class RandomAccessIterator>
+		void apply_batch (RandomAccessIterator first, RandomAccessIterator last) {
+			try { _tree.applyBatch(first, last - first, 0); }
+			catch (...) { filterRebuild(); throw ; }
+			filterBatch(first, last);
+		}
+
+		// the same, writing one bool per op to out: true for an insert or an erase that removed
+		// something, false for an update in place or an erase of a missing key
+		template <class RandomAccessIterator, class OutputIterator>
+		OutputIterator apply_batch (RandomAccessIterator first, RandomAccessIterator last, OutputIterator out) {
+			ft::vector<char> results(last - first, 0);
+
+			try { _tree.applyBatch(first, last - first, results.data()); }
+			catch (...) { filterRebuild(); throw ; }
+			filterBatch(first, last);
+			for (size_t i = 0; i < results.size(); ++i)
+				*out++ = results[i] != 0;
+			return (out);
+		}
+
+		// moves the elements whose keys are not here yet out of source; the rest stay there
+		void merge (map& source) {
+			size_type before = source.size();
+
+			if (this == &source)
+				return ;
+			filterAddAll(source); // the keys that stay in source too
+			_tree.mergeFrom(source._tree);
+			source.filterErase(before - source.size());
+			filterCheck();
+		}
+		void merge (map&& source) { merge(source); }
+#endif
+
+		// replaces the contents with [first, last) in O(n); the keys must be strictly increasing
+		// (std::invalid_argument otherwise, and the map is left empty)
+		template <class InputIterator>
+		void assign_sorted (InputIterator first, InputIterator last) {
+			_tree.buildSorted(first, last);
+			filterRebuild();
+		}
+
+		// Bulk load of unsorted input: sorts a copy on up to `threads` threads (0: one per CPU),
+		// keeps the first of equal keys and the present value of keys already in the map, as
+		// insert does, then rebuilds the tree in O(n) with the nodes allocated in key order.
+		template <class InputIterator>
+		void bulk_insert (InputIterator first, InputIterator last, unsigned threads = 0){
+			ft::vector<entry>	in;
+			ft::vector<entry>	out;
+			map					built(_comp, _alloc);
+			const_iterator		it = begin();
+			size_t				n = 0;
+
+			for (; first != last; ++first)
+				in.push_back(entry(first->first, first->second));
+			ft::parallel_stable_sort(in.data(), in.size(), entryLess(_comp), threads);
+			if (empty()){ // dedupe in place
+				for (size_t i = 0; i < in.size(); ++i)
+					if (n == 0 || _comp(in[n - 1].first, in[i].first))
+						in[n++] = in[i];
+				built._tree.buildSorted(in.data(), in.data() + n);
+				_tree.swap(built._tree);
+				filterRebuild();
+				return ;}
+			out.reserve(size() + in.size());
+			for (size_t i = 0; i < in.size(); ++i){
+				if (i && !_comp(in[i - 1].first, in[i].first))
+					continue ;
+				for (; it != end() && _comp(it->first, in[i].first); ++it)
+					out.push_back(entry(it->first, it->second));
+				if (it == end() || _comp(in[i].first, it->first))
+					out.push_back(in[i]);
+			}
+			for (; it != end(); ++it)
+				out.push_back(entry(it->first, it->second));
+			ft::vector<entry>().swap(in);
+			built._tree.buildSorted(out.data(), out.data() + out.size());
+			_tree.swap(built._tree);
+			filterRebuild();
 		}
 
-		void erase (iterator position)	{ _tree.rbTreeDelete(position.base());}
+		void erase (iterator position)	{
+			_tree.rbTreeDelete(position.base());
+			filterErase(1);}
 		
 		size_type erase (const key_type& k){
-			node<value_type>* rmNode = _tree.treeSearch(k);
-			if (rmNode != end()){
+			node_type* rmNode = search(k);
+			if (rmNode != _tree.end()){
 				_tree.rbTreeDelete(rmNode);
+				filterErase(1);
 				return 1;}
 			else
 				return 0;
 		}
 
-		void erase (iterator first, iterator last)
-		{
-			iterator it = first;
+		void erase (iterator first, iterator last) {
+			size_type before = size();
 
-			while (first != last){
-				it = first.next();
-				_tree.rbTreeDelete(first.base());
-				first = it;}
+			_tree.eraseRange(first.base(), last.base());
+			filterErase(before - size());
 		}
 
-		void swap (map& x){	std::swap(x, *this); }
+		void swap (map& x){
+			std::swap(_comp, x._comp);
+			std::swap(_alloc, x._alloc);
+			_tree.swap(x._tree);
+			_filter.swap(x._filter); }
+
+		void clear(){
+			_tree.clear();
+			_filter.reset(0);}
+
+		// moves every node into one contiguous block in key order, for maps whose nodes have
+		// been scattered by churn (a map of a few hundred nodes or fewer is reallocated node by
+		// node in key order instead); O(n), invalidates iterators
+		void compact() { _tree.compact(); }
+
+		// Split and set operations (join-based, iterators to moved elements are invalidated)
+
+		// moves the elements with key >= k into greater, replacing its contents
+		void split (const key_type& k, map& greater){
+			size_type before = size();
+
+			_tree.splitTo(k, greater._tree);
+			filterErase(before - size());
+			greater.filterRebuild();
+		}
 
-		void clear(){ _tree.clear();}
+		// moves [first, last) into out, replacing its contents
+		void extract_range (iterator first, iterator last, map& out){
+			size_type before = size();
+
+			_tree.extractRange(first.base(), last.base(), out._tree);
+			filterErase(before - size());
+			out.filterRebuild();
+		}
+
+		// moves all elements of x into this map, on equal keys this map's value is kept; x is left empty
+		void set_union (map& x){
+			if (this == &x)
+				return ;
+			filterAddAll(x);
+			_tree.unite(x._tree);
+			x._filter.reset(0);
+			filterCheck();
+		}
+
+		// keeps only the keys also present in x
+		void set_intersection (const map& x){
+			size_type before = size();
+
+			if (this != &x){
+				_tree.intersect(x._tree);
+				filterErase(before - size());}
+		}
+
+		// erases the keys present in x
+		void set_difference (const map& x){
+			size_type before = size();
+
+			if (this == &x){
+				clear();
+				return ;}
+			_tree.subtract(x._tree);
+			filterErase(before - size());
+		}
 
 		// Lookup
-		iterator find (const key_type& k) {	return (iterator(_tree.treeSearch(k)));	}
+		iterator find (const key_type& k) {	return (_tree.iter(search(k)));	}
+
+		const_iterator find (const key_type& k) const {	return const_iterator(_tree.iter(search(k)));	}
+
+		// Finger lookups: the search starts at hint, typically the result of the previous one,
+		// and climbs to the lowest ancestor whose range holds k, O(log d) for a distance d.
+		// Only worth it on ordered streams: the top of the tree is cached anyway, so on
+		// clustered or random keys the climb makes these slower than find(k) (bench/finger_search)
+		iterator find (iterator hint, const key_type& k) { return (_tree.iter(_tree.searchFrom(hint.base(), k))); }
+
+		const_iterator find (const_iterator hint, const key_type& k) const { return const_iterator(_tree.iter(_tree.searchFrom(hint.base(), k))); }
 
-		const_iterator find (const key_type& k) const {	return const_iterator(iterator(_tree.treeSearch(k)));	}
+		iterator lower_bound (iterator hint, const key_type& k) { return (_tree.iter(_tree.lowerBoundFrom(hint.base(), k))); }
+
+		const_iterator lower_bound (const_iterator hint, const key_type& k) const { return const_iterator(_tree.iter(_tree.lowerBoundFrom(hint.base(), k))); }
 
 
 		size_type count (const key_type& k) const {
-			if (find(k) == end())
+			if (search(k) == _tree.end())
 				return 0;
 			return 1; };
 
-		iterator lower_bound (const key_type& k) { return (_tree.lower_bound(k)); };
+		// Batched lookup over a forward range of keys: the searches of up to 16 keys advance
+		// in lockstep so their memory latency overlaps (see tree::searchBatch).
+		// find_batch writes one iterator per key to out, end() for a missing key.
+		template <class KeyIterator, class OutputIterator>
+		OutputIterator find_batch (KeyIterator keys_first, KeyIterator keys_last, OutputIterator out) {
+			batchFind<OutputIterator, iterator> visit(out, _tree);
+
+			_tree.searchBatch(keys_first, keys_last, visit);
+			return (visit.out);
+		}
+
+		template <class KeyIterator, class OutputIterator>
+		OutputIterator find_batch (KeyIterator keys_first, KeyIterator keys_last, OutputIterator out) const {
+			batchFind<OutputIterator, const_iterator> visit(out, _tree);
 
-		const_iterator lower_bound (const key_type& k) const { return (_tree.lower_bound(k));};
+			_tree.searchBatch(keys_first, keys_last, visit);
+			return (visit.out);
+		}
+
+		// number of keys of the range that are in the map
+		template <class KeyIterator>
+		size_type count_batch (KeyIterator keys_first, KeyIterator keys_last) const {
+			batchCount visit(_tree.end());
+
+			_tree.searchBatch(keys_first, keys_last, visit);
+			return (visit.n);
+		}
+
+		iterator lower_bound (const key_type& k) { return (_tree.iter(_tree.lower_bound(k))); };
 
-		iterator upper_bound (const key_type& k) { return (_tree.upper_bound(k)); };
+		const_iterator lower_bound (const key_type& k) const { return const_iterator(_tree.iter(_tree.lower_bound(k)));};
 
-		const_iterator upper_bound (const key_type& k) const  { return (_tree.upper_bound(k)); };
+		iterator upper_bound (const key_type& k) { return (_tree.iter(_tree.upper_bound(k))); };
+
+		const_iterator upper_bound (const key_type& k) const  { return const_iterator(_tree.iter(_tree.upper_bound(k))); };
 
 		pair<iterator,iterator> equal_range (const key_type& k) {return (_tree.equal_range_unique(k)); };
 			
 		pair<const_iterator,const_iterator> equal_range (const key_type& k) const {return (_tree.equal_range_unique(k)); };
 
-		allocator_type get_allocator() const { return allocator_type(_tree._alloc());};
+		// Order statistics (Augment = ft::order_statistics or ft::range_aggregate), O(log n)
+
+		// the element at index n in key order, end() when n >= size()
+		iterator nth (size_type n) { return (_tree.iter(_tree.select(n))); };
+
+		const_iterator nth (size_type n) const { return const_iterator(_tree.iter(_tree.select(n))); };
+
+		// number of keys less than k
+		size_type rank (const key_type& k) const { return (_tree.rank(k)); };
+
+		// index of an element in key order, size() for end()
+		size_type index_of (const_iterator it) const { return (_tree.position(it.base())); };
+
+		// Membership filter (Filter = ft::bloom_filter)
+
+		// resizes the filter for bits per key (10 by default) and rebuilds it, O(n)
+		void filter_bits_per_key (size_type bits) {
+			_filter.bitsPerKey(bits);
+			filterRebuild();
+		}
+
+		// lookups asked, rejected by the filter alone, false positives; all zero with no filter
+		ft::filter_stats filter_stats () const { return (_filter.stats()); }
+
+		difference_type distance (const_iterator first, const_iterator last) const {
+			return (static_cast<difference_type>(index_of(last)) - static_cast<difference_type>(index_of(first))); };
+
+		// Range aggregates (Augment = ft::range_aggregate<T>): summary of the keys in [lo, hi), O(log n)
+		summary_type aggregate (const key_type& lo, const key_type& hi) const { return (_tree.aggregate(lo, hi)); };
+
+		// the summaries see mapped values, call after changing one in place through an iterator
+		// or the reference operator[] returns (a new key is summarized with mapped_type())
+		void refresh (iterator position) { _tree.augmentPath(position.base()); };
+
+		// read-only copy in Eytzinger layout, for lookup-heavy phases once the map stops changing
+		frozen_map<Key, T, Compare, Allocator> freeze() const { return (frozen_map<Key, T, Compare, Allocator>(begin(), end(), _comp)); };
+
+		allocator_type get_allocator() const { return (_alloc); };
 
 		// Observers
 		key_compare key_comp() const{ return (_comp); }; //возвращает компаратор типа, переданнного как шаблон в мапу
@@ -227,11 +632,107 @@ namespace ft
 		
 		friend bool	operator >= (const map& x, const map& y){ return !(x < y); };
 
-		//print tree
+	private:
+		typedef ft::pair<key_type, mapped_type>		entry;
+
+		struct entryLess
+		{
+			key_compare comp;
+
+			entryLess(const key_compare& c): comp(c) {}
+			bool operator()(const entry& x, const entry& y) const { return comp(x.first, y.first); }
+		};
+
+		template <class OutputIterator, class Iterator>
+		struct batchFind
+		{
+			OutputIterator		out;
+			const tree_type&	t;
+
+			batchFind(OutputIterator o, const tree_type& tr): out(o), t(tr) {}
+			void operator()(node_type* x) { *out++ = Iterator(t.iter(x)); }
+		};
+
+		// the tree search of find, count and erase, once the filter lets k through
+		node_type* search(const key_type& k) const {
+			node_type* x;
+
+			if (!_filter.mayContain(k))
+				return (_tree.end());
+			x = _tree.treeSearch(k);
+			if (x == _tree.end())
+				_filter.missed();
+			return (x);
+		}
+
+		void filterAdd(const key_type& k) {
+			_filter.add(k);
+			filterCheck();
+		}
+
+		void filterErase(size_type n) {
+			_filter.erased(n);
+			filterCheck();
+		}
+
+		void filterCheck() {
+			if (_filter.rebuildDue())
+				filterRebuild();
+		}
+
+		void filterRebuild() {
+			if (!Filter::enabled)
+				return ;
+			_filter.reset(size());
+			for (const_iterator it = begin(); it != end(); ++it)
+				_filter.add(it->first);
+		}
+
+		// adds x's keys without a rebuild in between (it would lose them): the caller checks
+		// once its tree holds them
+		void filterAddAll(const map& x) {
+			if (!Filter::enabled)
+				return ;
+			for (const_iterator it = x.begin(); it != x.end(); ++it)
+				_filter.add(it->first);
+		}
+
+		// after apply_batch: every upserted key goes in, updates too
+		template <class RandomAccessIterator>
+		void filterBatch(RandomAccessIterator first, RandomAccessIterator last) {
+			size_type erased = 0;
+
+			if (!Filter::enabled)
+				return ;
+			for (; first != last; ++first){
+				if (first->erase)
+					++erased;
+				else
+					_filter.add(first->key);}
+			_filter.erased(erased);
+			filterCheck();
+		}
+
+		struct batchCount
+		{
+			size_type	n;
+			node_type*	nil;
+
+			batchCount(node_type* end): n(0), nil(end) {}
+			void operator()(node_type* x) { n += (x != nil); }
+		};
+
+				//print tree
 		// void printTree(){ _tree.printTree(); }
 
 	};
 
+	template <class Key, class T, class Compare, class Allocator, class Augment, class Layout, class Balance, class Filter>
+	void swap (map<Key, T, Compare, Allocator, Augment, Layout, Balance, Filter>& x, map<Key, T, Compare, Allocator, Augment, Layout, Balance, Filter>& y)
+	{
+		x.swap(y);
+	}
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,117 @@
+#ifndef PARALLEL_SORT_HPP
+#define PARALLEL_SORT_HPP
+
+#include <algorithm>
+#include <stdexcept>
+#include <pthread.h>
+#include <unistd.h>
+#include "vector.hpp"
+
+namespace ft
+{
+	// one piece of a parallel sort: sorts [first, mid), or merges [first, mid) and [mid, last) into out
+	template <class T, class Compare>
+	struct sortTask
+	{
+		T*			first;
+		T*			mid;
+		T*			last;
+		T*			out;
+		Compare		comp;
+		bool		failed;
+
+		sortTask(T* f, T* m, T* l, T* o, Compare c): first(f), mid(m), last(l), out(o), comp(c), failed(false) {}
+
+		void run() {
+			try {
+				if (out == 0)
+					std::stable_sort(first, mid, comp);
+				else
+					std::merge(first, mid, mid, last, out, comp);
+			}
+			catch (...) { failed = true; } // an exception must not leave the thread
+		}
+
+		static void* start(void* task) { static_cast<sortTask*>(task)->run(); return (0); }
+	};
+
+	// runs the tasks, task 0 on the calling thread
+	template <class T, class Compare>
+	void runSortTasks(ft::vector<sortTask<T, Compare> >& tasks)
+	{
+		typedef sortTask<T, Compare>	task;
+		ft::vector<pthread_t>			ids(tasks.size());
+		ft::vector<char>				started(tasks.size(), 0);
+		bool							failed = false;
+
+		for (size_t i = 1; i < tasks.size(); ++i)
+			started[i] = pthread_create(&ids[i], 0, &task::start, &tasks[i]) == 0;
+		for (size_t i = 0; i < tasks.size(); ++i)
+			if (i == 0 || !started[i]) // no thread to spare: do it here
+				tasks[i].run();
+		for (size_t i = 0; i < tasks.size(); ++i){
+			if (started[i])
+				pthread_join(ids[i], 0);
+			failed = failed || tasks[i].failed;}
+		if (failed)
+			throw std::runtime_error("ft::parallel_stable_sort: a sort task failed");
+	}
+
+	inline unsigned hardwareThreads()
+	{
+		long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+		return (n > 0 ? static_cast<unsigned>(n) : 1);
+	}
+
+	// Stable sort of data[0, n) on up to `threads` threads (0: one per online CPU): each thread
+	// sorts a slice, then slices are merged pairwise, one round per doubling, until one is left.
+	// Ranges too small to be worth a thread are sorted in place on the caller.
+	template <class T, class Compare>
+	void parallel_stable_sort(T* data, size_t n, Compare comp, unsigned threads = 0)
+	{
+		typedef sortTask<T, Compare>	task;
+		const size_t					minSlice = 1 << 15;
+		size_t							slices;
+		ft::vector<size_t>				bound;
+		ft::vector<task>				tasks;
+
+		if (threads == 0)
+			threads = hardwareThreads();
+		slices = n / minSlice < threads ? n / minSlice : threads;
+		if (slices <= 1){
+			std::stable_sort(data, data + n, comp);
+			return ;}
+		for (size_t i = 0; i <= slices; ++i)
+			bound.push_back(n / slices * i + (i == slices ? n % slices : 0));
+		for (size_t i = 0; i < slices; ++i)
+			tasks.push_back(task(data + bound[i], data + bound[i + 1], 0, 0, comp));
+		runSortTasks(tasks);
+
+		ft::vector<T>	buf(data, data + n);
+		T*				from = data;
+		T*				to = buf.data();
+
+		while (bound.size() > 2){ // merge neighbouring runs; an odd last run is copied across
+			ft::vector<size_t> next;
+
+			tasks.clear();
+			for (size_t i = 0; i + 1 < bound.size(); i += 2){
+				next.push_back(bound[i]);
+				if (i + 2 >= bound.size()){
+					std::copy(from + bound[i], from + bound[i + 1], to + bound[i]);
+					break ;}
+				tasks.push_back(task(from + bound[i], from + bound[i + 1], from + bound[i + 2], to + bound[i], comp));
+			}
+			next.push_back(n);
+			runSortTasks(tasks);
+			bound.swap(next);
+			std::swap(from, to);
+		}
+		if (from != data)
+			std::copy(from, from + n, data);
+	}
+
+}
+
+#endif
@@ -0,0 +1,634 @@
+#ifndef PERSISTENT_MAP_HPP
+#define PERSISTENT_MAP_HPP
+
+#include <memory>
+#include <functional>
+#include <utility>
+#include <stdexcept>
+#include "utils.hpp"
+#include "iterator.hpp"
+#include "vector.hpp"
+
+namespace ft
+{
+	// A node may be shared by any number of versions, so it has no parent link.
+	// refs counts the links and versions pointing at it; a node with refs == 1 belongs to
+	// the one version that reaches it and may be changed in place.
+	template <class Value>
+	struct persistentNode
+	{
+		size_t				refs;
+		persistentNode*		left;
+		persistentNode*		right;
+		bool				red;
+		Value				keyValue;
+
+		persistentNode(const Value& v): refs(1), left(0), right(0), red(true), keyValue(v){};
+	};
+
+	// without parent links the iterator carries its path from the root
+	template <class Node, class Value>
+	class persistentIterator
+	{
+		public:
+			typedef Value							value_type;
+			typedef const Value&					reference;
+			typedef const Value*					pointer;
+			typedef bidirectional_iterator_tag		iterator_category;
+			typedef ptrdiff_t						difference_type;
+
+			// red-black height is at most 2 log2(n + 1)
+			static const int maxDepth = 2 * sizeof(size_t) * 8;
+
+		private:
+			const Node*		_root;
+			const Node*		_path[maxDepth];
+			int				_depth;		// _path[_depth - 1] is the current node, 0 is end()
+
+		public:
+			persistentIterator(const Node* root = 0): _root(root), _depth(0){};
+
+			persistentIterator(const persistentIterator& cp): _root(cp._root), _depth(cp._depth) {
+				for (int i = 0; i < _depth; ++i)
+					_path[i] = cp._path[i]; };
+
+			persistentIterator& operator=(const persistentIterator& cp) {
+				_root = cp._root;
+				_depth = cp._depth;
+				for (int i = 0; i < _depth; ++i)
+					_path[i] = cp._path[i];
+				return (*this); }
+
+			const Node* base() const { return (_depth ? _path[_depth - 1] : 0); }
+
+			// building blocks for the map's searches
+			void push(const Node* x) { _path[_depth++] = x; }
+			void cut(int depth) { _depth = depth; }
+			int depth() const { return (_depth); }
+
+			void pushMin(const Node* x) {
+				for (; x; x = x->left)
+					push(x); }
+
+			void pushMax(const Node* x) {
+				for (; x; x = x->right)
+					push(x); }
+
+			reference operator*() const { return (_path[_depth - 1]->keyValue); }
+			pointer operator->() const { return (&_path[_depth - 1]->keyValue); }
+
+			persistentIterator& operator++() {
+				const Node* x = _path[--_depth];
+
+				if (x->right){
+					push(x);
+					pushMin(x->right);
+					return (*this);}
+				while (_depth && _path[_depth - 1]->right == x)
+					x = _path[--_depth];
+				return (*this);
+			}
+
+			persistentIterator operator++(int) { persistentIterator tmp(*this); ++(*this); return tmp; }
+
+			persistentIterator& operator--() {
+				const Node* x;
+
+				if (_depth == 0){
+					pushMax(_root);
+					return (*this);}
+				x = _path[--_depth];
+				if (x->left){
+					push(x);
+					pushMax(x->left);
+					return (*this);}
+				while (_depth && _path[_depth - 1]->left == x)
+					x = _path[--_depth];
+				return (*this);
+			}
+
+			persistentIterator operator--(int) { persistentIterator tmp(*this); --(*this); return tmp; }
+
+			bool operator==(const persistentIterator& it) const { return (base() == it.base()); }
+			bool operator!=(const persistentIterator& it) const { return !(*this == it); }
+	};
+
+
+	// Persistent ordered map: copies share the whole tree, so copying (and snapshot()) is
+	// O(1), and an update copies only the nodes on and next to its search path that another
+	// version still shares (left-leaning red-black tree, top-down path copying). An update
+	// that throws leaves the map as it was.
+	// One thread may update a map while others read snapshots of it without locks; the
+	// reference counts are atomic, everything else in a shared node is never written.
+	// Iterators are valid while the version they came from is neither changed nor destroyed.
+	template <class Key, class T, class Compare = std::less<Key>, class Allocator = std::allocator<pair<const Key, T> > >
+	class persistent_map
+	{
+
+	public:
+		typedef Key																key_type;
+		typedef T																mapped_type;
+		typedef ft::pair<const key_type, mapped_type>							value_type;
+		typedef Compare															key_compare;
+		typedef Allocator														allocator_type;
+		typedef size_t															size_type;
+		typedef ptrdiff_t														difference_type;
+		typedef const value_type&												reference;
+		typedef const value_type&												const_reference;
+
+	private:
+		typedef persistentNode<value_type>										node;
+		typedef typename Allocator::template rebind<node>::other				allocatorNode;
+
+	public:
+		// shared nodes are never handed out for writing
+		typedef ft::persistentIterator<node, value_type>						const_iterator;
+		typedef const_iterator													iterator;
+		typedef ft::reverse_iterator<const_iterator>							const_reverse_iterator;
+		typedef const_reverse_iterator											reverse_iterator;
+
+		class value_compare : public std::binary_function<value_type, value_type, bool>
+		{
+			friend class persistent_map;
+		protected:
+			Compare comp;
+			value_compare(Compare c) : comp(c) {}
+
+		public:
+			bool operator() (const value_type& x, const value_type& y) const
+			{ return comp(x.first, y.first); }
+		};
+
+	private:
+		key_compare			_comp;
+		allocatorNode		_alloc;
+		node*				_root;
+		size_type			_size;
+
+	public:
+
+		explicit persistent_map (const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type()):
+			_comp(comp), _alloc(alloc), _root(0), _size(0) {};
+
+		template <class InputIterator>
+			persistent_map (InputIterator first, InputIterator last, const key_compare& comp = key_compare(),
+			const allocator_type& alloc = allocator_type()):
+			_comp(comp), _alloc(alloc), _root(0), _size(0)
+		{ insert(first, last); };
+
+		// O(1): the copy shares every node
+		persistent_map(const persistent_map& x): _comp(x._comp), _alloc(x._alloc), _root(x._root), _size(x._size) { retain(_root); };
+
+		persistent_map &operator=(const persistent_map& x) {
+			retain(x._root);
+			release(_root);
+			_comp = x._comp;
+			_root = x._root;
+			_size = x._size;
+			return *this;
+		};
+
+		~persistent_map(){ release(_root); };
+
+		// the current contents as an independent version, O(1); later updates to either
+		// side copy what they touch and are not seen by the other
+		persistent_map snapshot() const { return (*this); }
+
+		// Iterators
+		const_iterator begin() const {
+			const_iterator it(_root);
+
+			it.pushMin(_root);
+			return (it); };
+
+		const_iterator end() const { return (const_iterator(_root)); };
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); };
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); };
+
+		// Capacity
+		bool empty() const { return (_size == 0); };
+		size_type size() const { return (_size); };
+		size_type max_size() const { return (_alloc.max_size()); };
+
+		// Element access
+		const mapped_type& at (const key_type& k) const {
+			const node* x = search(k);
+
+			if (!x)
+				throw std::out_of_range("");
+			return (x->keyValue.second);
+		}
+
+		// Modifiers: each copies the shared part of one search path and its neighbours
+		ft::pair<const_iterator, bool> insert(const value_type& v) {
+			if (search(v.first))
+				return (ft::make_pair(find(v.first), false));
+			ownPath(v.first, false);
+			_root = insertAt(_root, v);
+			_root->red = false;
+			++_size;
+			return (ft::make_pair(find(v.first), true));
+		}
+
+		const_iterator insert (const_iterator position, const value_type& val) {
+			(void)position;
+			return (insert(val).first);
+		}
+
+		template <class InputIterator>
+		void insert (InputIterator first, InputIterator last) {
+			for (; first != last; ++first)
+				insert(value_type(first->first, first->second));
+		}
+
+		// true when k was inserted, false when its value was replaced
+		bool insert_or_assign (const key_type& k, const mapped_type& v) {
+			if (!search(k)){
+				insert(value_type(k, v));
+				return (true);}
+			ownPath(k, false);
+			_root = assignAt(_root, k, v);
+			return (false);
+		}
+
+		size_type erase (const key_type& k) {
+			if (!search(k))
+				return (0);
+			ownPath(k, true);
+			_root = own(_root);
+			if (!isRed(_root->left) && !isRed(_root->right))
+				_root->red = true;
+			_root = eraseAt(_root, k);
+			if (_root)
+				_root->red = false;
+			--_size;
+			return (1);
+		}
+
+		void erase (const_iterator position) { erase(position->first); }
+
+		// each erase may copy or free nodes on the iterators' paths, so the keys go first
+		void erase (const_iterator first, const_iterator last) {
+			ft::vector<key_type> keys;
+
+			if (first == begin() && last == end()){
+				clear();
+				return ;}
+			for (; first != last; ++first)
+				keys.push_back(first->first);
+			for (size_type i = 0; i < keys.size(); ++i)
+				erase(keys[i]);
+		}
+
+		void swap (persistent_map& x) {
+			std::swap(_comp, x._comp);
+			std::swap(_alloc, x._alloc);
+			std::swap(_root, x._root);
+			std::swap(_size, x._size);
+		}
+
+		void clear() {
+			release(_root);
+			_root = 0;
+			_size = 0;
+		}
+
+		// Lookup
+		const_iterator find (const key_type& k) const {
+			const_iterator	it(_root);
+			const node*		x = _root;
+
+			while (x){
+				it.push(x);
+				if (_comp(k, x->keyValue.first))
+					x = x->left;
+				else if (_comp(x->keyValue.first, k))
+					x = x->right;
+				else
+					return (it);
+			}
+			return (end());
+		}
+
+		size_type count (const key_type& k) const { return (search(k) ? 1 : 0); }
+
+		// the path is cut back to the last node that qualified
+		const_iterator lower_bound (const key_type& k) const {
+			const_iterator	it(_root);
+			const node*		x = _root;
+			int				hit = 0;
+
+			while (x){
+				it.push(x);
+				if (_comp(x->keyValue.first, k))
+					x = x->right;
+				else {
+					hit = it.depth();
+					x = x->left;}
+			}
+			it.cut(hit);
+			return (it);
+		}
+
+		const_iterator upper_bound (const key_type& k) const {
+			const_iterator	it(_root);
+			const node*		x = _root;
+			int				hit = 0;
+
+			while (x){
+				it.push(x);
+				if (!_comp(k, x->keyValue.first))
+					x = x->right;
+				else {
+					hit = it.depth();
+					x = x->left;}
+			}
+			it.cut(hit);
+			return (it);
+		}
+
+		pair<const_iterator, const_iterator> equal_range (const key_type& k) const {
+			return (ft::make_pair(lower_bound(k), upper_bound(k)));
+		}
+
+		allocator_type get_allocator() const { return (allocator_type(_alloc)); };
+
+		// Observers
+		key_compare key_comp() const { return (_comp); };
+		value_compare value_comp() const { return value_compare(key_comp()); }
+
+		// Non-member functions:
+		friend bool	operator == (const persistent_map& x, const persistent_map& y){
+			if (x.size() != y.size())
+				return false;
+			if (x._root == y._root)
+				return true;
+			return (ft::equal(x.begin(), x.end(), y.begin()));
+		};
+
+		friend bool	operator != (const persistent_map& x, const persistent_map& y){ return !(x == y); };
+
+		friend bool	operator < (const persistent_map& x, const persistent_map& y){
+			const_iterator itx = x.begin();
+			const_iterator ity = y.begin();
+
+			for (; itx != x.end() && ity != y.end(); ++itx, ++ity) {
+				if (itx->first != ity->first)
+					return (itx->first < ity->first);
+				else if (itx->second != ity->second)
+					return (itx->second < ity->second);
+			}
+			return (x.size() < y.size());
+		};
+
+		friend bool	operator > (const persistent_map& x, const persistent_map& y){ return (y < x); };
+		friend bool	operator <= (const persistent_map& x, const persistent_map& y){ return !(y < x); };
+		friend bool	operator >= (const persistent_map& x, const persistent_map& y){ return !(x < y); };
+
+	private:
+		const node* search(const key_type& k) const {
+			const node* x = _root;
+
+			while (x){
+				if (_comp(k, x->keyValue.first))
+					x = x->left;
+				else if (_comp(x->keyValue.first, k))
+					x = x->right;
+				else
+					return (x);
+			}
+			return (0);
+		}
+
+		// Reference counts. Readers on other threads drop their versions concurrently, so the
+		// counts are updated atomically and the last owner frees the node.
+		static void retain(node* x) {
+			if (x)
+				__atomic_add_fetch(&x->refs, 1, __ATOMIC_RELAXED);
+		}
+
+		void release(node* x) {
+			if (x && __atomic_sub_fetch(&x->refs, 1, __ATOMIC_ACQ_REL) == 0){
+				release(x->left);
+				release(x->right);
+				destroy(x);}
+		}
+
+		static bool shared(const node* x) { return (__atomic_load_n(&x->refs, __ATOMIC_ACQUIRE) > 1); }
+
+		node* create(const value_type& v) {
+			node* x = _alloc.allocate(1);
+
+			try { _alloc.construct(x, node(v)); }
+			catch (...) { _alloc.deallocate(x, 1); throw ; }
+			return (x);
+		}
+
+		void destroy(node* x) {
+			_alloc.destroy(x);
+			_alloc.deallocate(x, 1);
+		}
+
+		// a private copy of x for this version, holding its own counts on x's children
+		node* copyOf(const node* x) {
+			node* c = create(x->keyValue);
+
+			c->left = x->left;
+			c->right = x->right;
+			c->red = x->red;
+			retain(c->left);
+			retain(c->right);
+			return (c);
+		}
+
+		// the node to write through: x itself when this version owns it alone, else a copy
+		// that takes over this version's link (x stays with the versions still sharing it)
+		node* own(node* x) {
+			node* c;
+
+			if (!shared(x))
+				return (x);
+			c = copyOf(x);
+			release(x);
+			return (c);
+		}
+
+		// own() for the node behind a link: the copy is in the link before x is released
+		void adopt(node** link) {
+			node* x = *link;
+
+			if (!x || !shared(x))
+				return ;
+			*link = copyOf(x);
+			release(x);
+		}
+
+		// Before an update writes anything, every node it may write is made owned: k's search
+		// path and both children of each node on it, and for an erase also the path on to k's
+		// successor and the grandchildren the red moves and fix-ups rotate in (left-left,
+		// left-right, right-left, left-right-left). The shape, colors and contents stay the
+		// same meanwhile, so if an allocation or a value copy throws, the map is still valid
+		// and holds its counts. The rebalancing that follows finds every node owned and
+		// allocates nothing but the new node of an insert, made before anything is linked.
+		void ownPath(const key_type& k, bool erasing) {
+			node**	link = &_root;
+			bool	found = false;
+			node*	h;
+
+			while (*link){
+				adopt(link);
+				h = *link;
+				adopt(&h->left);
+				adopt(&h->right);
+				if (erasing && h->left){
+					adopt(&h->left->left);
+					adopt(&h->left->right);
+					if (h->left->right)
+						adopt(&h->left->right->left);}
+				if (erasing && h->right)
+					adopt(&h->right->left);
+				if (found || _comp(k, h->keyValue.first))
+					link = &h->left;
+				else if (_comp(h->keyValue.first, k))
+					link = &h->right;
+				else if (erasing){
+					found = true;
+					link = &h->right;}
+				else
+					return ;
+			}
+		}
+
+		// Left-leaning red-black tree (Sedgewick). Every node passed in is owned already,
+		// a child is owned before it is written.
+		static bool isRed(const node* x) { return (x && x->red); }
+
+		node* rotateLeft(node* h) {
+			node* x = own(h->right);
+
+			h->right = x->left;
+			x->left = h;
+			x->red = h->red;
+			h->red = true;
+			return (x);
+		}
+
+		node* rotateRight(node* h) {
+			node* x = own(h->left);
+
+			h->left = x->right;
+			x->right = h;
+			x->red = h->red;
+			h->red = true;
+			return (x);
+		}
+
+		void flipColors(node* h) {
+			h->left = own(h->left);
+			h->right = own(h->right);
+			h->red = !h->red;
+			h->left->red = !h->left->red;
+			h->right->red = !h->right->red;
+		}
+
+		node* fixUp(node* h) {
+			if (isRed(h->right) && !isRed(h->left))
+				h = rotateLeft(h);
+			if (isRed(h->left) && isRed(h->left->left))
+				h = rotateRight(h);
+			if (isRed(h->left) && isRed(h->right))
+				flipColors(h);
+			return (h);
+		}
+
+		node* moveRedLeft(node* h) {
+			flipColors(h);
+			if (isRed(h->right->left)){
+				h->right = rotateRight(h->right);
+				h = rotateLeft(h);
+				flipColors(h);}
+			return (h);
+		}
+
+		node* moveRedRight(node* h) {
+			flipColors(h);
+			if (isRed(h->left->left)){
+				h = rotateRight(h);
+				flipColors(h);}
+			return (h);
+		}
+
+		// v's key is known to be absent
+		node* insertAt(node* h, const value_type& v) {
+			if (!h)
+				return (create(v));
+			h = own(h);
+			if (_comp(v.first, h->keyValue.first))
+				h->left = insertAt(h->left, v);
+			else
+				h->right = insertAt(h->right, v);
+			return (fixUp(h));
+		}
+
+		// k is known to be present; the shape does not change
+		node* assignAt(node* h, const key_type& k, const mapped_type& v) {
+			h = own(h);
+			if (_comp(k, h->keyValue.first))
+				h->left = assignAt(h->left, k, v);
+			else if (_comp(h->keyValue.first, k))
+				h->right = assignAt(h->right, k, v);
+			else
+				h->keyValue.second = v;
+			return (h);
+		}
+
+		// h is owned; its minimum is moved into *min instead of being freed
+		node* eraseMin(node* h, node** min) {
+			if (!h->left){
+				*min = h;
+				return (0);}
+			if (!isRed(h->left) && !isRed(h->left->left))
+				h = moveRedLeft(h);
+			h->left = eraseMin(own(h->left), min);
+			return (fixUp(h));
+		}
+
+		// h is owned and k is known to be present below it
+		node* eraseAt(node* h, const key_type& k) {
+			node* min;
+
+			if (_comp(k, h->keyValue.first)){
+				if (!isRed(h->left) && !isRed(h->left->left))
+					h = moveRedLeft(h);
+				h->left = eraseAt(own(h->left), k);
+				return (fixUp(h));}
+			if (isRed(h->left))
+				h = rotateRight(h);
+			if (!_comp(h->keyValue.first, k) && !h->right){
+				destroy(h);
+				return (0);}
+			if (!isRed(h->right) && !isRed(h->right->left))
+				h = moveRedRight(h);
+			if (_comp(h->keyValue.first, k)){
+				h->right = eraseAt(own(h->right), k);
+				return (fixUp(h));}
+			// the key is const in the node, so the successor node itself takes h's place
+			h->right = eraseMin(own(h->right), &min);
+			min->left = h->left;
+			min->right = h->right;
+			min->red = h->red;
+			destroy(h);
+			return (fixUp(min));
+		}
+
+	};
+
+	template <class Key, class T, class Compare, class Allocator>
+	void swap (persistent_map<Key, T, Compare, Allocator>& x, persistent_map<Key, T, Compare, Allocator>& y)
+	{
+		x.swap(y);
+	}
+
+}
+
+#endif
@@ -0,0 +1,1050 @@
+#ifndef RADIX_MAP_HPP
+#define RADIX_MAP_HPP
+
+#include <memory>
+#include <new>
+#include <string>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <stdint.h>
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+#include "utils.hpp"
+#include "iterator.hpp"
+
+namespace ft
+{
+	// The bytes of a key, in an order that agrees with std::less: integers big-endian with the
+	// sign bit flipped, std::string as it is (char_traits<char> compares bytes as unsigned).
+	// Other key types have no radixKey and do not compile.
+	template <class Key, bool Integral = is_integral<Key>::value>
+	struct radixKey;
+
+	template <class Key>
+	struct radixKey<Key, true>
+	{
+		unsigned char	bytes[sizeof(Key)];
+
+		explicit radixKey(const Key& k) {
+			uint64_t u = static_cast<uint64_t>(k);
+
+			if (Key(-1) < Key(0))
+				u ^= static_cast<uint64_t>(1) << (sizeof(Key) * 8 - 1);
+			for (size_t i = 0; i < sizeof(Key); ++i)
+				bytes[i] = static_cast<unsigned char>(u >> (8 * (sizeof(Key) - 1 - i)));
+		}
+
+		const unsigned char* data() const { return (bytes); }
+		size_t size() const { return (sizeof(Key)); }
+		unsigned char operator[](size_t i) const { return (bytes[i]); }
+	};
+
+	template <class Alloc>
+	struct radixKey<std::basic_string<char, std::char_traits<char>, Alloc>, false>
+	{
+		const unsigned char*	p;
+		size_t					n;
+
+		explicit radixKey(const std::basic_string<char, std::char_traits<char>, Alloc>& k):
+			p(reinterpret_cast<const unsigned char*>(k.data())), n(k.size()) {}
+
+		const unsigned char* data() const { return (p); }
+		size_t size() const { return (n); }
+		unsigned char operator[](size_t i) const { return (p[i]); }
+	};
+
+	// a leaf is the value alone: iteration finds the neighbours by descending from the root
+	template <class Value>
+	struct radixLeaf
+	{
+		Value	value;
+
+		radixLeaf(const Value& v): value(v) {}
+	};
+
+	enum { radixNode4, radixNode16, radixNode48, radixNode256 };
+
+	// Inner nodes of the adaptive radix tree. A child pointer with bit 0 set is a leaf
+	// (lazy expansion: a lone key hangs as a leaf as high as it can). prefixLen bytes are
+	// skipped before the child byte (path compression); the first radixPrefix of them are
+	// kept in the node, the rest are read from any leaf below. term is the key that ends
+	// right after the prefix, the smallest key of the subtree.
+	struct radixInner
+	{
+		static const size_t	radixPrefix = 8;
+
+		unsigned char	type;
+		unsigned short	count;		// children
+		unsigned int	prefixLen;
+		unsigned char	prefix[radixPrefix];
+		void*			term;		// the leaf, untagged
+
+		radixInner(unsigned char t): type(t), count(0), prefixLen(0), term(0) {}
+	};
+
+	// up to 4 and up to 16 children, child bytes sorted
+	struct radixInner4 : public radixInner
+	{
+		unsigned char	key[4];
+		void*			child[4];
+
+		radixInner4(): radixInner(radixNode4) {}
+	};
+
+	struct radixInner16 : public radixInner
+	{
+		unsigned char	key[16];
+		void*			child[16];
+
+		radixInner16(): radixInner(radixNode16) {}
+	};
+
+	// index[b] is one past the slot of child byte b, 0 when absent
+	struct radixInner48 : public radixInner
+	{
+		unsigned char	index[256];
+		void*			child[48];
+
+		radixInner48(): radixInner(radixNode48) { std::memset(index, 0, sizeof(index)); }
+	};
+
+	struct radixInner256 : public radixInner
+	{
+		void*			child[256];
+
+		radixInner256(): radixInner(radixNode256) { std::memset(child, 0, sizeof(child)); }
+	};
+
+	// Child operations, shared by every radix_map
+
+	inline unsigned char* radixKeys(radixInner* n) {
+		return (n->type == radixNode4 ? static_cast<radixInner4*>(n)->key : static_cast<radixInner16*>(n)->key); }
+
+	inline void** radixChildren(radixInner* n) {
+		return (n->type == radixNode4 ? static_cast<radixInner4*>(n)->child : static_cast<radixInner16*>(n)->child); }
+
+	inline bool radixFull(const radixInner* n) {
+		static const unsigned short capacity[4] = { 4, 16, 48, 256 };
+
+		return (n->count == capacity[n->type]);
+	}
+
+	// the slot holding child b, 0 when absent; node16 compares all 16 bytes at once (SSE2)
+	inline void** radixFind(radixInner* n, unsigned char b) {
+		switch (n->type){
+		case radixNode4: {
+			radixInner4* x = static_cast<radixInner4*>(n);
+			for (unsigned i = 0; i < x->count; ++i)
+				if (x->key[i] == b)
+					return (&x->child[i]);
+			return (0); }
+		case radixNode16: {
+			radixInner16* x = static_cast<radixInner16*>(n);
+		#ifdef __SSE2__
+			unsigned m = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(b)),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(x->key))))) & ((1u << x->count) - 1);
+			return (m ? &x->child[__builtin_ctz(m)] : 0);
+		#else
+			for (unsigned i = 0; i < x->count; ++i)
+				if (x->key[i] == b)
+					return (&x->child[i]);
+			return (0);
+		#endif
+			}
+		case radixNode48: {
+			radixInner48* x = static_cast<radixInner48*>(n);
+			return (x->index[b] ? &x->child[x->index[b] - 1] : 0); }
+		default: {
+			radixInner256* x = static_cast<radixInner256*>(n);
+			return (x->child[b] ? &x->child[b] : 0); }
+		}
+	}
+
+	// the child with the smallest byte greater than b (any byte when first), 0 when none
+	inline void* radixNext(radixInner* n, unsigned b, bool first) {
+		unsigned from = first ? 0 : b + 1;
+
+		switch (n->type){
+		case radixNode4:
+		case radixNode16: {
+			unsigned char*	key = radixKeys(n);
+			for (unsigned i = 0; i < n->count; ++i)
+				if (key[i] >= from)
+					return (radixChildren(n)[i]);
+			return (0); }
+		case radixNode48: {
+			radixInner48* x = static_cast<radixInner48*>(n);
+			for (unsigned i = from; i < 256; ++i)
+				if (x->index[i])
+					return (x->child[x->index[i] - 1]);
+			return (0); }
+		default: {
+			radixInner256* x = static_cast<radixInner256*>(n);
+			for (unsigned i = from; i < 256; ++i)
+				if (x->child[i])
+					return (x->child[i]);
+			return (0); }
+		}
+	}
+
+	inline void* radixFirst(radixInner* n) { return (radixNext(n, 0, true)); }
+
+	// the child with the largest byte less than b, 0 when none
+	inline void* radixPrev(radixInner* n, unsigned b) {
+		switch (n->type){
+		case radixNode4:
+		case radixNode16: {
+			unsigned char*	key = radixKeys(n);
+			for (unsigned i = n->count; i-- > 0;)
+				if (key[i] < b)
+					return (radixChildren(n)[i]);
+			return (0); }
+		case radixNode48: {
+			radixInner48* x = static_cast<radixInner48*>(n);
+			for (unsigned i = b; i-- > 0;)
+				if (x->index[i])
+					return (x->child[x->index[i] - 1]);
+			return (0); }
+		default: {
+			radixInner256* x = static_cast<radixInner256*>(n);
+			for (unsigned i = b; i-- > 0;)
+				if (x->child[i])
+					return (x->child[i]);
+			return (0); }
+		}
+	}
+
+	inline void* radixLast(radixInner* n) {
+		switch (n->type){
+		case radixNode4:
+		case radixNode16:
+			return (n->count ? radixChildren(n)[n->count - 1] : 0);
+		case radixNode48: {
+			radixInner48* x = static_cast<radixInner48*>(n);
+			for (unsigned i = 256; i-- > 0;)
+				if (x->index[i])
+					return (x->child[x->index[i] - 1]);
+			return (0); }
+		default: {
+			radixInner256* x = static_cast<radixInner256*>(n);
+			for (unsigned i = 256; i-- > 0;)
+				if (x->child[i])
+					return (x->child[i]);
+			return (0); }
+		}
+	}
+
+	// the sorted bytes and children of a node4 or node16 with room for one more
+	inline void radixPutSorted(unsigned char* key, void** child, unsigned count, unsigned char b, void* c) {
+		unsigned i = count;
+
+		for (; i > 0 && key[i - 1] > b; --i){
+			key[i] = key[i - 1];
+			child[i] = child[i - 1];}
+		key[i] = b;
+		child[i] = c;
+	}
+
+	// for a node4 just built: no dispatch on the type (which also keeps -Warray-bounds from
+	// seeing the node48 and node256 paths applied to a node4)
+	inline void radixPut(radixInner4* n, unsigned char b, void* c) {
+		radixPutSorted(n->key, n->child, n->count, b, c);
+		++n->count;
+	}
+
+	// n has room for one more child and none for b yet
+	inline void radixPut(radixInner* n, unsigned char b, void* c) {
+		switch (n->type){
+		case radixNode4:
+		case radixNode16:
+			radixPutSorted(radixKeys(n), radixChildren(n), n->count, b, c);
+			break ;
+		case radixNode48: {
+			radixInner48* x = static_cast<radixInner48*>(n);
+			x->child[x->count] = c;
+			x->index[b] = static_cast<unsigned char>(x->count + 1);
+			break ; }
+		default:
+			static_cast<radixInner256*>(n)->child[b] = c;
+		}
+		++n->count;
+	}
+
+	// node48 keeps its slots packed: the last slot moves into the freed one
+	inline void radixRemove(radixInner* n, unsigned char b) {
+		switch (n->type){
+		case radixNode4:
+		case radixNode16: {
+			unsigned char*	key = radixKeys(n);
+			void**			child = radixChildren(n);
+			unsigned		i = 0;
+			while (key[i] != b)
+				++i;
+			for (; i + 1 < n->count; ++i){
+				key[i] = key[i + 1];
+				child[i] = child[i + 1];}
+			break ; }
+		case radixNode48: {
+			radixInner48*	x = static_cast<radixInner48*>(n);
+			unsigned		slot = x->index[b] - 1;
+			unsigned		last = x->count - 1;
+			if (slot != last){
+				unsigned i = 0;
+				while (x->index[i] != last + 1)
+					++i;
+				x->child[slot] = x->child[last];
+				x->index[i] = static_cast<unsigned char>(slot + 1);}
+			x->index[b] = 0;
+			break ; }
+		default:
+			static_cast<radixInner256*>(n)->child[b] = 0;
+		}
+		--n->count;
+	}
+
+	// prefix, term and children of from into the empty node to, which is big enough
+	inline void radixMove(radixInner* from, radixInner* to) {
+		to->prefixLen = from->prefixLen;
+		std::memcpy(to->prefix, from->prefix, radixInner::radixPrefix);
+		to->term = from->term;
+		switch (from->type){
+		case radixNode4:
+		case radixNode16:
+			for (unsigned i = 0; i < from->count; ++i)
+				radixPut(to, radixKeys(from)[i], radixChildren(from)[i]);
+			break ;
+		case radixNode48: {
+			radixInner48* x = static_cast<radixInner48*>(from);
+			for (unsigned i = 0; i < 256; ++i)
+				if (x->index[i])
+					radixPut(to, static_cast<unsigned char>(i), x->child[x->index[i] - 1]);
+			break ; }
+		default: {
+			radixInner256* x = static_cast<radixInner256*>(from);
+			for (unsigned i = 0; i < 256; ++i)
+				if (x->child[i])
+					radixPut(to, static_cast<unsigned char>(i), x->child[i]);
+			}
+		}
+	}
+
+	// a leaf and its map, which finds the neighbours: ++ and -- cost a descent, O(key length)
+	template <class Map, class Value>
+	struct radixMapIterator
+	{
+		public:
+			typedef typename remove_const<Value>::type	value_type;
+			typedef Value&								reference;
+			typedef Value*								pointer;
+			typedef bidirectional_iterator_tag			iterator_category;
+			typedef ptrdiff_t							difference_type;
+
+		private:
+			typedef radixLeaf<value_type>				leaf;
+
+			const Map*	_map;
+			leaf*		_leaf;	// 0 for end()
+
+		public:
+			radixMapIterator(const Map* m = 0, leaf* l = 0): _map(m), _leaf(l){};
+
+			template <class Vp>
+			radixMapIterator(const radixMapIterator<Map, Vp>& cp, typename ft::enable_if<ft::is_convertible<Vp*, Value*>::value>::type* = 0):
+				_map(cp.container()), _leaf(cp.base()){};
+
+			leaf* base() const { return _leaf; }
+			const Map* container() const { return _map; }
+
+			reference operator*() const { return (_leaf->value); }
+			pointer operator->() const { return (&_leaf->value); }
+
+			radixMapIterator& operator++() { _leaf = _map->nextLeaf(_leaf); return (*this); }
+			radixMapIterator operator++(int) { radixMapIterator tmp(*this); ++(*this); return tmp; }
+			radixMapIterator& operator--() { _leaf = _map->prevLeaf(_leaf); return (*this); }
+			radixMapIterator operator--(int) { radixMapIterator tmp(*this); --(*this); return tmp; }
+
+			template <class Vp>
+			bool operator==(const radixMapIterator<Map, Vp>& it) const { return (_leaf == it.base()); }
+			template <class Vp>
+			bool operator!=(const radixMapIterator<Map, Vp>& it) const { return (_leaf != it.base()); }
+	};
+
+	// Ordered map on an adaptive radix tree (ART): inner nodes of 4, 16, 48 or 256 children
+	// indexed by one key byte, grown and shrunk as children come and go, with path compression
+	// and lazy expansion. A lookup reads each key byte once instead of comparing whole keys
+	// at every level, so it costs O(key length) whatever the size; keys sharing long prefixes
+	// (URLs, paths) share the nodes of the prefix. Keys are integers or std::string, ordered
+	// like std::less. A leaf holds only the value: ++ and -- descend from the root to the
+	// next key, O(key length), so a full scan costs about twice what leaves linked in key
+	// order would, and on URL keys twice a walk of ft::map. An erase only invalidates
+	// iterators to the erased element; swap leaves iterators walking the map they were
+	// taken from.
+	template <class Key, class T, class Allocator = std::allocator<pair<const Key, T> > >
+	class radix_map
+	{
+
+	public:
+		typedef Key																key_type;
+		typedef T																mapped_type;
+		typedef ft::pair<const key_type, mapped_type>							value_type;
+		typedef std::less<Key>													key_compare;
+		typedef Allocator														allocator_type;
+		typedef size_t															size_type;
+		typedef ptrdiff_t														difference_type;
+
+		typedef ft::radixMapIterator<radix_map, value_type>						iterator;
+		typedef ft::radixMapIterator<radix_map, const value_type>				const_iterator;
+		typedef ft::reverse_iterator<iterator>									reverse_iterator;
+		typedef ft::reverse_iterator<const_iterator>							const_reverse_iterator;
+		typedef value_type&														reference;
+		typedef const value_type&												const_reference;
+
+		class value_compare : public std::binary_function<value_type, value_type, bool>
+		{
+			friend class radix_map;
+		protected:
+			key_compare comp;
+			value_compare(key_compare c) : comp(c) {}
+
+		public:
+			bool operator() (const value_type& x, const value_type& y) const
+			{ return comp(x.first, y.first); }
+		};
+
+	private:
+		typedef radixLeaf<value_type>											leaf;
+		typedef radixKey<key_type>												bytes;
+		typedef typename Allocator::template rebind<leaf>::other				allocatorLeaf;
+		typedef typename Allocator::template rebind<radixInner4>::other			allocator4;
+		typedef typename Allocator::template rebind<radixInner16>::other		allocator16;
+		typedef typename Allocator::template rebind<radixInner48>::other		allocator48;
+		typedef typename Allocator::template rebind<radixInner256>::other		allocator256;
+
+		static const size_t		radixPrefix = radixInner::radixPrefix;
+
+		key_compare			_comp;
+		allocator_type		_alloc;
+		void*				_root;
+		size_type			_size;
+
+		template <class Map, class Value> friend struct radixMapIterator;
+
+	public:
+
+		explicit radix_map (const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type()):
+			_comp(comp), _alloc(alloc), _root(0), _size(0) {};
+
+		template <class InputIterator>
+			radix_map (InputIterator first, InputIterator last, const key_compare& comp = key_compare(),
+			const allocator_type& alloc = allocator_type()):
+			_comp(comp), _alloc(alloc), _root(0), _size(0)
+		{ insert(first, last); };
+
+		radix_map(const radix_map& x): _comp(x._comp), _alloc(x._alloc), _root(0), _size(0) { insert(x.begin(), x.end()); };
+
+		radix_map &operator=(const radix_map& x) {
+			if (this != &x){
+				clear();
+				insert(x.begin(), x.end());
+			}
+			return *this;
+		};
+
+		~radix_map(){ clear(); };
+
+		// Iterators
+		iterator begin() { return (iterator(this, _root ? minLeaf(_root) : 0)); };
+		const_iterator begin() const { return (const_iterator(this, _root ? minLeaf(_root) : 0)); };
+		iterator end() { return (iterator(this, 0)); };
+		const_iterator end() const { return (const_iterator(this, 0)); };
+
+		reverse_iterator rbegin() { return reverse_iterator(end()); };
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); };
+		reverse_iterator rend() { return reverse_iterator(begin()); };
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); };
+
+		// Capacity
+		bool empty() const { return (_size == 0); };
+		size_type size() const { return (_size); };
+		size_type max_size() const { return (allocatorLeaf().max_size()); };
+
+		// Element access
+		mapped_type& operator[] (const key_type& k) { return ((*insert(value_type(k, mapped_type())).first).second); }
+
+		mapped_type& at (const key_type& k) {
+			leaf* l = findLeaf(k);
+
+			if (!l)
+				throw std::out_of_range("");
+			return (l->value.second);
+		}
+
+		const mapped_type& at (const key_type& k) const {
+			leaf* l = findLeaf(k);
+
+			if (!l)
+				throw std::out_of_range("");
+			return (l->value.second);
+		}
+
+		// Modifiers
+		ft::pair<iterator, bool> insert(const value_type& v) {
+			leaf* l = findLeaf(v.first);
+
+			if (l)
+				return (ft::make_pair(iterator(this, l), false));
+			l = newLeaf(v);
+			try { insertLeaf(l); }
+			catch (...) { deleteLeaf(l); throw ; }
+			++_size;
+			return (ft::make_pair(iterator(this, l), true));
+		}
+
+		iterator insert (iterator position, const value_type& val) {
+			(void)position;
+			return (insert(val).first);
+		}
+
+		template <class InputIterator>
+		void insert (InputIterator first, InputIterator last) {
+			for (; first != last; ++first)
+				insert(value_type(first->first, first->second));
+		}
+
+		void erase (iterator position) { erase(position->first); }
+
+		size_type erase (const key_type& k) {
+			const bytes	kb(k);
+			void**		ref = &_root;
+			size_t		depth = 0;
+			radixInner*	n;
+			void**		c;
+			leaf*		l;
+
+			while (*ref){
+				if (isLeaf(*ref)){ // only the root is reached this way
+					l = asLeaf(*ref);
+					if (!(l->value.first == k))
+						return (0);
+					*ref = 0;
+					destroyLeaf(l);
+					return (1);}
+				n = asInner(*ref);
+				if (!prefixMatches(n, kb, depth))
+					return (0);
+				depth += n->prefixLen;
+				if (depth == kb.size()){
+					l = termLeaf(n);
+					if (!l || !(l->value.first == k))
+						return (0);
+					n->term = 0;
+					tidy(ref);
+					destroyLeaf(l);
+					return (1);}
+				if (!(c = radixFind(n, kb[depth])))
+					return (0);
+				if (isLeaf(*c)){
+					l = asLeaf(*c);
+					if (!(l->value.first == k))
+						return (0);
+					radixRemove(n, kb[depth]);
+					tidy(ref);
+					destroyLeaf(l);
+					return (1);}
+				ref = c;
+				++depth;
+			}
+			return (0);
+		}
+
+		void erase (iterator first, iterator last) {
+			while (first != last)
+				erase(first++);
+		}
+
+		void swap (radix_map& x) {
+			std::swap(_root, x._root);
+			std::swap(_size, x._size);
+		}
+
+		void clear() {
+			if (_root)
+				freeTree(_root);
+			_root = 0;
+			_size = 0;
+		}
+
+		// Lookup
+		iterator find (const key_type& k) { return (iterator(this, findLeaf(k))); }
+		const_iterator find (const key_type& k) const { return (const_iterator(this, findLeaf(k))); }
+
+		size_type count (const key_type& k) const { return (findLeaf(k) ? 1 : 0); }
+
+		iterator lower_bound (const key_type& k) { return (iterator(this, boundLeaf(k, false))); };
+		const_iterator lower_bound (const key_type& k) const { return (const_iterator(this, boundLeaf(k, false))); };
+		iterator upper_bound (const key_type& k) { return (iterator(this, boundLeaf(k, true))); };
+		const_iterator upper_bound (const key_type& k) const { return (const_iterator(this, boundLeaf(k, true))); };
+
+		pair<iterator,iterator> equal_range (const key_type& k) { return (ft::make_pair(lower_bound(k), upper_bound(k))); }
+		pair<const_iterator,const_iterator> equal_range (const key_type& k) const { return (ft::make_pair(lower_bound(k), upper_bound(k))); }
+
+		// the keys whose bytes start with those of prefix, e.g. every URL under a host; the
+		// descent stops at the subtree that holds them, so the range costs O(prefix length)
+		pair<iterator,iterator> prefix_range (const key_type& prefix) {
+			pair<leaf*, leaf*> r = prefixLeaves(prefix);
+
+			return (ft::make_pair(iterator(this, r.first), iterator(this, r.second)));
+		}
+
+		pair<const_iterator,const_iterator> prefix_range (const key_type& prefix) const {
+			pair<leaf*, leaf*> r = prefixLeaves(prefix);
+
+			return (ft::make_pair(const_iterator(this, r.first), const_iterator(this, r.second)));
+		}
+
+		allocator_type get_allocator() const { return (_alloc); };
+
+		// Observers
+		key_compare key_comp() const { return (_comp); };
+		value_compare value_comp() const { return value_compare(key_comp()); }
+
+		// Non-member functions:
+		friend bool	operator == (const radix_map& x, const radix_map& y){
+			const_iterator i = x.begin();
+			const_iterator j = y.begin();
+
+			if (x.size() != y.size())
+				return false;
+			for (; i != x.end(); ++i, ++j)
+				if (!(i->first == j->first) || !(i->second == j->second))
+					return false;
+			return true;
+		};
+
+		friend bool	operator != (const radix_map& x, const radix_map& y){ return !(x == y); };
+
+		friend bool	operator < (const radix_map& x, const radix_map& y){
+			const_iterator i = x.begin();
+			const_iterator j = y.begin();
+
+			for (; i != x.end() && j != y.end(); ++i, ++j) {
+				if (i->first != j->first)
+					return (i->first < j->first);
+				else if (i->second != j->second)
+					return (i->second < j->second);
+			}
+			return (x.size() < y.size());
+		};
+
+		friend bool	operator > (const radix_map& x, const radix_map& y){ return (y < x); };
+		friend bool	operator <= (const radix_map& x, const radix_map& y){ return !(y < x); };
+		friend bool	operator >= (const radix_map& x, const radix_map& y){ return !(x < y); };
+
+	private:
+		static bool isLeaf(const void* p) { return (reinterpret_cast<uintptr_t>(p) & 1); }
+		static leaf* asLeaf(void* p) { return (reinterpret_cast<leaf*>(reinterpret_cast<uintptr_t>(p) - 1)); }
+		static void* tagLeaf(leaf* l) { return (reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(l) + 1)); }
+		static radixInner* asInner(void* p) { return (static_cast<radixInner*>(p)); }
+		static leaf* termLeaf(const radixInner* n) { return (static_cast<leaf*>(n->term)); }
+
+		static leaf* minLeaf(void* p) {
+			while (!isLeaf(p)){
+				if (asInner(p)->term)
+					return (termLeaf(asInner(p)));
+				p = radixFirst(asInner(p));}
+			return (asLeaf(p));
+		}
+
+		static leaf* maxLeaf(void* p) {
+			while (!isLeaf(p)){
+				if (asInner(p)->count == 0)
+					return (termLeaf(asInner(p)));
+				p = radixLast(asInner(p));}
+			return (asLeaf(p));
+		}
+
+		// the stored part of the prefix only; the key comparison at the leaf settles the rest
+		static bool prefixMatches(const radixInner* n, const bytes& kb, size_t depth) {
+			size_t stored = n->prefixLen < radixPrefix ? n->prefixLen : radixPrefix;
+
+			if (depth + n->prefixLen > kb.size())
+				return (false);
+			for (size_t i = 0; i < stored; ++i)
+				if (n->prefix[i] != kb[depth + i])
+					return (false);
+			return (true);
+		}
+
+		// index of the first prefix byte of n that differs from the key at depth, or where the
+		// key ends; prefixLen when the whole prefix matches. dir < 0 when the key is below the
+		// subtree there, > 0 above it
+		static size_t mismatch(radixInner* n, const bytes& kb, size_t depth, int& dir) {
+			size_t stored = n->prefixLen < radixPrefix ? n->prefixLen : radixPrefix;
+			size_t i = 0;
+
+			dir = 0;
+			for (; i < stored; ++i)
+				if (depth + i == kb.size() || n->prefix[i] != kb[depth + i])
+					break ;
+			if (i == stored && stored < n->prefixLen){
+				const bytes lb(minLeaf(n)->value.first);
+				for (; i < n->prefixLen; ++i)
+					if (depth + i == kb.size() || lb[depth + i] != kb[depth + i]){
+						dir = depth + i == kb.size() || kb[depth + i] < lb[depth + i] ? -1 : 1;
+						return (i);}
+				return (i);}
+			if (i < n->prefixLen)
+				dir = depth + i == kb.size() || kb[depth + i] < n->prefix[i] ? -1 : 1;
+			return (i);
+		}
+
+		leaf* findLeaf(const key_type& k) const {
+			const bytes	kb(k);
+			void*		p = _root;
+			size_t		depth = 0;
+			radixInner*	n;
+			void**		c;
+
+			while (p){
+				if (isLeaf(p))
+					return (asLeaf(p)->value.first == k ? asLeaf(p) : 0);
+				n = asInner(p);
+				if (!prefixMatches(n, kb, depth))
+					return (0);
+				depth += n->prefixLen;
+				if (depth == kb.size())
+					return (n->term && termLeaf(n)->value.first == k ? termLeaf(n) : 0);
+				if (!(c = radixFind(n, kb[depth])))
+					return (0);
+				p = *c;
+				++depth;
+			}
+			return (0);
+		}
+
+		// the smallest leaf of the subtree right of the path (0: none, end()), or the largest
+		// of the one left of it
+		static leaf* after(void* right) { return (right ? minLeaf(right) : 0); }
+		static leaf* before(void* left) { return (left ? maxLeaf(left) : 0); }
+
+		// first leaf not less than k, or greater than k when upper. Where the descent leaves
+		// the key's path the answer is the smallest leaf of the next subtree on the right,
+		// right holding the nearest one passed on the way down
+		leaf* boundLeaf(const key_type& k, bool upper) const {
+			const bytes	kb(k);
+			void*		p = _root;
+			void*		right = 0;
+			size_t		depth = 0;
+			radixInner*	n;
+			void**		c;
+			void*		next;
+			int			dir;
+
+			if (!p)
+				return (0);
+			while (true){
+				if (isLeaf(p))
+					return ((upper ? !_comp(k, asLeaf(p)->value.first) : _comp(asLeaf(p)->value.first, k)) ? after(right) : asLeaf(p));
+				n = asInner(p);
+				if (mismatch(n, kb, depth, dir) < n->prefixLen)
+					return (dir < 0 ? minLeaf(p) : after(right));
+				depth += n->prefixLen;
+				if (depth == kb.size()){ // the term is k, every child is above it
+					if (!upper || !n->term)
+						return (minLeaf(p));
+					next = radixFirst(n);
+					return (next ? minLeaf(next) : after(right));}
+				next = radixNext(n, kb[depth], false);
+				if (!(c = radixFind(n, kb[depth])))
+					return (next ? minLeaf(next) : after(right));
+				if (next)
+					right = next;
+				p = *c;
+				++depth;
+			}
+		}
+
+		// last leaf less than k, the mirror of boundLeaf; a node's term is the subtree on the
+		// left of its first child
+		leaf* belowLeaf(const key_type& k) const {
+			const bytes	kb(k);
+			void*		p = _root;
+			void*		left = 0;
+			size_t		depth = 0;
+			radixInner*	n;
+			void**		c;
+			void*		prev;
+			int			dir;
+
+			if (!p)
+				return (0);
+			while (true){
+				if (isLeaf(p))
+					return (_comp(asLeaf(p)->value.first, k) ? asLeaf(p) : before(left));
+				n = asInner(p);
+				if (mismatch(n, kb, depth, dir) < n->prefixLen)
+					return (dir > 0 ? maxLeaf(p) : before(left));
+				depth += n->prefixLen;
+				if (depth == kb.size())
+					return (before(left));
+				prev = radixPrev(n, kb[depth]);
+				if (!prev && n->term)
+					prev = tagLeaf(termLeaf(n));
+				if (!(c = radixFind(n, kb[depth])))
+					return (prev ? maxLeaf(prev) : before(left));
+				if (prev)
+					left = prev;
+				p = *c;
+				++depth;
+			}
+		}
+
+		// the iterator steps; -- from end() goes to the largest key
+		leaf* nextLeaf(const leaf* l) const { return (boundLeaf(l->value.first, true)); }
+		leaf* prevLeaf(const leaf* l) const { return (l ? belowLeaf(l->value.first) : (_root ? maxLeaf(_root) : 0)); }
+
+		pair<leaf*, leaf*> prefixLeaves(const key_type& prefix) const {
+			const bytes	kb(prefix);
+			void*		p = _root;
+			void*		right = 0;
+			size_t		depth = 0;
+			radixInner*	n;
+			void**		c;
+			void*		next;
+			int			dir;
+			size_t		m;
+
+			while (p){
+				if (isLeaf(p)){
+					const bytes lb(asLeaf(p)->value.first);
+					if (lb.size() >= kb.size() && std::memcmp(lb.data(), kb.data(), kb.size()) == 0)
+						return (ft::make_pair(asLeaf(p), after(right)));
+					break ;}
+				n = asInner(p);
+				m = mismatch(n, kb, depth, dir);
+				if (depth + m == kb.size())
+					return (ft::make_pair(minLeaf(p), after(right)));
+				if (m < n->prefixLen)
+					break ;
+				depth += n->prefixLen;
+				if (!(c = radixFind(n, kb[depth])))
+					break ;
+				if ((next = radixNext(n, kb[depth], false)))
+					right = next;
+				p = *c;
+				++depth;
+			}
+			return (ft::make_pair(static_cast<leaf*>(0), static_cast<leaf*>(0)));
+		}
+
+		// l's key is not in the tree yet
+		void insertLeaf(leaf* l) {
+			const bytes	kb(l->value.first);
+			void**		ref = &_root;
+			size_t		depth = 0;
+			radixInner*	n;
+			void**		c;
+			int			dir;
+			size_t		m;
+
+			while (true){
+				if (!*ref){
+					*ref = tagLeaf(l);
+					return ;}
+				if (isLeaf(*ref)){
+					splitLeaf(ref, asLeaf(*ref), l, kb, depth);
+					return ;}
+				n = asInner(*ref);
+				m = mismatch(n, kb, depth, dir);
+				if (m < n->prefixLen){
+					splitPrefix(ref, n, l, kb, depth, m);
+					return ;}
+				depth += n->prefixLen;
+				if (depth == kb.size()){
+					n->term = l;
+					return ;}
+				if (!(c = radixFind(n, kb[depth]))){
+					addChild(ref, n, kb[depth], tagLeaf(l));
+					return ;}
+				ref = c;
+				++depth;
+			}
+		}
+
+		static void place(radixInner4* n, leaf* l, const bytes& kb, size_t i) {
+			if (kb.size() == i)
+				n->term = l;
+			else
+				radixPut(n, kb.data()[i], tagLeaf(l));
+		}
+
+		// two keys under one slot: a node4 holding the bytes they share as its prefix
+		void splitLeaf(void** ref, leaf* old, leaf* l, const bytes& kb, size_t depth) {
+			const bytes		ob(old->value.first);
+			size_t			i = depth;
+			radixInner4*	n;
+
+			while (i < ob.size() && i < kb.size() && ob[i] == kb[i])
+				++i;
+			n = newNode<radixInner4>(allocator4());
+			n->prefixLen = static_cast<unsigned int>(i - depth);
+			std::memcpy(n->prefix, kb.data() + depth, n->prefixLen < radixPrefix ? n->prefixLen : radixPrefix);
+			place(n, old, ob, i);
+			place(n, l, kb, i);
+			*ref = n;
+		}
+
+		// the key leaves the prefix of n after m bytes: a node4 takes the first m bytes and
+		// parents n (by the byte at m) and the new leaf
+		void splitPrefix(void** ref, radixInner* n, leaf* l, const bytes& kb, size_t depth, size_t m) {
+			radixInner4*	top = newNode<radixInner4>(allocator4());
+			size_t			rest = n->prefixLen - m - 1;
+			size_t			stored = rest < radixPrefix ? rest : radixPrefix;
+			unsigned char	tail[radixPrefix];
+			unsigned char	edge;
+
+			if (n->prefixLen > radixPrefix){
+				const bytes lb(minLeaf(n)->value.first);
+				edge = lb[depth + m];
+				for (size_t i = 0; i < stored; ++i)
+					tail[i] = lb[depth + m + 1 + i];}
+			else {
+				edge = n->prefix[m];
+				for (size_t i = 0; i < stored; ++i)
+					tail[i] = n->prefix[m + 1 + i];}
+			top->prefixLen = static_cast<unsigned int>(m);
+			std::memcpy(top->prefix, n->prefix, m < radixPrefix ? m : radixPrefix);
+			n->prefixLen = static_cast<unsigned int>(rest);
+			std::memcpy(n->prefix, tail, stored);
+			radixPut(top, edge, n);
+			place(top, l, kb, depth + m);
+			*ref = top;
+		}
+
+		void addChild(void** ref, radixInner* n, unsigned char b, void* c) {
+			radixInner* g;
+
+			if (radixFull(n)){
+				if (n->type == radixNode4)
+					g = newNode<radixInner16>(allocator16());
+				else if (n->type == radixNode16)
+					g = newNode<radixInner48>(allocator48());
+				else
+					g = newNode<radixInner256>(allocator256());
+				radixMove(n, g);
+				freeNode(n);
+				*ref = n = g;}
+			radixPut(n, b, c);
+		}
+
+		// after a removal: a sparse node moves to the next smaller type (with some slack so
+		// that one insert does not grow it back), and a node4 left with one entry is replaced
+		// by it, a child node taking over the prefix. A failed allocation just keeps the node
+		void tidy(void** ref) {
+			radixInner* n = asInner(*ref);
+			radixInner* s;
+			void*		c;
+
+			if ((n->type == radixNode16 && n->count <= 3) || (n->type == radixNode48 && n->count <= 12)
+				|| (n->type == radixNode256 && n->count <= 37)){
+				try {
+					if (n->type == radixNode16)
+						s = newNode<radixInner4>(allocator4());
+					else if (n->type == radixNode48)
+						s = newNode<radixInner16>(allocator16());
+					else
+						s = newNode<radixInner48>(allocator48());
+				}
+				catch (...) { return ; }
+				radixMove(n, s);
+				freeNode(n);
+				*ref = n = s;}
+			if (n->type != radixNode4 || n->count + (n->term ? 1 : 0) != 1)
+				return ;
+			if (n->count == 0)
+				c = tagLeaf(termLeaf(n));
+			else if (isLeaf(c = radixChildren(n)[0]))
+				;
+			else {
+				radixInner*		child = asInner(c);
+				unsigned char	merged[radixPrefix];
+				size_t			k = 0;
+				for (size_t i = 0; i < n->prefixLen && k < radixPrefix; ++i)
+					merged[k++] = n->prefix[i];
+				if (k < radixPrefix)
+					merged[k++] = radixKeys(n)[0];
+				for (size_t i = 0; i < child->prefixLen && k < radixPrefix; ++i)
+					merged[k++] = child->prefix[i];
+				child->prefixLen += n->prefixLen + 1;
+				std::memcpy(child->prefix, merged, k);}
+			*ref = c;
+			freeNode(n);
+		}
+
+		leaf* newLeaf(const value_type& v) {
+			allocatorLeaf	a;
+			leaf*			l = a.allocate(1);
+
+			try { new (l) leaf(v); }
+			catch (...) { a.deallocate(l, 1); throw ; }
+			return (l);
+		}
+
+		void deleteLeaf(leaf* l) {
+			allocatorLeaf a;
+
+			l->~leaf();
+			a.deallocate(l, 1);
+		}
+
+		// frees a leaf already out of the tree
+		void destroyLeaf(leaf* l) {
+			deleteLeaf(l);
+			--_size;
+		}
+
+		template <class Node, class NodeAllocator>
+		static Node* newNode(NodeAllocator a) {
+			Node* n = a.allocate(1);
+
+			new (n) Node();
+			return (n);
+		}
+
+		static void freeNode(radixInner* n) {
+			switch (n->type){
+			case radixNode4: allocator4().deallocate(static_cast<radixInner4*>(n), 1); break ;
+			case radixNode16: allocator16().deallocate(static_cast<radixInner16*>(n), 1); break ;
+			case radixNode48: allocator48().deallocate(static_cast<radixInner48*>(n), 1); break ;
+			default: allocator256().deallocate(static_cast<radixInner256*>(n), 1);
+			}
+		}
+
+		// the inner nodes and leaves under p
+		void freeTree(void* p) {
+			radixInner*	n;
+			unsigned	slots;
+			void**		child;
+
+			if (isLeaf(p)){
+				deleteLeaf(asLeaf(p));
+				return ;}
+			n = asInner(p);
+			slots = n->type == radixNode256 ? 256 : n->count;
+			child = n->type == radixNode48 ? static_cast<radixInner48*>(n)->child
+				: n->type == radixNode256 ? static_cast<radixInner256*>(n)->child : radixChildren(n);
+			for (unsigned i = 0; i < slots; ++i)
+				if (child[i])
+					freeTree(child[i]);
+			if (n->term)
+				deleteLeaf(termLeaf(n));
+			freeNode(n);
+		}
+
+	};
+
+}
+
+#endif
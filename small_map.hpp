@@ -0,0 +1,520 @@
+#ifndef SMALL_MAP_HPP
+#define SMALL_MAP_HPP
+
+#include <memory>
+#include <new>
+#include <functional>
+#include <stdexcept>
+#include <stdint.h>
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+#include "utils.hpp"
+#include "iterator.hpp"
+#include "map.hpp"
+
+namespace ft
+{
+	// lower bound in a short sorted key array by linear scan: the keys before it are exactly
+	// the ones less than k. Any comparator stops at the first key not less than k
+	template <class Key, class Compare>
+	struct smallMapScan
+	{
+		static size_t lower(const Key* keys, size_t n, const Key& k, const Compare& comp) {
+			size_t i = 0;
+
+			while (i < n && comp(keys[i], k))
+				++i;
+			return (i);
+		}
+	};
+
+	// integers under std::less are counted without branches, 32-bit ones four at a time (SSE2)
+	template <class Key>
+	struct smallMapScan<Key, std::less<Key> >
+	{
+		static size_t lower(const Key* keys, size_t n, const Key& k, const std::less<Key>& comp) {
+			return (lower(keys, n, k, comp, integral_constant<bool, is_integral<Key>::value>()));
+		}
+
+		static size_t lower(const Key* keys, size_t n, const Key& k, const std::less<Key>& comp, false_type) {
+			size_t i = 0;
+
+			while (i < n && comp(keys[i], k))
+				++i;
+			return (i);
+		}
+
+		static size_t lower(const Key* keys, size_t n, const Key& k, const std::less<Key>& comp, true_type) {
+			size_t count = 0;
+			size_t i = 0;
+
+		#ifdef __SSE2__
+			if (sizeof(Key) == 4){
+				const __m128i	flip = _mm_set1_epi32(Key(-1) < Key(0) ? 0 : INT32_MIN); // unsigned order via signed compare
+				const __m128i	kv = _mm_xor_si128(_mm_set1_epi32(static_cast<int32_t>(k)), flip);
+				int				mask;
+
+				for (; i + 4 <= n; i += 4){
+					mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(kv,
+						_mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), flip))));
+					if (mask != 0xF) // sorted: the lanes holding smaller keys come first
+						return (i + (mask & 1) + (mask >> 1 & 1) + (mask >> 2 & 1));}
+				count = i;
+			}
+		#endif
+			for (; i < n; ++i)
+				count += comp(keys[i], k);
+			return (count);
+		}
+	};
+
+
+	// iterates the inline arrays (key pointer set) or the ft::map the entries moved to
+	template< class Key, class T, class MapIterator >
+	class smallMapIterator
+	{
+		public:
+			typedef ft::pair<const Key, typename remove_const<T>::type>	value_type;
+			typedef pairRef<Key, T>										reference;
+			typedef pairRefArrow<Key, T>								pointer;
+			typedef bidirectional_iterator_tag							iterator_category;
+			typedef ptrdiff_t											difference_type;
+
+		private:
+			const Key*		_key;
+			T*				_value;
+			MapIterator		_it;
+
+		public:
+			smallMapIterator(): _key(0), _value(0), _it(){};
+			smallMapIterator(const Key* k, T* v): _key(k), _value(v), _it(){};
+			smallMapIterator(const MapIterator& it): _key(0), _value(0), _it(it){};
+
+			template <class Up, class It>
+			smallMapIterator(const smallMapIterator<Key, Up, It>& cp): _key(cp.keyBase()), _value(cp.valueBase()), _it(cp.mapBase()){};
+
+			const Key* keyBase() const { return _key; }
+			T* valueBase() const { return _value; }
+			const MapIterator& mapBase() const { return _it; }
+
+			reference operator*() const {
+				MapIterator it(_it); // mapIterator only hands out non-const entries from a non-const iterator
+
+				return (_key ? reference(*_key, *_value) : reference(it->first, it->second));}
+			pointer operator->() const { return pointer(operator*()); }
+
+			smallMapIterator &operator++(){
+				if (_key){
+					++_key;
+					++_value;}
+				else
+					++_it;
+				return (*this);};
+			smallMapIterator operator++(int){ smallMapIterator temp = *this; ++*this; return temp; };
+			smallMapIterator &operator--(){
+				if (_key){
+					--_key;
+					--_value;}
+				else
+					--_it;
+				return (*this);};
+			smallMapIterator operator--(int){ smallMapIterator temp = *this; --*this; return temp; };
+
+			template <class Up, class It>
+			bool operator==(const smallMapIterator<Key, Up, It>& it) const {return (_key == it.keyBase() && (_key || _it == it.mapBase()));};
+			template <class Up, class It>
+			bool operator!=(const smallMapIterator<Key, Up, It>& it) const {return !(*this == it);};
+	};
+
+
+	// Map for a handful of entries: up to N of them sit inline in two sorted arrays (keys,
+	// values) searched linearly, so an empty map and the first N inserts allocate nothing.
+	// Entry N + 1 moves everything into an ft::map, which it keeps until clear().
+	// Inserting or erasing inline moves the entries after it, and the move to the ft::map
+	// invalidates all iterators
+	template <class Key, class T, size_t N = 16, class Compare = std::less<Key>, class Allocator = std::allocator<pair<const Key, T> > >
+	class small_map
+	{
+
+	public:
+		typedef Key																key_type;
+		typedef T																mapped_type;
+		typedef ft::pair<const key_type, mapped_type>							value_type;
+		typedef Compare															key_compare;
+		typedef Allocator														allocator_type;
+		typedef size_t															size_type;
+		typedef ptrdiff_t														difference_type;
+		typedef ft::map<Key, T, Compare, Allocator>								map_type;
+
+		typedef ft::smallMapIterator<key_type, mapped_type, typename map_type::iterator>				iterator;
+		typedef ft::smallMapIterator<key_type, const mapped_type, typename map_type::const_iterator>	const_iterator;
+		typedef ft::reverse_iterator<iterator>									reverse_iterator;
+		typedef ft::reverse_iterator<const_iterator>							const_reverse_iterator;
+		typedef typename iterator::reference									reference;
+		typedef typename const_iterator::reference								const_reference;
+
+		class value_compare : public std::binary_function<value_type, value_type, bool>
+		{
+			friend class small_map;
+		protected:
+			Compare comp;
+			value_compare(Compare c) : comp(c) {}
+
+		public:
+			bool operator() (const value_type& x, const value_type& y) const
+			{ return comp(x.first, y.first); }
+		};
+
+	private:
+		typedef typename Allocator::template rebind<map_type>::other			allocatorMap;
+		typedef typename Allocator::template rebind<typename map_type::node_type>::other	allocatorNode;
+		typedef smallMapScan<key_type, key_compare>								scan;
+
+		// raw inline storage, aligned for the usual scalar types
+		union keySlots { char bytes[sizeof(Key) * N]; void* p; long double f; uint64_t i; };
+		union valueSlots { char bytes[sizeof(T) * N]; void* p; long double f; uint64_t i; };
+
+		key_compare		_comp;
+		allocator_type	_alloc;
+		size_type		_size;	// inline entries
+		map_type*		_big;	// 0 while inline
+		keySlots		_keys;
+		valueSlots		_values;
+
+	public:
+
+		explicit small_map (const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type()):
+			_comp(comp), _alloc(alloc), _size(0), _big(0) {};
+
+		template <class InputIterator>
+			small_map (InputIterator first, InputIterator last, const key_compare& comp = key_compare(),
+			const allocator_type& alloc = allocator_type()):
+			_comp(comp), _alloc(alloc), _size(0), _big(0)
+		{ insert(first, last); };
+
+		small_map(const small_map& x): _comp(x._comp), _alloc(x._alloc), _size(0), _big(0) { copyFrom(x); };
+
+		small_map &operator=(const small_map& x) {
+			if (this != &x){
+				clear();
+				_comp = x._comp;
+				copyFrom(x);
+			}
+			return *this;
+		};
+
+		~small_map(){ clear(); };
+
+		// Iterators
+		iterator begin() { return (_big ? iterator(_big->begin()) : iterator(keys(), values())); };
+		const_iterator begin() const { return (_big ? const_iterator(constBig().begin()) : const_iterator(keys(), values())); };
+		iterator end() { return (_big ? iterator(_big->end()) : iterator(keys() + _size, values() + _size)); };
+		const_iterator end() const { return (_big ? const_iterator(constBig().end()) : const_iterator(keys() + _size, values() + _size)); };
+
+		reverse_iterator rbegin() { return reverse_iterator(end()); };
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); };
+		reverse_iterator rend() { return reverse_iterator(begin()); };
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); };
+
+		// Capacity
+		bool empty() const { return (size() == 0); };
+		size_type size() const { return (_big ? _big->size() : _size); };
+		size_type max_size() const { return (allocatorNode(_alloc).max_size()); }; // the entries end up in map nodes
+		bool is_inline() const { return (_big == 0); };
+
+		// Element access
+		mapped_type& operator[] (const key_type& k) {
+			size_type i;
+
+			if (_big)
+				return ((*_big)[k]);
+			i = lowerIndex(k);
+			if (i < _size && !_comp(k, keys()[i]))
+				return (values()[i]);
+			if (_size == N){
+				moveToMap();
+				return ((*_big)[k]);}
+			insertAt(i, k, mapped_type());
+			return (values()[i]);
+		}
+
+		mapped_type& at (const key_type& k) {
+			if (_big)
+				return (_big->at(k));
+			size_type i = findIndex(k);
+
+			if (i == _size)
+				throw std::out_of_range("");
+			return (values()[i]);
+		}
+
+		const mapped_type& at (const key_type& k) const {
+			if (_big)
+				return (constBig().at(k));
+			size_type i = findIndex(k);
+
+			if (i == _size)
+				throw std::out_of_range("");
+			return (values()[i]);
+		}
+
+		// Modifiers
+		ft::pair<iterator, bool> insert(const value_type& v) {
+			size_type i;
+
+			if (_big){
+				ft::pair<typename map_type::iterator, bool> res = _big->insert(v);
+				return (ft::make_pair(iterator(res.first), res.second));}
+			i = lowerIndex(v.first);
+			if (i < _size && !_comp(v.first, keys()[i]))
+				return (ft::make_pair(inlineAt(i), false));
+			if (_size == N){
+				moveToMap();
+				return (insert(v));}
+			insertAt(i, v.first, v.second);
+			return (ft::make_pair(inlineAt(i), true));
+		}
+
+		iterator insert (iterator position, const value_type& val) {
+			(void)position;
+			return (insert(val).first);
+		}
+
+		template <class InputIterator>
+		void insert (InputIterator first, InputIterator last) {
+			for (; first != last; ++first)
+				insert(value_type(first->first, first->second));
+		}
+
+		void erase (iterator position) {
+			if (_big)
+				_big->erase(position.mapBase());
+			else
+				eraseAt(position.keyBase() - keys(), 1);
+		}
+
+		size_type erase (const key_type& k) {
+			if (_big)
+				return (_big->erase(k));
+			size_type i = findIndex(k);
+
+			if (i == _size)
+				return 0;
+			eraseAt(i, 1);
+			return 1;
+		}
+
+		void erase (iterator first, iterator last) {
+			if (_big)
+				_big->erase(first.mapBase(), last.mapBase());
+			else
+				eraseAt(first.keyBase() - keys(), last.keyBase() - first.keyBase());
+		}
+
+		// a map held in an ft::map hands it over; inline entries are copied across
+		void swap (small_map& x) {
+			small_map tmp(_comp, _alloc);
+
+			if (_big && x._big){
+				std::swap(_big, x._big);
+				std::swap(_comp, x._comp);
+				return ;}
+			tmp.take(*this);
+			take(x);
+			x.take(tmp);
+			std::swap(_comp, x._comp);
+		}
+
+		// also goes back to the inline form
+		void clear() {
+			allocatorMap a;
+
+			if (_big){
+				a.destroy(_big);
+				a.deallocate(_big, 1);
+				_big = 0;}
+			destroyInline(0);
+		}
+
+		// Lookup
+		iterator find (const key_type& k) {
+			if (_big)
+				return (iterator(_big->find(k)));
+			return (inlineAt(findIndex(k)));
+		}
+
+		const_iterator find (const key_type& k) const {
+			if (_big)
+				return (const_iterator(constBig().find(k)));
+			return (inlineAt(findIndex(k)));
+		}
+
+		size_type count (const key_type& k) const {
+			if (_big)
+				return (_big->count(k));
+			return (findIndex(k) == _size ? 0 : 1);
+		}
+
+		iterator lower_bound (const key_type& k) { return (_big ? iterator(_big->lower_bound(k)) : inlineAt(lowerIndex(k))); };
+		const_iterator lower_bound (const key_type& k) const { return (_big ? const_iterator(constBig().lower_bound(k)) : inlineAt(lowerIndex(k))); };
+		iterator upper_bound (const key_type& k) { return (_big ? iterator(_big->upper_bound(k)) : inlineAt(upperIndex(k))); };
+		const_iterator upper_bound (const key_type& k) const { return (_big ? const_iterator(constBig().upper_bound(k)) : inlineAt(upperIndex(k))); };
+
+		pair<iterator,iterator> equal_range (const key_type& k) { return (ft::make_pair(lower_bound(k), upper_bound(k))); }
+		pair<const_iterator,const_iterator> equal_range (const key_type& k) const { return (ft::make_pair(lower_bound(k), upper_bound(k))); }
+
+		allocator_type get_allocator() const { return (_alloc); };
+
+		// Observers
+		key_compare key_comp() const { return (_comp); };
+		value_compare value_comp() const { return value_compare(key_comp()); }
+
+		// Non-member functions:
+		friend bool	operator == (const small_map& x, const small_map& y){
+			if (x.size() != y.size())
+				return false;
+			for (const_iterator i = x.begin(), j = y.begin(); i != x.end(); ++i, ++j)
+				if (!((*i).first == (*j).first) || !((*i).second == (*j).second))
+					return false;
+			return true;
+		};
+
+		friend bool	operator != (const small_map& x, const small_map& y){ return !(x == y); };
+
+		friend bool	operator < (const small_map& x, const small_map& y){
+			const_iterator i = x.begin();
+			const_iterator j = y.begin();
+
+			for (; i != x.end() && j != y.end(); ++i, ++j) {
+				if ((*i).first != (*j).first)
+					return ((*i).first < (*j).first);
+				else if ((*i).second != (*j).second)
+					return ((*i).second < (*j).second);
+			}
+			return (i == x.end() && j != y.end());
+		};
+
+		friend bool	operator > (const small_map& x, const small_map& y){ return (y < x); };
+		friend bool	operator <= (const small_map& x, const small_map& y){ return !(y < x); };
+		friend bool	operator >= (const small_map& x, const small_map& y){ return !(x < y); };
+
+	private:
+		key_type* keys() { return (reinterpret_cast<key_type*>(_keys.bytes)); }
+		const key_type* keys() const { return (reinterpret_cast<const key_type*>(_keys.bytes)); }
+		mapped_type* values() { return (reinterpret_cast<mapped_type*>(_values.bytes)); }
+		const mapped_type* values() const { return (reinterpret_cast<const mapped_type*>(_values.bytes)); }
+		const map_type& constBig() const { return (*_big); }
+
+		iterator inlineAt(size_type i) { return (iterator(keys() + i, values() + i)); }
+		const_iterator inlineAt(size_type i) const { return (const_iterator(keys() + i, values() + i)); }
+
+		size_type lowerIndex(const key_type& k) const { return (scan::lower(keys(), _size, k, _comp)); }
+
+		size_type upperIndex(const key_type& k) const {
+			size_type i = lowerIndex(k);
+
+			return ((i < _size && !_comp(k, keys()[i])) ? i + 1 : i);
+		}
+
+		// index of k, or _size when absent
+		size_type findIndex(const key_type& k) const {
+			size_type i = lowerIndex(k);
+
+			if (i < _size && !_comp(k, keys()[i]))
+				return i;
+			return _size;
+		}
+
+		// the last entry is copied into the free slot, the rest shift up by assignment
+		void insertAt(size_type i, const key_type& k, const mapped_type& v) {
+			key_type*		key = keys();
+			mapped_type*	value = values();
+
+			if (i == _size){
+				::new (static_cast<void*>(key + i)) key_type(k);
+				try { ::new (static_cast<void*>(value + i)) mapped_type(v); }
+				catch (...) { key[i].~key_type(); throw ; }
+				++_size;
+				return ;}
+			::new (static_cast<void*>(key + _size)) key_type(key[_size - 1]);
+			try { ::new (static_cast<void*>(value + _size)) mapped_type(value[_size - 1]); }
+			catch (...) { key[_size].~key_type(); throw ; }
+			++_size;
+			for (size_type j = _size - 2; j > i; --j){
+				key[j] = key[j - 1];
+				value[j] = value[j - 1];}
+			key[i] = k;
+			value[i] = v;
+		}
+
+		void eraseAt(size_type i, size_type n) {
+			key_type*		key = keys();
+			mapped_type*	value = values();
+
+			if (n == 0)
+				return ;
+			for (size_type j = i + n; j < _size; ++j){
+				key[j - n] = key[j];
+				value[j - n] = value[j];}
+			destroyInline(_size - n);
+		}
+
+		// destroys the inline entries from index from on
+		void destroyInline(size_type from) {
+			for (; _size > from; --_size){
+				keys()[_size - 1].~key_type();
+				values()[_size - 1].~mapped_type();}
+		}
+
+		// the inline entries are sorted and unique, so the tree is built in O(N)
+		void moveToMap() {
+			allocatorMap	a;
+			map_type*		big = a.allocate(1);
+
+			try { a.construct(big, map_type(_comp, _alloc)); }
+			catch (...) { a.deallocate(big, 1); throw ; }
+			try { big->assign_sorted(begin(), end()); }
+			catch (...) {
+				a.destroy(big);
+				a.deallocate(big, 1);
+				throw ; }
+			destroyInline(0);
+			_big = big;
+		}
+
+		void copyFrom(const small_map& x) {
+			allocatorMap a;
+
+			if (x._big){
+				map_type* big = a.allocate(1);
+
+				try { a.construct(big, *x._big); }
+				catch (...) { a.deallocate(big, 1); throw ; }
+				_big = big;
+				return ;}
+			for (size_type i = 0; i < x._size; ++i)
+				insertAt(i, x.keys()[i], x.values()[i]);
+		}
+
+		// this is empty and inline: takes over x's ft::map or copies its inline entries, x ends empty
+		void take(small_map& x) {
+			if (x._big){
+				_big = x._big;
+				x._big = 0;
+				return ;}
+			copyFrom(x);
+			x.destroyInline(0);
+		}
+
+	};
+
+	template <class Key, class T, size_t N, class Compare, class Allocator>
+	void swap (small_map<Key, T, N, Compare, Allocator>& x, small_map<Key, T, N, Compare, Allocator>& y)
+	{
+		x.swap(y);
+	}
+
+}
+
+#endif
@@ -0,0 +1,317 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <istream>
+#include <ostream>
+#include <cstring>
+#include <stdexcept>
+#include <stdint.h>
+#if __cplusplus >= 201103L
+# include <type_traits>
+#endif
+#include "utils.hpp"
+#include "vector.hpp"
+#include "map.hpp"
+
+namespace ft
+{
+	// Binary snapshots of ft::map and ft::vector holding trivially copyable types.
+	// Layout, in native byte order:
+	//   header   magic "ftsnap1", type fingerprint, element count, FNV-1a checksum of the payload
+	//   payload  the elements back to back: key bytes then mapped bytes for a map, in key
+	//            order; the element bytes for a vector
+	// Loading checks the magic, the fingerprint (container kind, sizes, integral or not, byte
+	// order), the length and the checksum, and throws std::runtime_error on a mismatch.
+	// Both directions stream; a map is rebuilt in O(n) from the sorted payload.
+
+	struct snapshotHeader
+	{
+		char		magic[8];
+		uint64_t	fingerprint;
+		uint64_t	count;
+		uint64_t	checksum;
+	};
+
+	// FNV-1a, fed piece by piece
+	struct snapshotChecksum
+	{
+		uint64_t h;
+
+		snapshotChecksum(): h(0xcbf29ce484222325ULL) {}
+
+		void add(const void* p, size_t n) {
+			const unsigned char* b = static_cast<const unsigned char*>(p);
+
+			for (size_t i = 0; i < n; ++i){
+				h ^= b[i];
+				h *= 0x100000001b3ULL;}
+		}
+	};
+
+	inline uint64_t snapshotFingerprint(uint64_t kind, size_t keySize, bool keyIntegral, size_t valueSize, bool valueIntegral)
+	{
+		union { uint32_t word; unsigned char bytes[4]; } order;
+
+		order.word = 0x01020304;
+		return (hashMix(hashMix(hashMix(kind | (static_cast<uint64_t>(order.bytes[0]) << 8)
+			| (static_cast<uint64_t>(keyIntegral) << 16) | (static_cast<uint64_t>(valueIntegral) << 17)) ^ keySize) ^ valueSize));
+	}
+
+	inline void snapshotFail(const char* what) { throw std::runtime_error(std::string("ft::load_snapshot: ") + what); }
+
+	// the payload comes from a stream through a buffer, or straight from memory (an mmap'd
+	// file, say); every byte read goes through the checksum
+	class snapshotSource
+	{
+		std::istream*		_is;
+		const char*			_mem;
+		size_t				_memLeft;
+		ft::vector<char>	_buf;
+		size_t				_pos;
+		size_t				_len;
+
+	public:
+		snapshotChecksum	sum;
+
+		explicit snapshotSource(std::istream& is): _is(&is), _mem(0), _memLeft(0), _buf(1 << 16), _pos(0), _len(0) {}
+		snapshotSource(const void* data, size_t size): _is(0), _mem(static_cast<const char*>(data)), _memLeft(size), _pos(0), _len(0) {}
+
+		bool fromMemory() const { return (_is == 0); }
+		size_t memoryLeft() const { return (_memLeft); }
+
+		void header(snapshotHeader& h) {
+			raw(&h, sizeof(h));
+			if (std::memcmp(h.magic, "ftsnap1", 8) != 0)
+				snapshotFail("not a snapshot");
+		}
+
+		void read(void* dst, size_t n) {
+			raw(dst, n);
+			sum.add(dst, n);
+		}
+
+	private:
+		void raw(void* dst, size_t n) {
+			char* out = static_cast<char*>(dst);
+			size_t chunk;
+
+			if (fromMemory()){
+				if (n > _memLeft)
+					snapshotFail("truncated");
+				std::memcpy(out, _mem, n);
+				_mem += n;
+				_memLeft -= n;
+				return ;}
+			while (n){
+				if (_pos == _len){
+					if (n >= _buf.size()){ // large reads skip the buffer
+						if (!_is->read(out, n))
+							snapshotFail("truncated");
+						return ;}
+					_is->read(_buf.data(), _buf.size());
+					_len = static_cast<size_t>(_is->gcount());
+					_pos = 0;
+					if (_len == 0)
+						snapshotFail("truncated");}
+				chunk = n < _len - _pos ? n : _len - _pos;
+				std::memcpy(out, _buf.data() + _pos, chunk);
+				_pos += chunk;
+				out += chunk;
+				n -= chunk;
+			}
+		}
+	};
+
+	// decodes map records one at a time, for map::assign_sorted
+	template <class Key, class T>
+	class snapshotRecordIterator
+	{
+		public:
+			typedef ft::pair<Key, T>			value_type;
+			typedef const value_type&			reference;
+			typedef const value_type*			pointer;
+			typedef forward_iterator_tag		iterator_category;
+			typedef ptrdiff_t					difference_type;
+
+		private:
+			snapshotSource*		_src;
+			uint64_t			_left;
+			value_type			_cur;
+
+			void load() {
+				_src->read(&_cur.first, sizeof(Key));
+				_src->read(&_cur.second, sizeof(T));
+			}
+
+		public:
+			snapshotRecordIterator(snapshotSource* src = 0, uint64_t count = 0): _src(src), _left(count) {
+				if (_left)
+					load(); }
+
+			reference operator*() const { return (_cur); }
+			pointer operator->() const { return (&_cur); }
+
+			snapshotRecordIterator& operator++() {
+				if (--_left)
+					load();
+				return (*this); }
+
+			bool operator==(const snapshotRecordIterator& it) const { return (_left == it._left); }
+			bool operator!=(const snapshotRecordIterator& it) const { return !(*this == it); }
+	};
+
+	template <class T>
+	inline void snapshotRequireTrivial()
+	{
+	#if __cplusplus >= 201103L
+		static_assert(std::is_trivially_copyable<T>::value, "ft snapshots hold trivially copyable types only");
+	#endif
+	}
+
+	inline void snapshotWrite(std::ostream& os, const void* p, size_t n)
+	{
+		if (!os.write(static_cast<const char*>(p), n))
+			throw std::runtime_error("ft::save_snapshot: write failed");
+	}
+
+	// Map
+
+	template <class Key, class T, class Compare, class Allocator, class Augment, class Layout, class Balance, class Filter>
+	void save_snapshot(std::ostream& os, const map<Key, T, Compare, Allocator, Augment, Layout, Balance, Filter>& m)
+	{
+		typedef typename map<Key, T, Compare, Allocator, Augment, Layout, Balance, Filter>::const_iterator	const_iterator;
+		const size_t		record = sizeof(Key) + sizeof(T);
+		snapshotHeader		h;
+		snapshotChecksum	sum;
+		ft::vector<char>	buf((1 << 16) / record * record + record);
+		size_t				used = 0;
+
+		snapshotRequireTrivial<Key>();
+		snapshotRequireTrivial<T>();
+		for (const_iterator it = m.begin(); it != m.end(); ++it){ // the header goes first, so the checksum takes its own pass
+			sum.add(&it->first, sizeof(Key));
+			sum.add(&it->second, sizeof(T));}
+		std::memcpy(h.magic, "ftsnap1", 8);
+		h.fingerprint = snapshotFingerprint(1, sizeof(Key), is_integral<Key>::value, sizeof(T), is_integral<T>::value);
+		h.count = m.size();
+		h.checksum = sum.h;
+		snapshotWrite(os, &h, sizeof(h));
+		for (const_iterator it = m.begin(); it != m.end(); ++it){
+			std::memcpy(buf.data() + used, &it->first, sizeof(Key));
+			std::memcpy(buf.data() + used + sizeof(Key), &it->second, sizeof(T));
+			used += record;
+			if (used + record > buf.size()){
+				snapshotWrite(os, buf.data(), used);
+				used = 0;}
+		}
+		snapshotWrite(os, buf.data(), used);
+	}
+
+	template <class Key, class T, class Compare, class Allocator, class Augment, class Layout, class Balance, class Filter>
+	void loadSnapshot(snapshotSource& src, map<Key, T, Compare, Allocator, Augment, Layout, Balance, Filter>& m)
+	{
+		typedef map<Key, T, Compare, Allocator, Augment, Layout, Balance, Filter>	map_type;
+		typedef snapshotRecordIterator<Key, T>									records;
+		snapshotHeader	h;
+		map_type		loaded(m.key_comp(), m.get_allocator());
+
+		snapshotRequireTrivial<Key>();
+		snapshotRequireTrivial<T>();
+		src.header(h);
+		if (h.fingerprint != snapshotFingerprint(1, sizeof(Key), is_integral<Key>::value, sizeof(T), is_integral<T>::value))
+			snapshotFail("type mismatch");
+		if (src.fromMemory() && src.memoryLeft() / (sizeof(Key) + sizeof(T)) < h.count)
+			snapshotFail("truncated");
+		try { loaded.assign_sorted(records(&src, h.count), records(&src, 0)); }
+		catch (std::invalid_argument&) { snapshotFail("keys out of order"); }
+		if (src.sum.h != h.checksum)
+			snapshotFail("checksum mismatch");
+		m.swap(loaded);
+	}
+
+	// replaces the contents of m; O(n), nodes are allocated in key order. On a failed load
+	// m keeps what it held
+	template <class Key, class T, class Compare, class Allocator, class Augment, class Layout, class Balance, class Filter>
+	void load_snapshot(std::istream& is, map<Key, T, Compare, Allocator, Augment, Layout, Balance, Filter>& m)
+	{
+		snapshotSource src(is);
+
+		loadSnapshot(src, m);
+	}
+
+	// from a snapshot already in memory, e.g. an mmap'd file: records are decoded in place
+	template <class Key, class T, class Compare, class Allocator, class Augment, class Layout, class Balance, class Filter>
+	void load_snapshot(const void* data, size_t size, map<Key, T, Compare, Allocator, Augment, Layout, Balance, Filter>& m)
+	{
+		snapshotSource src(data, size);
+
+		loadSnapshot(src, m);
+	}
+
+	// Vector
+
+	template <class T, class Allocator>
+	void save_snapshot(std::ostream& os, const vector<T, Allocator>& v)
+	{
+		snapshotHeader		h;
+		snapshotChecksum	sum;
+
+		snapshotRequireTrivial<T>();
+		sum.add(v.data(), v.size() * sizeof(T));
+		std::memcpy(h.magic, "ftsnap1", 8);
+		h.fingerprint = snapshotFingerprint(2, 0, false, sizeof(T), is_integral<T>::value);
+		h.count = v.size();
+		h.checksum = sum.h;
+		snapshotWrite(os, &h, sizeof(h));
+		snapshotWrite(os, v.data(), v.size() * sizeof(T));
+	}
+
+	// the elements land in the vector's storage with one read from memory; a stream has no
+	// length to check the header's count against, so there the vector grows a megabyte at
+	// a time as the bytes arrive
+	template <class T, class Allocator>
+	void loadSnapshot(snapshotSource& src, vector<T, Allocator>& v)
+	{
+		snapshotHeader			h;
+		vector<T, Allocator>	loaded(v.get_allocator());
+		const size_t			chunk = sizeof(T) < (1 << 20) ? (1 << 20) / sizeof(T) : 1;
+		size_t					n;
+
+		snapshotRequireTrivial<T>();
+		src.header(h);
+		if (h.fingerprint != snapshotFingerprint(2, 0, false, sizeof(T), is_integral<T>::value))
+			snapshotFail("type mismatch");
+		if (src.fromMemory()){
+			if (src.memoryLeft() / sizeof(T) < h.count)
+				snapshotFail("truncated");
+			loaded.resize(h.count);
+			src.read(loaded.data(), h.count * sizeof(T));}
+		else
+			while (loaded.size() < h.count){
+				n = loaded.size();
+				loaded.resize(h.count - n < chunk ? h.count : n + chunk);
+				src.read(loaded.data() + n, (loaded.size() - n) * sizeof(T));}
+		if (src.sum.h != h.checksum)
+			snapshotFail("checksum mismatch");
+		v.swap(loaded);
+	}
+
+	template <class T, class Allocator>
+	void load_snapshot(std::istream& is, vector<T, Allocator>& v)
+	{
+		snapshotSource src(is);
+
+		loadSnapshot(src, v);
+	}
+
+	template <class T, class Allocator>
+	void load_snapshot(const void* data, size_t size, vector<T, Allocator>& v)
+	{
+		snapshotSource src(data, size);
+
+		loadSnapshot(src, v);
+	}
+
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define STACK_HPP
 #include "vector.hpp"
 #include <deque>
+#include <utility>
 
 namespace ft
 {
@@ -20,6 +21,14 @@ namespace ft
 		
 		explicit stack (const container_type& ctnr = container_type()): _c(ctnr){}; //создание нового объекта референса  = вызов конструктора, если аргумент пустой
 	
+#if __cplusplus >= 201103L
+		// the virtual destructor suppresses the implicit move members, so spell them out
+		stack (const stack& other): _c(other._c){};
+		stack (stack&& other): _c(std::move(other._c)){};
+		stack &operator=(const stack& other){ _c = other._c; return (*this); };
+		stack &operator=(stack&& other){ _c = std::move(other._c); return (*this); };
+#endif
+
 		virtual ~stack(){};
 
 		bool empty() const
@@ -0,0 +1,107 @@
+// apply_batch against the same ops applied one by one to std::map, with and without the
+// per-op results, for dense batches (searched from the finger) and sparse ones (from the
+// root), under every balancing scheme and with summaries that read the values
+#include <map>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include "map.hpp"
+
+struct byKey
+{
+	template <class Op>
+	bool operator()(const Op& a, const Op& b) const { return (a.key < b.key); }
+};
+
+template <class M>
+static void run(const char* name)
+{
+	typedef typename M::batch_op op;
+
+	for (int round = 0; round < 300; ++round){
+		M					m;
+		std::map<int, int>	s;
+		std::vector<op>		ops;
+		std::vector<bool>	expect;
+		std::vector<bool>	got;
+		int					range = 50 + rand() % 4000;
+		int					fill = rand() % 3000;
+		int					n = rand() % (round % 3 ? 600 : 20);
+
+		for (int i = 0; i < fill; ++i){
+			int k = rand() % range;
+			m[k] = i;
+			s[k] = i;}
+		for (int i = 0; i < n; ++i){
+			int k = rand() % range;
+			if (rand() % 3 == 0)
+				ops.push_back(op(k));
+			else
+				ops.push_back(op(k, rand()));}
+		std::stable_sort(ops.begin(), ops.end(), byKey());
+		for (size_t i = 0; i < ops.size(); ++i){
+			if (ops[i].erase)
+				expect.push_back(s.erase(ops[i].key) == 1);
+			else {
+				expect.push_back(s.find(ops[i].key) == s.end());
+				s[ops[i].key] = ops[i].value;}
+		}
+		if (round & 1){
+			m.apply_batch(ops.begin(), ops.end(), std::back_inserter(got));
+			assert(got == expect);}
+		else
+			m.apply_batch(ops.begin(), ops.end());
+		assert(m.size() == s.size());
+		std::map<int, int>::iterator si = s.begin();
+		for (typename M::iterator it = m.begin(); it != m.end(); ++it, ++si)
+			assert(it->first == si->first && it->second == si->second);
+		m[-1] = 0; // the tree is still sound for plain updates
+		assert(m.erase(-1) == 1 && m.size() == s.size());
+	}
+	printf("%s ok\n", name);
+}
+
+int main()
+{
+	typedef std::allocator<ft::pair<const int, int> >							A;
+	typedef ft::map<int, int, std::less<int>, A, ft::range_aggregate<long> >	aggregated;
+
+	srand(8);
+	run<ft::map<int, int> >("red_black");
+	run<ft::map<int, int, std::less<int>, A, ft::order_statistics, ft::split_values, ft::avl> >("avl split_values");
+	run<ft::map<int, int, std::less<int>, A, ft::range_aggregate<long>, ft::inline_values, ft::wavl> >("wavl");
+
+	// updates in place refresh the summaries
+	aggregated						a;
+	std::vector<aggregated::batch_op>	ops;
+	long							sum = 0;
+	for (int i = 0; i < 1000; ++i)
+		a[i] = 1;
+	for (int i = 0; i < 1000; i += 3)
+		ops.push_back(aggregated::batch_op(i, 5));
+	a.apply_batch(ops.begin(), ops.end());
+	for (aggregated::iterator it = a.begin(); it != a.end(); ++it)
+		sum += it->second;
+	assert(a.aggregate(0, 1000).sum == sum);
+
+	// unsorted input changes nothing
+	std::vector<aggregated::batch_op> bad;
+	bad.push_back(aggregated::batch_op(5, 1));
+	bad.push_back(aggregated::batch_op(3, 1));
+	try {
+		a.apply_batch(bad.begin(), bad.end());
+		assert(0);}
+	catch (std::invalid_argument&) {}
+	assert(a.size() == 1000 && a[5] == 1);
+
+	ft::map<int, int>							e;
+	std::vector<ft::map<int, int>::batch_op>	none;
+	e.apply_batch(none.begin(), none.end());
+	assert(e.empty());
+	printf("apply_batch ok\n");
+	return (0);
+}
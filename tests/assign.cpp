@@ -0,0 +1,98 @@
+// copy assignment of map and vector reuses the target's nodes and buffer: once the target
+// has held as many entries, assigning allocates nothing (operator new is counted)
+#include <map>
+#include <new>
+#include <string>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include "map.hpp"
+#include "vector.hpp"
+
+static size_t g_allocations;
+
+void* operator new(size_t n)
+{
+	void* p = malloc(n);
+
+	++g_allocations;
+	if (!p)
+		throw std::bad_alloc();
+	return (p);
+}
+
+void operator delete(void* p) throw() { free(p); }
+void operator delete(void* p, size_t) throw() { free(p); }
+
+template <class M>
+static void fill(M& m, int n, int seed)
+{
+	char b[16];
+
+	m.clear();
+	for (int i = 0; i < n; ++i){
+		sprintf(b, "v%d", (i * 7 + seed) % 10007); // short enough to stay inside std::string
+		m[(i * 31 + seed) % 5003] = b;}
+}
+
+template <class M>
+static void run(const char* name)
+{
+	M		a, b, c;
+	size_t	before;
+
+	fill(a, 1000, 1);
+	fill(b, 1000, 2);
+	fill(c, 600, 3);
+	M x(a);
+	assert(x == a);
+	for (int round = 0; round < 20; ++round){
+		before = g_allocations;
+		x = b;
+		x = a;
+		x = c; // fewer entries: the spare nodes are freed
+		assert(g_allocations == before);
+		assert(x == c);
+		x = a;
+		assert(x == a && g_allocations > before);
+	}
+	// x holds as many entries as a or b, so from now on assignments allocate nothing
+	before = g_allocations;
+	for (int round = 0; round < 50; ++round){
+		x = round & 1 ? a : b;
+		assert(x == (round & 1 ? a : b));}
+	x = x;
+	assert(g_allocations == before && x == a);
+	x = M();
+	assert(x.empty());
+	printf("%s ok\n", name);
+}
+
+int main()
+{
+	typedef std::allocator<ft::pair<const int, std::string> > A;
+
+	run<ft::map<int, std::string> >("map");
+	run<ft::map<int, std::string, std::less<int>, A, ft::order_statistics, ft::split_values, ft::avl> >("map order_statistics split_values avl");
+
+	ft::vector<int>			v(100000, 1);
+	ft::vector<int>			w(50000, 2);
+	ft::vector<std::string>	s(1000, "short");
+	ft::vector<std::string>	t(800, "other");
+	ft::vector<int>			x(v);
+	ft::vector<std::string>	y(s);
+	size_t					before = g_allocations;
+
+	for (int round = 0; round < 50; ++round){
+		x = w;
+		assert(x == w);
+		x = v;
+		assert(x == v);
+		y = t;
+		assert(y == t);
+		y = s;
+		assert(y == s);}
+	assert(g_allocations == before);
+	printf("vector ok\n");
+	return (0);
+}
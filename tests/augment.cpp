@@ -0,0 +1,149 @@
+// the node summaries against brute force over std::map: nth, rank, index_of and distance with
+// ft::order_statistics, and aggregate(lo, hi) with ft::range_aggregate, through inserts,
+// erases of single keys and ranges, and mapped values changed in place then refresh()ed;
+// under each balancing scheme, as rotations rebuild the summaries on their own paths
+#include <map>
+#include <climits>
+#include <iterator>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include "map.hpp"
+
+typedef std::map<int, long> S;
+
+template <class M>
+static void orderStatistics(const M& m, const S& s)
+{
+	size_t i = 0;
+
+	assert(m.size() == s.size());
+	for (S::const_iterator j = s.begin(); j != s.end(); ++j, ++i){
+		typename M::const_iterator it = m.nth(i);
+
+		assert(it->first == j->first && it->second == j->second);
+		assert(m.rank(j->first) == i);
+		assert(m.index_of(it) == i);}
+	assert(m.nth(i) == m.end() && m.index_of(m.end()) == m.size());
+	assert(m.distance(m.begin(), m.end()) == static_cast<long>(m.size()));
+	if (!s.empty()){
+		size_t a = rand() % s.size(), b = rand() % s.size();
+
+		assert(m.distance(m.nth(a), m.nth(b)) == static_cast<long>(b) - static_cast<long>(a));}
+}
+
+// rank of keys between and around the entries
+template <class M>
+static void ranks(const M& m, const S& s, int range)
+{
+	for (int k = -1; k <= range + 1; ++k){
+		size_t below = 0;
+
+		for (S::const_iterator j = s.begin(); j != s.end() && j->first < k; ++j)
+			++below;
+		assert(m.rank(k) == below);}
+}
+
+// order_statistics summarizes the count alone
+static void sameSummary(const ft::order_statistics::summary& a, size_t count, long, long, long)
+{
+	assert(a.count == count);
+}
+
+static void sameSummary(const ft::range_aggregate<long>::summary& a, size_t count, long sum, long mn, long mx)
+{
+	assert(a.count == count);
+	if (count)
+		assert(a.sum == sum && a.min == mn && a.max == mx);
+}
+
+template <class M>
+static void aggregates(const M& m, const S& s, int range)
+{
+	for (int q = 0; q < 40; ++q){
+		int							lo = rand() % (range + 4) - 2;
+		int							hi = lo + rand() % (range / 2 + 2) - 1;
+		size_t						count = 0;
+		long						sum = 0, mn = LONG_MAX, mx = LONG_MIN;
+		typename M::summary_type	a = m.aggregate(lo, hi);
+
+		for (S::const_iterator j = s.lower_bound(lo); j != s.end() && j->first < hi; ++j){
+			++count;
+			sum += j->second;
+			mn = j->second < mn ? j->second : mn;
+			mx = j->second > mx ? j->second : mx;}
+		sameSummary(a, count, sum, mn, mx);}
+	assert(m.aggregate(0, range).count == static_cast<size_t>(std::distance(s.lower_bound(0), s.lower_bound(range))));
+}
+
+template <class M>
+static void run(int range)
+{
+	M	m;
+	S	s;
+
+	for (int round = 0; round < 4000; ++round){
+		int k = rand() % range;
+		int op = rand() % 10;
+
+		if (op < 4){
+			// operator[] would hand out the value after the summaries saw mapped_type()
+			long								v = rand() % 1000 - 500;
+			ft::pair<typename M::iterator, bool>	r = m.insert(ft::make_pair(k, v));
+
+			if (!r.second){
+				r.first->second = v;
+				m.refresh(r.first);}
+			s[k] = v;}
+		else if (op < 7)
+			assert(m.erase(k) == s.erase(k));
+		else if (op == 7 && !s.empty()){
+			// a mapped value changed through an iterator is seen once refreshed
+			typename M::iterator	it = m.nth(rand() % m.size());
+			long					v = rand() % 1000 - 500;
+
+			it->second = v;
+			m.refresh(it);
+			s[it->first] = v;}
+		else if (op == 8 && rand() % 8 == 0 && !s.empty()){
+			size_t a = rand() % s.size(), b = a + rand() % (s.size() - a + 1);
+			S::iterator	sa = s.begin(), sb = s.begin();
+
+			std::advance(sa, a);
+			std::advance(sb, b);
+			m.erase(m.nth(a), m.nth(b));
+			s.erase(sa, sb);}
+		else if (op == 9 && !s.empty()){
+			typename M::iterator it = m.nth(rand() % m.size());
+
+			s.erase(it->first);
+			m.erase(it);}
+		if (round % 100 == 0){
+			orderStatistics(m, s);
+			ranks(m, s, range);
+			aggregates(m, s, range);}
+	}
+	orderStatistics(m, s);
+	aggregates(m, s, range);
+}
+
+template <class Balance>
+static void schemes()
+{
+	typedef std::allocator<ft::pair<const int, long> > A;
+
+	run<ft::map<int, long, std::less<int>, A, ft::order_statistics, ft::inline_values, Balance> >(50);
+	run<ft::map<int, long, std::less<int>, A, ft::order_statistics, ft::inline_values, Balance> >(2000);
+	run<ft::map<int, long, std::less<int>, A, ft::range_aggregate<long>, ft::inline_values, Balance> >(50);
+	run<ft::map<int, long, std::less<int>, A, ft::range_aggregate<long>, ft::split_values, Balance> >(2000);
+}
+
+int main()
+{
+	srand(19);
+	schemes<ft::red_black>();
+	schemes<ft::avl>();
+	schemes<ft::wavl>();
+	printf("augment ok\n");
+	return (0);
+}
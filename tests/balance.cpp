@@ -0,0 +1,185 @@
+// the red_black, avl and wavl invariants checked node by node through inserts, erases, range
+// erase, split, the set operations, bulk_insert and merge, against std::map for the contents
+#include <map>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <stdexcept>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#define private public // the checker walks the nodes
+#include "map.hpp"
+#undef private
+
+enum { RB, AVL, WAVL };
+
+// returns the black height for red_black, the rank for avl and wavl (nil is -1)
+template <class T, class N>
+static int check(const T& t, const N* x, int scheme, size_t& count)
+{
+	const N*	nil = t._nil;
+	int			l, r, dl, dr, rank;
+
+	if (x == nil)
+		return (-1);
+	++count;
+	if (x->left != nil)
+		assert(x->left->parent() == x && t._compare(x->left->key(), x->key()));
+	if (x->right != nil)
+		assert(x->right->parent() == x && t._compare(x->key(), x->right->key()));
+	l = check(t, x->left, scheme, count);
+	r = check(t, x->right, scheme, count);
+	if (scheme == RB){
+		if (x->color() == RED)
+			assert(x->left->color() == BLACK && x->right->color() == BLACK);
+		assert(l == r);
+		return (l + (x->color() == BLACK));}
+	// the bit is the parity of rank + 1, so equal bits mean a rank difference of 2
+	dl = x->color() != x->left->color() ? 1 : 2;
+	dr = x->color() != x->right->color() ? 1 : 2;
+	rank = l + dl;
+	assert(rank == r + dr);
+	assert(((rank + 1) & 1) == x->color());
+	if (scheme == AVL)
+		assert(!(dl == 2 && dr == 2));
+	else if (x->left == nil && x->right == nil)
+		assert(rank == 0); // wavl leaves have rank 0
+	return (rank);
+}
+
+template <class M>
+static void invariants(const M& m, int scheme)
+{
+	size_t count = 0;
+
+	assert(m._tree._nil->color() == 0 && m._tree._nil->left == m._tree._root);
+	if (m._tree._root != m._tree._nil)
+		assert(m._tree._root->parent() == m._tree._nil);
+	check(m._tree, m._tree._root, scheme, count);
+	assert(count == m.size());
+	if (scheme == RB && count)
+		assert(m._tree._root->color() == BLACK);
+	for (size_t i = 0; i < m.size(); i += 13)
+		assert(m.rank(m.nth(i)->first) == i);
+}
+
+template <class M>
+static void same(const M& m, const std::map<int, int>& s)
+{
+	std::map<int, int>::const_iterator si = s.begin();
+
+	assert(m.size() == s.size());
+	for (typename M::const_iterator it = m.begin(); it != m.end(); ++it, ++si)
+		assert(it->first == si->first && it->second == si->second);
+}
+
+template <class B>
+static void run(int scheme)
+{
+	typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, ft::order_statistics,
+		ft::inline_values, B> M;
+
+	for (int round = 0; round < 30; ++round){
+		M					m;
+		std::map<int, int>	s;
+		int					range = 10 + rand() % 2000;
+
+		for (int i = 0; i < 3000; ++i){
+			int k = rand() % range;
+
+			if (rand() % 3){
+				m.insert(ft::make_pair(k, i));
+				s.insert(std::make_pair(k, i));}
+			else
+				assert(m.erase(k) == s.erase(k));
+			if (i % 97 == 0)
+				invariants(m, scheme);
+		}
+		invariants(m, scheme);
+		same(m, s);
+
+		int a = rand() % range;
+		int b = a + rand() % range;
+		m.erase(m.lower_bound(a), m.lower_bound(b));
+		s.erase(s.lower_bound(a), s.lower_bound(b));
+		invariants(m, scheme);
+		same(m, s);
+
+		M g;
+		m.split(rand() % range, g);
+		invariants(m, scheme);
+		invariants(g, scheme);
+		assert(m.size() + g.size() == s.size());
+
+		M					o;
+		std::map<int, int>	so;
+		for (int i = 0; i < 500; ++i){
+			int k = rand() % (2 * range);
+			o.insert(ft::make_pair(k, -i));
+			so.insert(std::make_pair(k, -i));}
+		m.set_union(g);
+		invariants(m, scheme);
+		same(m, s);
+		M					u(m);
+		std::map<int, int>	su(s);
+		u.set_union(o);
+		su.insert(so.begin(), so.end());
+		invariants(u, scheme);
+		same(u, su);
+		M in(m);
+		M out(m);
+		in.set_intersection(o);
+		out.set_difference(o);
+		invariants(in, scheme);
+		invariants(out, scheme);
+		assert(in.size() + out.size() == m.size());
+
+		M e;
+		m.extract_range(m.lower_bound(range / 4), m.lower_bound(range / 2), e);
+		invariants(m, scheme);
+		invariants(e, scheme);
+
+		std::vector<ft::pair<int, int> > batch;
+		for (int i = 0; i < 5000; ++i)
+			batch.push_back(ft::make_pair(rand() % (3 * range), i));
+		M bm;
+		bm.bulk_insert(batch.begin(), batch.end(), 2);
+		invariants(bm, scheme);
+		for (int i = 0; i < 3000; ++i){
+			bm.erase(rand() % (3 * range));
+			if (i % 211 == 0)
+				invariants(bm, scheme);}
+		for (int i = 0; i < 3000; ++i){
+			bm.insert(ft::make_pair(rand() % (3 * range), 1));
+			if (i % 211 == 0)
+				invariants(bm, scheme);}
+		M mg;
+		mg.merge(bm);
+		invariants(mg, scheme);
+		invariants(bm, scheme);
+		while (!mg.empty()){
+			mg.erase(mg.begin());
+			if (mg.size() % 101 == 0)
+				invariants(mg, scheme);}
+	}
+
+	// sequential keys, the worst case for rebalancing
+	M q;
+	for (int i = 0; i < 100000; ++i)
+		q.insert(ft::make_pair(i, i));
+	invariants(q, scheme);
+	for (int i = 0; i < 100000; i += 2)
+		q.erase(i);
+	invariants(q, scheme);
+}
+
+int main()
+{
+	srand(4);
+	run<ft::red_black>(RB);
+	run<ft::avl>(AVL);
+	run<ft::wavl>(WAVL);
+	printf("balance ok\n");
+	return (0);
+}
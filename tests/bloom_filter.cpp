@@ -0,0 +1,231 @@
+// map with a bloom_filter against std::map through every operation that adds or drops keys
+// behind the filter's back (merge, set operations, split, batches, node handles, moves),
+// then the false positive rate at the default 10 bits per key
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include "map.hpp"
+
+typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >,
+	ft::no_augment, ft::inline_values, ft::red_black, ft::bloom_filter>	F;
+typedef std::map<int, int>											S;
+
+// every key in range asked through find and count, so a missing filter bit shows up
+static void same(F& m, const S& s, int range)
+{
+	S::const_iterator si = s.begin();
+
+	assert(m.size() == s.size());
+	for (F::iterator it = m.begin(); it != m.end(); ++it, ++si)
+		assert(it->first == si->first && it->second == si->second);
+	for (int k = -5; k < range + 5; ++k){
+		assert(m.count(k) == s.count(k));
+		assert((m.find(k) == m.end()) == (s.find(k) == s.end()));}
+}
+
+static void fill(F& m, S& s, int range, int n)
+{
+	for (int i = 0; i < n; ++i){
+		int k = rand() % range;
+		m[k] = i;
+		s[k] = i;}
+}
+
+struct byKey
+{
+	bool operator()(const F::batch_op& a, const F::batch_op& b) const { return (a.key < b.key); }
+};
+
+static void step(F& m, S& s, int range, int i)
+{
+	int k = rand() % range;
+
+	switch (rand() % 16){
+	case 0:
+		m.insert(ft::make_pair(k, i));
+		s.insert(std::make_pair(k, i));
+		break ;
+	case 1:
+		m[k] = i;
+		s[k] = i;
+		break ;
+	case 2:
+		assert(m.erase(k) == s.erase(k));
+		break ;
+	case 3: {
+		F::iterator it = m.find(k);
+		if (it != m.end()){
+			m.erase(it);
+			s.erase(k);}
+		break ; }
+	case 4: {
+		int b = k + rand() % 50;
+		m.erase(m.lower_bound(k), m.lower_bound(b));
+		s.erase(s.lower_bound(k), s.lower_bound(b));
+		break ; }
+	case 5: {
+		F o;
+		S os, left;
+
+		fill(o, os, range, rand() % 60);
+		if (rand() % 2){
+			for (S::iterator it = os.begin(); it != os.end(); ++it)
+				if (s.count(it->first))
+					left.insert(*it);
+			m.merge(o);
+			s.insert(os.begin(), os.end());
+			same(o, left, range);}
+		else {
+			m.set_union(o);
+			s.insert(os.begin(), os.end());
+			assert(o.empty());}
+		break ; }
+	case 6: {
+		F o;
+		S os;
+
+		fill(o, os, range, rand() % 200);
+		if (rand() % 2){
+			S r;
+			m.set_intersection(o);
+			for (S::iterator it = s.begin(); it != s.end(); ++it)
+				if (os.count(it->first))
+					r.insert(*it);
+			s.swap(r);}
+		else {
+			m.set_difference(o);
+			for (S::iterator it = os.begin(); it != os.end(); ++it)
+				s.erase(it->first);}
+		break ; }
+	case 7: {
+		F g;
+		S gs(s.lower_bound(k), s.end());
+
+		m.split(k, g);
+		s.erase(s.lower_bound(k), s.end());
+		same(g, gs, range);
+		m.merge(g);
+		s.insert(gs.begin(), gs.end());
+		break ; }
+	case 8: {
+		F	g;
+		int	b = k + rand() % 100;
+		S	gs(s.lower_bound(k), s.lower_bound(b));
+
+		m.extract_range(m.lower_bound(k), m.lower_bound(b), g);
+		s.erase(s.lower_bound(k), s.lower_bound(b));
+		same(g, gs, range);
+		break ; }
+	case 9: {
+		std::vector<F::batch_op> ops;
+
+		for (int j = rand() % 80; j > 0; --j){
+			int x = rand() % range;
+			ops.push_back(rand() % 3 ? F::batch_op(x, j) : F::batch_op(x));}
+		std::stable_sort(ops.begin(), ops.end(), byKey());
+		m.apply_batch(ops.begin(), ops.end());
+		for (size_t j = 0; j < ops.size(); ++j){
+			if (ops[j].erase)
+				s.erase(ops[j].key);
+			else
+				s[ops[j].key] = ops[j].value;}
+		break ; }
+	case 10: {
+		std::vector<ft::pair<int, int> > v;
+
+		for (int j = rand() % 100; j > 0; --j)
+			v.push_back(ft::make_pair(rand() % range, j));
+		m.bulk_insert(v.begin(), v.end());
+		for (size_t j = 0; j < v.size(); ++j)
+			s.insert(std::make_pair(v[j].first, v[j].second));
+		break ; }
+	case 11: {
+		F::node_handle nh = m.extract(k);
+		if (!nh.empty()){
+			s.erase(k);
+			if (rand() % 2){
+				s[k] = nh.mapped();
+				m.insert(std::move(nh));}}
+		break ; }
+	case 12:
+		if (rand() % 8 == 0){
+			m.clear();
+			s.clear();}
+		break ;
+	case 13: {
+		F c(m), d;
+
+		same(c, s, range);
+		d = m;
+		same(d, s, range);
+		F e(std::move(c));
+		same(e, s, range);
+		// the moved-from map keeps no filter bits and takes new keys
+		assert(c.empty() && c.filter_stats().bits == 0);
+		c[k] = i;
+		assert(c.count(k) == 1 && c.count(k + 1) == 0);
+		d = std::move(e);
+		assert(e.empty() && e.filter_stats().bits == 0);
+		same(d, s, range);
+		m.swap(d);
+		same(m, s, range);
+		break ; }
+	case 14:
+		m.insert(m.lower_bound(k), ft::make_pair(k, i));
+		s.insert(std::make_pair(k, i));
+		break ;
+	case 15: {
+		std::vector<ft::pair<int, int> > v;
+
+		for (int x = 0; x < range; x += 1 + rand() % 5)
+			v.push_back(ft::make_pair(x, x));
+		m.assign_sorted(v.begin(), v.end());
+		s.clear();
+		for (size_t j = 0; j < v.size(); ++j)
+			s.insert(std::make_pair(v[j].first, v[j].second));
+		break ; }
+	}
+}
+
+static void differential()
+{
+	for (int round = 0; round < 300; ++round){
+		int	range = 20 + rand() % 600;
+		F	m;
+		S	s;
+
+		if (round % 5 == 0)
+			m.filter_bits_per_key(1 + rand() % 16);
+		for (int i = 0; i < 40; ++i){
+			step(m, s, range, i);
+			same(m, s, range);}
+	}
+}
+
+static void falsePositives()
+{
+	F					m;
+	ft::filter_stats	before, after;
+
+	for (int i = 0; i < 100000; ++i)
+		m[i * 2] = i;
+	before = m.filter_stats();
+	for (int i = 0; i < 100000; ++i)
+		assert(m.count(i * 2 + 1) == 0);
+	after = m.filter_stats();
+	assert(after.lookups - before.lookups == 100000);
+	assert(after.rejected - before.rejected + after.false_positives - before.false_positives == 100000);
+	assert(after.false_positives - before.false_positives < 3000);
+}
+
+int main()
+{
+	srand(7);
+	differential();
+	falsePositives();
+	printf("bloom_filter ok\n");
+	return (0);
+}
@@ -0,0 +1,85 @@
+// btree_map against std::map: random inserts, erases, bounds and range erase at several
+// node sizes (small nodes split and merge often)
+#include <map>
+#include <string>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include "btree_map.hpp"
+
+template <class M>
+void run(int range, int ops)
+{
+	M					m;
+	std::map<int, int>	s;
+
+	for (int i = 0; i < ops; ++i){
+		int k = rand() % range;
+		int op = rand() % 4;
+
+		if (op < 2){
+			m[k] = i;
+			s[k] = i;}
+		else if (op == 2)
+			assert(m.erase(k) == s.erase(k));
+		else {
+			typename M::iterator			a = m.lower_bound(k);
+			std::map<int, int>::iterator	b = s.lower_bound(k);
+			typename M::iterator			u = m.upper_bound(k);
+			std::map<int, int>::iterator	v = s.upper_bound(k);
+
+			assert((a == m.end()) == (b == s.end()));
+			if (b != s.end())
+				assert(a->first == b->first && a->second == b->second);
+			assert((u == m.end()) == (v == s.end()));
+			if (v != s.end())
+				assert(u->first == v->first);
+			if (a != m.end() && rand() % 8 == 0){
+				typename M::iterator			e = a;
+				std::map<int, int>::iterator	f = b;
+				for (int j = 0; j < 5 && e != m.end(); ++j, ++e, ++f)
+					;
+				m.erase(a, e);
+				s.erase(b, f);}
+		}
+		assert(m.size() == s.size());
+	}
+	std::map<int, int>::iterator si = s.begin();
+	for (typename M::iterator it = m.begin(); it != m.end(); ++it, ++si)
+		assert(it->first == si->first && it->second == si->second);
+	assert(si == s.end());
+	std::map<int, int>::reverse_iterator rs = s.rbegin();
+	for (typename M::reverse_iterator it = m.rbegin(); it != m.rend(); ++it, ++rs)
+		assert((*it).first == rs->first);
+	M c(m);
+	M d;
+	assert(c == m);
+	d = c;
+	assert(d == m && !(d < m));
+	d.erase(d.begin(), d.end());
+	assert(d.empty());
+}
+
+int main()
+{
+	typedef std::allocator<ft::pair<const int, int> > A;
+
+	srand(2);
+	run<ft::btree_map<int, int, std::less<int>, A, 16> >(200, 20000);
+	run<ft::btree_map<int, int, std::less<int>, A, 16> >(5000, 100000);
+	run<ft::btree_map<int, int> >(50000, 300000);
+	run<ft::btree_map<int, int, std::less<int>, A, 64> >(3000, 100000);
+
+	ft::btree_map<std::string, std::string> ss;
+	for (int i = 0; i < 1000; ++i){
+		char b[16];
+		sprintf(b, "%d", i);
+		ss[b] = b;}
+	for (int i = 0; i < 500; ++i){
+		char b[16];
+		sprintf(b, "%d", i * 2);
+		ss.erase(b);}
+	assert(ss.size() == 500);
+	printf("btree_map ok\n");
+	return (0);
+}
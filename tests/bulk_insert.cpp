@@ -0,0 +1,129 @@
+// bulk_insert against insert one by one into std::map: duplicate keys in the input (the first
+// one wins), keys already in the map (the present value wins), empty and one-entry inputs,
+// inputs from a list, and 1 to 8 sorting threads; the rebuilt tree then takes more inserts
+// and erases, and its order statistics and filter agree with the contents
+#include <map>
+#include <list>
+#include <vector>
+#include <utility>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include "map.hpp"
+
+typedef std::map<int, int>					S;
+typedef std::vector<std::pair<int, int> >	input;
+
+template <class M>
+static void same(const M& m, const S& s)
+{
+	S::const_iterator	j = s.begin();
+
+	for (typename M::const_iterator i = m.begin(); i != m.end(); ++i, ++j)
+		assert(j != s.end() && i->first == j->first && i->second == j->second);
+	assert(j == s.end() && m.size() == s.size());
+}
+
+template <class M>
+static void ordered(const M& m, const S& s)
+{
+	size_t i = 0;
+
+	for (S::const_iterator j = s.begin(); j != s.end(); ++j, ++i)
+		assert(m.nth(i)->first == j->first && m.rank(j->first) == i && m.count(j->first) == 1);
+	assert(m.nth(i) == m.end());
+}
+
+// no order statistics to check
+static void ordered(const ft::map<int, int>&, const S&) {}
+
+// the input's values record their position, so which duplicate won shows
+static input make(size_t n, int range)
+{
+	input in;
+
+	for (size_t i = 0; i < n; ++i)
+		in.push_back(std::make_pair(rand() % range, static_cast<int>(i) + 1000000));
+	return (in);
+}
+
+template <class M>
+static void once(size_t present, size_t n, int range, unsigned threads)
+{
+	M		m;
+	S		s;
+	input	in = make(n, range);
+
+	for (size_t i = 0; i < present; ++i){
+		int k = rand() % range;
+
+		m.insert(ft::make_pair(k, -k));
+		s.insert(std::make_pair(k, -k));}
+	m.bulk_insert(in.begin(), in.end(), threads);
+	for (size_t i = 0; i < in.size(); ++i)
+		s.insert(in[i]);
+	same(m, s);
+	ordered(m, s);
+	for (int i = 0; i < 200; ++i){
+		int k = rand() % (range + 10);
+
+		if (i % 2){
+			m.insert(ft::make_pair(k, i));
+			s.insert(std::make_pair(k, i));}
+		else
+			assert(m.erase(k) == s.erase(k));}
+	same(m, s);
+	ordered(m, s);
+}
+
+template <class M>
+static void run()
+{
+	static const unsigned threads[] = { 0, 1, 2, 8 };
+
+	for (size_t t = 0; t < sizeof(threads) / sizeof(*threads); ++t){
+		unsigned th = threads[t];
+
+		once<M>(0, 0, 10, th);
+		once<M>(5, 0, 10, th);
+		once<M>(0, 1, 10, th);
+		once<M>(1, 1, 1, th);
+		// many duplicates, into an empty and a full map
+		once<M>(0, 1000, 50, th);
+		once<M>(40, 1000, 50, th);
+		// few duplicates, large enough to be sorted in two or more slices
+		if (th == 1 || th == 8){
+			once<M>(0, 70000, 1 << 30, th);
+			once<M>(20000, 70000, 100000, th);
+			once<M>(20000, 10, 100000, th);}}
+	// from a list, with the keys of the map interleaved
+	{
+		M								m;
+		S								s;
+		std::list<ft::pair<int, int> >	in;
+
+		for (int i = 0; i < 1000; ++i){
+			m.insert(ft::make_pair(i * 2, i));
+			s.insert(std::make_pair(i * 2, i));
+			in.push_back(ft::make_pair(i, -i));
+			in.push_back(ft::make_pair(i, -i - 1));}
+		m.bulk_insert(in.begin(), in.end());
+		for (std::list<ft::pair<int, int> >::iterator it = in.begin(); it != in.end(); ++it)
+			s.insert(std::make_pair(it->first, it->second));
+		same(m, s);
+		for (int i = 1; i < 1000; i += 2)
+			assert(m.find(i)->second == -i);
+	}
+}
+
+int main()
+{
+	typedef std::allocator<ft::pair<const int, int> > A;
+
+	srand(29);
+	run<ft::map<int, int> >();
+	run<ft::map<int, int, std::less<int>, A, ft::order_statistics, ft::inline_values, ft::avl> >();
+	run<ft::map<int, int, std::less<int>, A, ft::range_aggregate<long>, ft::split_values, ft::wavl, ft::bloom_filter> >();
+	printf("bulk_insert ok\n");
+	return (0);
+}
@@ -0,0 +1,205 @@
+// map::compact against std::map: maps too small to pack and maps spanning many block
+// segments, in every node layout; then inserts, erases, node handles and merges around the
+// compacted nodes, a second compact over a half-packed map, allocation failures part way
+// through, and the block memory going through (and back to) the map's own allocator
+#include <map>
+#include <new>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include "map.hpp"
+
+static long		g_countdown = -1;
+static size_t	g_bytes;	// held from countingAllocator
+
+template <class T>
+struct countingAllocator: public std::allocator<T>
+{
+	template <class U> struct rebind { typedef countingAllocator<U> other; };
+
+	countingAllocator() {}
+	countingAllocator(const countingAllocator&): std::allocator<T>() {}
+	template <class U> countingAllocator(const countingAllocator<U>&) {}
+
+	T* allocate(size_t n, const void* = 0) {
+		if (g_countdown > 0 && --g_countdown == 0)
+			throw std::bad_alloc();
+		g_bytes += n * sizeof(T);
+		return (std::allocator<T>::allocate(n)); }
+	void deallocate(T* p, size_t n) {
+		g_bytes -= n * sizeof(T);
+		std::allocator<T>::deallocate(p, n); }
+};
+
+typedef countingAllocator<ft::pair<const int, int> >	alloc_type;
+typedef std::map<int, int>								ref;
+
+template <class M>
+static void same(const M& m, const ref& s)
+{
+	ref::const_iterator j = s.begin();
+
+	for (typename M::const_iterator i = m.begin(); i != m.end(); ++i, ++j)
+		assert(j != s.end() && i->first == j->first && i->second == j->second);
+	assert(j == s.end() && m.size() == s.size());
+}
+
+// how many nodes live in a block
+template <class M>
+static size_t packedNodes(M& m)
+{
+	size_t n = 0;
+
+	for (typename M::iterator i = m.begin(); i != m.end(); ++i)
+		n += i.base()->packed();
+	return (n);
+}
+
+template <class M>
+static void churn(M& m, ref& s, int n, int rounds)
+{
+	for (int i = 0; i < rounds; ++i){
+		int k = rand() % (n * 2 + 1);
+
+		if (rand() % 2){
+			m[k] = i;
+			s[k] = i;}
+		else
+			assert(m.erase(k) == s.erase(k));}
+}
+
+template <class M>
+static void run(int n)
+{
+	M		m, other;
+	ref		s, t, left;
+	size_t	packed;
+
+	for (int i = 0; i < n; ++i){
+		int k = rand() % (n * 2 + 1);
+		m[k] = i;
+		s[k] = i;}
+	m.compact();
+	same(m, s);
+	packed = packedNodes(m);
+	assert(packed == 0 || packed == m.size());
+	// nodes inserted after compact() come from the allocator, erased packed ones go back to
+	// their block
+	churn(m, s, n, n + 10);
+	same(m, s);
+	// half packed, half not: compacting again moves both kinds and frees the old block
+	m.compact();
+	same(m, s);
+	churn(m, s, n, n / 2 + 10);
+	// packed nodes moved into another map outlive the map they were compacted in
+	for (int i = 0; i < 4 && !m.empty(); ++i){
+		typename M::iterator it = m.begin();
+
+		for (int j = rand() % static_cast<int>(m.size()); j > 0; --j)
+			++it;
+		t[it->first] = it->second;
+		s.erase(it->first);
+		other.insert(m.extract(it));}
+	if (!m.empty()){
+		other[m.begin()->first] = -1;
+		t[m.begin()->first] = -1;}
+	// merge leaves the keys other already has behind
+	for (ref::iterator it = s.begin(); it != s.end(); ++it)
+		if (t.count(it->first))
+			left.insert(*it);
+		else
+			t.insert(*it);
+	other.merge(m);
+	same(m, left);
+	same(other, t);
+	m.clear();
+	churn(other, t, n, n / 4 + 10);
+	same(other, t);
+}
+
+template <class M>
+static void sizes()
+{
+	static const int n[] = { 0, 1, 3, 100, 500, 1000, 5000, 40000 };
+
+	for (size_t i = 0; i < sizeof(n) / sizeof(*n); ++i)
+		run<M>(n[i]);
+}
+
+// the block comes from the map's allocator, costs little more than the nodes it holds, and
+// is given back once its last node is gone; a small map takes no block at all
+static void memory()
+{
+	typedef ft::map<int, int, std::less<int>, alloc_type> M;
+
+	size_t before = g_bytes;
+	{
+		M		m;
+		size_t	loose;
+
+		for (int i = 0; i < 3; ++i)
+			m[i] = i;
+		loose = g_bytes - before;
+		m.compact();
+		assert(g_bytes - before == loose && packedNodes(m) == 0);
+	}
+	assert(g_bytes == before);
+	{
+		M		m, other;
+		size_t	empty = g_bytes;
+		size_t	loose;
+
+		for (int i = 0; i < 100000; ++i)
+			m[rand()] = i;
+		loose = g_bytes - before;
+		m.compact();
+		assert(packedNodes(m) == m.size());
+		assert(g_bytes - before < loose + loose / 20);
+		// one node kept elsewhere holds the block
+		other.insert(m.extract(m.begin()));
+		m.clear();
+		assert(g_bytes - before > loose / 2);
+		other.clear();
+		assert(g_bytes == empty);
+	}
+	assert(g_bytes == before);
+}
+
+// an allocation failure part way through leaves the map as it was and leaks nothing
+static void failures()
+{
+	typedef ft::map<int, int, std::less<int>, alloc_type>	M;
+	static const int										n[] = { 5, 3000 };
+
+	for (size_t k = 0; k < sizeof(n) / sizeof(*n); ++k){
+		M	m;
+		ref	s;
+
+		for (int i = 0; i < n[k]; ++i){
+			m[i * 3] = i;
+			s[i * 3] = i;}
+		for (long c = 1; c < 8; ++c){
+			g_countdown = c;
+			try { m.compact(); }
+			catch (const std::bad_alloc&) {}
+			g_countdown = -1;
+			same(m, s);
+			m[-static_cast<int>(c)] = 0;
+			s[-static_cast<int>(c)] = 0;
+			same(m, s);}
+	}
+}
+
+int main()
+{
+	srand(5);
+	sizes<ft::map<int, int> >();
+	sizes<ft::map<int, int, std::less<int>, alloc_type> >();
+	sizes<ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, ft::order_statistics> >();
+	sizes<ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, ft::no_augment, ft::split_values> >();
+	sizes<ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, ft::no_augment, ft::inline_values, ft::avl> >();
+	memory();
+	failures();
+	printf("compact ok\n");
+	return (0);
+}
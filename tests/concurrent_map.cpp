@@ -0,0 +1,99 @@
+// concurrent_map against std::map on one thread: single-key, batch and ordered operations
+#include <map>
+#include <vector>
+#include <iterator>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include "concurrent_map.hpp"
+
+typedef ft::concurrent_map<int, long> CM;
+
+struct collect
+{
+	std::vector<int>* v;
+	void operator()(const ft::pair<const int, long>& p) { v->push_back(p.first); }
+};
+
+struct increment
+{
+	void operator()(long& x) const { ++x; }
+};
+
+int main()
+{
+	CM									m(8);
+	std::map<int, long>					s;
+	std::vector<int>					keys;
+	std::vector<int>					q;
+	std::vector<ft::pair<bool, long> >	out;
+	std::vector<ft::pair<int, long> >	ins;
+	collect								c = { &keys };
+	size_t								i, n, n2;
+	long								v;
+
+	srand(1);
+	for (i = 0; i < 20000; ++i){
+		int k = rand() % 3000;
+		int op = rand() % 4;
+		if (op < 2){
+			assert(m.insert(ft::make_pair(k, static_cast<long>(i))) == s.insert(std::make_pair(k, static_cast<long>(i))).second);}
+		else if (op == 2)
+			assert(m.erase(k) == s.erase(k));
+		else {
+			m.insert_or_assign(k, 7);
+			s[k] = 7;}
+	}
+	assert(m.size() == s.size());
+
+	m.for_each(c);
+	assert(keys.size() == s.size());
+	i = 0;
+	for (std::map<int, long>::iterator it = s.begin(); it != s.end(); ++it, ++i)
+		assert(keys[i] == it->first);
+	keys.clear();
+	m.for_each(100, 900, c);
+	i = 0;
+	for (std::map<int, long>::iterator it = s.lower_bound(100); it != s.lower_bound(900); ++it, ++i)
+		assert(keys[i] == it->first);
+	assert(i == keys.size());
+
+	for (i = 0; i < 500; ++i)
+		q.push_back(rand() % 3500);
+	n = m.find_batch(q.begin(), q.end(), std::back_inserter(out));
+	n2 = 0;
+	for (i = 0; i < q.size(); ++i){
+		bool hit = s.count(q[i]);
+		n2 += hit;
+		assert(out[i].first == hit);
+		if (hit)
+			assert(out[i].second == s[q[i]]);}
+	assert(n == n2);
+
+	for (i = 0; i < 1000; ++i)
+		ins.push_back(ft::make_pair(rand() % 5000, static_cast<long>(i)));
+	n = m.insert_batch(ins.begin(), ins.end());
+	n2 = 0;
+	for (i = 0; i < ins.size(); ++i)
+		n2 += s.insert(std::make_pair(ins[i].first, ins[i].second)).second;
+	assert(n == n2);
+	n = m.erase_batch(q.begin(), q.end());
+	n2 = 0;
+	for (i = 0; i < q.size(); ++i)
+		n2 += s.erase(q[i]);
+	assert(n == n2 && m.size() == s.size());
+	for (std::map<int, long>::iterator it = s.begin(); it != s.end(); ++it)
+		assert(m.find(it->first, v) && v == it->second);
+
+	assert(m.update(s.begin()->first, increment()));
+	m.find(s.begin()->first, v);
+	assert(v == s.begin()->second + 1);
+	m.clear();
+	assert(m.empty());
+
+	CM one(1);
+	one.insert(ft::make_pair(1, 1L));
+	assert(one.count(1) == 1 && one.shard_count() == 1);
+	printf("concurrent_map ok\n");
+	return (0);
+}
@@ -0,0 +1,76 @@
+// flat_map against std::map: random inserts and erases, bounds, bulk and sorted inserts
+#include <map>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include "flat_map.hpp"
+
+static void same(ft::flat_map<int, int>& m, std::map<int, int>& s)
+{
+	std::map<int, int>::iterator si = s.begin();
+
+	assert(m.size() == s.size());
+	for (ft::flat_map<int, int>::iterator it = m.begin(); it != m.end(); ++it, ++si)
+		assert(it->first == si->first && (*it).second == si->second);
+}
+
+int main()
+{
+	ft::flat_map<int, int>				m;
+	std::map<int, int>					s;
+	std::vector<std::pair<int, int> >	in;
+
+	srand(1);
+	for (int i = 0; i < 5000; ++i){
+		int k = rand() % 3000;
+		int e = rand() % 3000;
+		m[k] = i;
+		s[k] = i;
+		assert(m.erase(e) == s.erase(e));}
+	same(m, s);
+	for (int i = -1; i < 3001; ++i){
+		assert((m.lower_bound(i) == m.end()) == (s.lower_bound(i) == s.end()));
+		if (s.lower_bound(i) != s.end())
+			assert(m.lower_bound(i)->first == s.lower_bound(i)->first);
+		if (s.upper_bound(i) != s.end())
+			assert(m.upper_bound(i)->first == s.upper_bound(i)->first);
+		else
+			assert(m.upper_bound(i) == m.end());
+		assert(m.count(i) == s.count(i));}
+
+	// insert(first, last) sorts, dedupes (first occurrence wins) and merges
+	for (int i = 0; i < 4000; ++i)
+		in.push_back(std::make_pair(rand() % 6000, i));
+	m.insert(in.begin(), in.end());
+	for (size_t i = 0; i < in.size(); ++i)
+		s.insert(in[i]);
+	same(m, s);
+	ft::flat_map<int, int>	c(in.begin(), in.end());
+	std::map<int, int>		sc(in.begin(), in.end());
+	same(c, sc);
+
+	// insert_sorted keeps existing keys
+	std::vector<std::pair<int, int> >	so(s.begin(), s.end());
+	ft::flat_map<int, int>				e;
+	e[5] = -1;
+	e.insert_sorted(so.begin(), so.end());
+	assert(e[5] == -1 && e.size() == s.size() + (s.count(5) ? 0 : 1));
+
+	m.erase(m.begin() + 3, m.begin() + 10);
+	assert(m.size() == s.size() - 7);
+	assert((*m.rbegin()).first == s.rbegin()->first);
+	ft::flat_map<int, int>::const_iterator ci = m.begin();
+	assert(ci == m.begin());
+
+	ft::flat_map<std::string, std::string> str;
+	str["b"] = "x";
+	str["a"] = "y";
+	assert(str.begin()->second == "y");
+
+	ft::flat_map<int, int> d = c;
+	assert(d == c && !(d < c) && !(c == m));
+	printf("flat_map ok\n");
+	return (0);
+}
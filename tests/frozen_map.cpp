@@ -0,0 +1,164 @@
+// frozen_map against the map it was frozen from: lower_bound, upper_bound, equal_range, find,
+// count and at for every key in and around the range, and iteration both ways, at sizes that
+// fill the Eytzinger tree exactly and one off either side; then copies, the cache line
+// alignment of the key array, and the branchless descent bookkeeping against its loop
+#include <string>
+#include <sstream>
+#include <stdexcept>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#define private public
+#include "map.hpp"
+#include "frozen_map.hpp"
+#undef private
+
+template <class F, class M>
+static void sameAt(typename F::const_iterator a, const F& f, typename M::const_iterator b, const M& m)
+{
+	assert((a == f.end()) == (b == m.end()));
+	if (b != m.end())
+		assert(a->first == b->first && a->second == b->second && (*a).second == b->second);
+}
+
+template <class F, class M>
+static void walk(const F& f, const M& m)
+{
+	typename M::const_iterator			j = m.begin();
+	typename M::const_reverse_iterator	rj = m.rbegin();
+	typename F::const_iterator			last = f.end();
+
+	assert(f.size() == m.size() && f.empty() == m.empty());
+	for (typename F::const_iterator i = f.begin(); i != f.end(); ++i, ++j)
+		sameAt(i, f, j, m);
+	assert(j == m.end());
+	for (typename F::const_reverse_iterator i = f.rbegin(); i != f.rend(); ++i, ++rj)
+		assert(i->first == rj->first && i->second == rj->second);
+	assert(rj == m.rend());
+	if (!m.empty())
+		assert((--last)->first == m.rbegin()->first);
+}
+
+template <class F, class M>
+static void probe(const F& f, const M& m, const typename M::key_type& k)
+{
+	typename M::const_iterator	b = m.lower_bound(k);
+	bool						present = b != m.end() && !(k < b->first);
+
+	sameAt(f.lower_bound(k), f, b, m);
+	sameAt(f.upper_bound(k), f, m.upper_bound(k), m);
+	sameAt(f.equal_range(k).first, f, m.equal_range(k).first, m);
+	sameAt(f.equal_range(k).second, f, m.equal_range(k).second, m);
+	sameAt(f.find(k), f, m.find(k), m);
+	assert(f.count(k) == m.count(k));
+	if (present)
+		assert(f.at(k) == b->second);
+	else {
+		bool thrown = false;
+
+		try { f.at(k); }
+		catch (const std::out_of_range&) { thrown = true; }
+		assert(thrown);}
+}
+
+// keys()[0] starts a cache line whenever the key size lets it
+template <class F>
+static void aligned(const F& f)
+{
+	if (!f.empty() && 64 % sizeof(typename F::key_type) == 0)
+		assert(reinterpret_cast<uintptr_t>(f.keys()) % 64 == 0);
+}
+
+static int intKey(int i) { return (i + 10); }
+static long longKey(int i) { return (static_cast<long>(i) - 1000); }
+static std::string stringKey(int i) {
+	std::ostringstream s;
+
+	s << 'k' << (i + 100000);
+	return (s.str());
+}
+
+// the entries are key(0), key(2), key(4)...; probes cover every entry, every gap between
+// two of them, and keys below and above the range
+template <class K>
+static void run(size_t n, K (*key)(int))
+{
+	typedef ft::map<K, int>			M;
+	typedef ft::frozen_map<K, int>	F;
+	M								m;
+
+	for (size_t i = 0; i < n; ++i)
+		m[key(static_cast<int>(i) * 2)] = rand();
+	F	f(m.freeze());
+	F	c(f);
+	F	d;
+
+	walk(f, m);
+	aligned(f);
+	for (int i = -3; i <= static_cast<int>(n) * 2 + 2; ++i)
+		probe(f, m, key(i));
+	walk(c, m);
+	aligned(c);
+	d = c;
+	walk(d, m);
+	aligned(d);
+	assert(f == c && d == f && !(d != f));
+	c.swap(d);
+	aligned(c);
+	assert(c == f);
+}
+
+template <class K>
+static void sizes(K (*key)(int))
+{
+	run<K>(0, key);
+	run<K>(1, key);
+	run<K>(2, key);
+	for (size_t p = 4; p <= 4096; p *= 2){
+		run<K>(p - 1, key);
+		run<K>(p, key);
+		run<K>(p + 1, key);}
+	run<K>(5000 + rand() % 1000, key);
+}
+
+// every size up to 200 once, so every shape of the last level is searched
+static void allShapes()
+{
+	ft::map<int, int>	m;
+
+	for (int n = 0; n < 200; ++n){
+		m[n * 4] = n;
+		ft::frozen_map<int, int> f(m.freeze());
+
+		walk(f, m);
+		for (int k = -5; k <= n * 4 + 5; ++k)
+			probe(f, m, k);}
+}
+
+// the ffsll form of dropRightTurns is the loop: strip the trailing ones, then one more bit
+static void dropRightTurns()
+{
+	typedef ft::frozen_map<int, int> F;
+
+	for (size_t i = 1; i < (1 << 16); ++i){
+		size_t j = i;
+
+		while (j & 1)
+			j >>= 1;
+		assert(F::dropRightTurns(i) == (j >> 1));}
+	// positions deep in a tree of 2^40 entries: all right turns, and a left then two rights
+	assert(F::dropRightTurns((static_cast<size_t>(1) << 41) - 1) == 0);
+	assert(F::dropRightTurns((static_cast<size_t>(5) << 40) | 3) == static_cast<size_t>(5) << 37);
+}
+
+int main()
+{
+	srand(13);
+	sizes<int>(intKey);
+	sizes<long>(longKey);
+	sizes<std::string>(stringKey);
+	allShapes();
+	dropRightTurns();
+	printf("frozen_map ok\n");
+	return (0);
+}
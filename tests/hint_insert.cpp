@@ -0,0 +1,107 @@
+// insert(hint, v) and insert(hint, node_handle&&) against std::map with hints that are right
+// (just before or after the key), wrong, begin(), end() and default-constructed; the tree
+// must stay a valid red-black tree whatever the hint
+#include <map>
+#include <vector>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#define private public
+#include "map.hpp"
+
+typedef ft::map<int, int>	M;
+typedef std::map<int, int>	S;
+
+// black height of x, checking order and colors on the way
+static int blackHeight(const M& m, M::node_type* x, const int* lo, const int* hi)
+{
+	int l, r;
+
+	if (x == m._tree._nil)
+		return (1);
+	assert((!lo || *lo < x->key()) && (!hi || x->key() < *hi));
+	if (x->color() == RED)
+		assert(x->left->color() != RED && x->right->color() != RED);
+	l = blackHeight(m, x->left, lo, &x->key());
+	r = blackHeight(m, x->right, &x->key(), hi);
+	assert(l == r);
+	return (l + (x->color() != RED));
+}
+
+static void same(const M& m, const S& s)
+{
+	S::const_iterator j = s.begin();
+
+	assert(m.size() == s.size());
+	for (M::const_iterator i = m.begin(); i != m.end(); ++i, ++j)
+		assert(i->first == j->first && i->second == j->second);
+	blackHeight(m, m._tree._root, 0, 0);
+}
+
+static M::iterator pickHint(M& m, int k)
+{
+	M::iterator it;
+
+	switch (rand() % 6){
+	case 0: return (m.begin());
+	case 1: return (m.end());
+	case 2: return (M::iterator());
+	case 3: // just after the key
+		return (m.upper_bound(k));
+	case 4: // just before the key
+		it = m.lower_bound(k);
+		return (it == m.begin() ? it : --it);
+	default: // anywhere
+		it = m.lower_bound(rand() % 2000);
+		return (it);
+	}
+}
+
+int main()
+{
+	M	m;
+	S	s;
+
+	srand(5);
+	for (int i = 0; i < 40000; ++i){
+		int			k = rand() % 2000;
+		M::iterator	h = pickHint(m, k);
+		M::iterator	it;
+
+		if (rand() % 3 == 0 && !m.empty()){
+			M::iterator		from = m.lower_bound(k);
+			M::node_handle	nh = m.extract(from == m.end() ? m.begin() : from);
+			int				key = nh.key();
+
+			nh.mapped() = i;
+			h = pickHint(m, key);
+			it = m.insert(h, std::move(nh));
+			assert(it->first == key && it->second == i);
+			s.erase(key);
+			s[key] = i;}
+		else {
+			it = m.insert(h, ft::make_pair(k, i));
+			assert(it->first == k);
+			s.insert(std::make_pair(k, i));
+			assert(it->second == s[k]);}
+		if (rand() % 4 == 0){
+			int e = rand() % 2000;
+			assert(m.erase(e) == s.erase(e));}
+		if (i % 1000 == 0)
+			same(m, s);
+	}
+	same(m, s);
+	// ascending and descending runs with the previous result as the hint
+	m.clear();
+	s.clear();
+	M::iterator h = m.end();
+	for (int i = 0; i < 5000; ++i){
+		h = m.insert(h, ft::make_pair(i * 2, i));
+		s[i * 2] = i;}
+	for (int i = 4999; i >= 0; --i){
+		h = m.insert(h, ft::make_pair(i * 2 + 1, i));
+		s[i * 2 + 1] = i;}
+	same(m, s);
+	printf("hint_insert ok\n");
+	return (0);
+}
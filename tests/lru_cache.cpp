@@ -0,0 +1,215 @@
+// lru_cache against a model built from std::list (recency) and std::map (index): get, put,
+// peek, erase and capacity changes, with the evictions recorded in order; then weighers,
+// swap, a put that hits allocating nothing, and the sharded cache
+#include <map>
+#include <list>
+#include <new>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include "lru_cache.hpp"
+
+static size_t g_allocations;
+
+void* operator new(size_t n)
+{
+	void* p = malloc(n);
+
+	++g_allocations;
+	if (!p)
+		throw std::bad_alloc();
+	return (p);
+}
+
+void operator delete(void* p) throw() { free(p); }
+void operator delete(void* p, size_t) throw() { free(p); }
+
+typedef std::list<std::pair<int, int> >	recency;
+
+struct model
+{
+	size_t								cap;
+	recency								l;		// most recent first
+	std::map<int, recency::iterator>	m;
+	std::vector<int>					evicted;
+
+	model(size_t c): cap(c) {}
+
+	int* get(int k) {
+		std::map<int, recency::iterator>::iterator it = m.find(k);
+
+		if (it == m.end())
+			return (0);
+		l.splice(l.begin(), l, it->second);
+		return (&it->second->second);
+	}
+
+	bool put(int k, int v) {
+		std::map<int, recency::iterator>::iterator	it = m.find(k);
+		bool										inserted = it == m.end();
+
+		if (inserted){
+			l.push_front(std::make_pair(k, v));
+			m[k] = l.begin();}
+		else {
+			it->second->second = v;
+			l.splice(l.begin(), l, it->second);}
+		shrink();
+		return (inserted);
+	}
+
+	void erase(int k) {
+		if (m.count(k)){
+			l.erase(m[k]);
+			m.erase(k);}
+	}
+
+	void shrink() {
+		while (m.size() > cap){
+			evicted.push_back(l.back().first);
+			m.erase(l.back().first);
+			l.pop_back();}
+	}
+};
+
+struct record
+{
+	std::vector<int>* out;
+	void operator()(const int& k, int&) const { out->push_back(k); }
+};
+
+struct collect
+{
+	std::vector<std::pair<int, int> >* out;
+	void operator()(const int& k, const int& v) const { out->push_back(std::make_pair(k, v)); }
+};
+
+struct stringWeight
+{
+	size_t operator()(const int&, const std::string& s) const { return (s.size()); }
+};
+
+typedef ft::lru_cache<int, int, std::less<int>, ft::lru_entries, record>	cache;
+
+static void differential()
+{
+	for (int round = 0; round < 300; ++round){
+		size_t								cap = rand() % 40;
+		int									range = 1 + rand() % 120;
+		std::vector<int>					evicted;
+		record								r;
+		std::vector<std::pair<int, int> >	got, expected;
+		collect								c;
+
+		r.out = &evicted;
+		c.out = &got;
+		cache	lru(cap, std::less<int>(), ft::lru_entries(), r);
+		model	ref(cap);
+		for (int i = 0; i < 2000; ++i){
+			int k = rand() % range;
+			int op = rand() % 10;
+
+			if (op < 4){
+				int* a = lru.get(k);
+				int* b = ref.get(k);
+				assert(!a == !b && (!a || *a == *b));}
+			else if (op < 8)
+				assert(lru.put(k, i) == ref.put(k, i));
+			else if (op == 8){
+				assert((lru.peek(k) != 0) == (ref.m.count(k) == 1));
+				assert(lru.erase(k) == ref.m.count(k));
+				ref.erase(k);}
+			else if (rand() % 50 == 0){
+				cap = rand() % 40;
+				lru.set_capacity(cap);
+				ref.cap = cap;
+				ref.shrink();}
+			assert(lru.size() == ref.m.size() && lru.weight() == lru.size());
+			assert(evicted == ref.evicted);
+		}
+		lru.for_each_recent(c);
+		expected.assign(ref.l.begin(), ref.l.end());
+		assert(got == expected);
+		got.clear();
+		expected.clear();
+		lru.for_each(c);
+		for (std::map<int, recency::iterator>::iterator it = ref.m.begin(); it != ref.m.end(); ++it)
+			expected.push_back(*it->second);
+		assert(got == expected);
+		if (round % 10 == 0){
+			lru.clear();
+			assert(lru.empty());
+			lru.put(1, 1);
+			assert(lru.size() == (cap ? 1 : 0));}
+	}
+}
+
+static void weighers()
+{
+	ft::lru_cache<int, std::string, std::less<int>, stringWeight>	s(10), t(5);
+
+	s.put(1, "aaaa");
+	s.put(2, "bbbb");
+	s.put(3, "cc");
+	assert(s.size() == 3 && s.weight() == 10);
+	s.put(4, "d");
+	assert(!s.count(1) && s.weight() == 7);
+	// an entry heavier than the capacity pushes everything out, itself last
+	s.put(2, "bbbbbbbbbbbb");
+	assert(s.size() == 0 && s.weight() == 0);
+	t.put(9, "x");
+	s.swap(t);
+	assert(s.count(9) && s.capacity() == 5);
+	ft::swap(s, t);
+	assert(t.count(9));
+}
+
+// overwriting an entry assigns into its value: no node and no copy of the value are made
+static void hitsDoNotAllocate()
+{
+	ft::lru_cache<int, std::string>	lru(100);
+	std::string						a(100, 'a'), b(100, 'b');
+	size_t							before;
+
+	for (int i = 0; i < 100; ++i)
+		lru.put(i, a);
+	before = g_allocations;
+	for (int i = 0; i < 10000; ++i)
+		assert(!lru.put(i % 100, i % 2 ? a : b));
+	assert(g_allocations == before);
+	assert(*lru.get(99) == a && *lru.get(98) == b);
+}
+
+static void sharded()
+{
+	ft::concurrent_lru_cache<int, int>	c(1000, 8);
+	size_t								hits = 0;
+	int									v;
+
+	for (int i = 0; i < 5000; ++i)
+		c.put(i, i);
+	assert(c.size() <= 1000 && c.size() > 800 && c.capacity() == 1000);
+	for (int i = 0; i < 5000; ++i)
+		if (c.get(i, v)){
+			assert(v == i);
+			++hits;}
+	assert(hits == c.size() && c.stats().hits == hits);
+	assert(c.peek(4999, v) && v == 4999);
+	c.erase(4999);
+	assert(!c.peek(4999, v));
+	c.clear();
+	assert(c.empty());
+}
+
+int main()
+{
+	srand(3);
+	differential();
+	weighers();
+	hitsDoNotAllocate();
+	sharded();
+	printf("lru_cache ok\n");
+	return (0);
+}
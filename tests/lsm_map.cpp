@@ -0,0 +1,152 @@
+// lsm_map against std::map with buffers small enough that writes flush and runs merge across
+// several tiers: blind writes, tombstones over older runs, bounds, iteration both ways,
+// copies and assignment, and a copy whose value copies throw part way
+#include <map>
+#include <new>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include "lsm_map.hpp"
+
+typedef ft::lsm_map<int, int>	L;
+typedef std::map<int, int>		S;
+
+static void same(const L& m, const S& s)
+{
+	S::const_iterator			j = s.begin();
+	S::const_reverse_iterator	rj = s.rbegin();
+
+	for (L::const_iterator i = m.begin(); i != m.end(); ++i, ++j)
+		assert(j != s.end() && i->first == j->first && i->second == j->second);
+	assert(j == s.end());
+	for (L::const_reverse_iterator i = m.rbegin(); i != m.rend(); ++i, ++rj)
+		assert(rj != s.rend() && i->first == rj->first && i->second == rj->second);
+	assert(rj == s.rend());
+	assert(m.size() == s.size() && m.empty() == s.empty());
+}
+
+static void bounds(const L& m, const S& s, int k)
+{
+	L::const_iterator	a = m.lower_bound(k), b = m.upper_bound(k);
+	S::const_iterator	c = s.lower_bound(k), d = s.upper_bound(k);
+
+	assert((a == m.end()) == (c == s.end()) && (c == s.end() || a->first == c->first));
+	assert((b == m.end()) == (d == s.end()) && (d == s.end() || b->first == d->first));
+	// one step back from a bound is the largest key below it
+	if (c != s.begin())
+		assert((--a)->first == (--c)->first);
+	assert(m.count(k) == s.count(k));
+	assert(s.count(k) ? m.find(k)->second == s.find(k)->second && m.at(k) == s.find(k)->second : m.find(k) == m.end());
+}
+
+static void differential(size_t buffer, int range, int rounds)
+{
+	L		m(buffer);
+	S		s;
+	size_t	maxRuns = 0;
+
+	for (int i = 0; i < rounds; ++i){
+		int k = rand() % range;
+		int op = rand() % 20;
+
+		if (op < 8){
+			m.insert_or_assign(k, i);
+			s[k] = i;}
+		else if (op < 11)
+			assert(m.insert(ft::make_pair(k, i)) == s.insert(std::make_pair(k, i)).second);
+		else if (op < 17){
+			m.erase(k);
+			s.erase(k);}
+		else if (op < 19)
+			bounds(m, s, k + rand() % 3 - 1);
+		else if (rand() % 20 == 0)
+			rand() % 2 ? m.flush() : m.compact();
+		if (m.run_count() > maxRuns)
+			maxRuns = m.run_count();
+		if (i % 500 == 0){
+			L c(m), d(1);
+
+			same(m, s);
+			same(c, s);
+			d.insert_or_assign(-1, -1);
+			d = m;
+			same(d, s);
+			// copies share nothing
+			c.insert_or_assign(-2, 0);
+			c.erase(s.empty() ? 0 : s.begin()->first);
+			same(m, s);
+			d.swap(c);
+			c.swap(d);
+			same(d, s);}
+	}
+	same(m, s);
+	for (int k = -1; k <= range; ++k)
+		bounds(m, s, k);
+	if (buffer < static_cast<size_t>(range) / 8)
+		assert(maxRuns > 2); // several tiers were live at once
+	m.compact();
+	assert(m.run_count() <= 1);
+	same(m, s);
+	m.clear();
+	assert(m.empty() && m.begin() == m.end());
+}
+
+// value copies that throw after a countdown
+static long g_countdown = -1;
+
+struct faultyValue
+{
+	int v;
+
+	faultyValue(int x = 0): v(x) {}
+	faultyValue(const faultyValue& x): v(x.v) { tick(); }
+	faultyValue& operator=(const faultyValue& x) { tick(); v = x.v; return (*this); }
+	static void tick() {
+		if (g_countdown > 0 && --g_countdown == 0)
+			throw std::bad_alloc();
+	}
+};
+
+// a copy or assignment that throws leaks nothing (LeakSanitizer checks) and leaves the
+// target as it was
+static void failingCopies()
+{
+	ft::lsm_map<int, faultyValue>	m(4);
+	ft::lsm_map<int, faultyValue>	t(4);
+
+	for (int i = 0; i < 200; ++i)
+		m.insert_or_assign(i, faultyValue(i));
+	t.insert_or_assign(7, faultyValue(70));
+	t.flush();
+	assert(m.run_count() > 1);
+	for (long n = 1; n < 600; n += 7){
+		bool thrown = false;
+
+		g_countdown = n;
+		try {
+			ft::lsm_map<int, faultyValue> c(m);
+		}
+		catch (const std::bad_alloc&) { thrown = true; }
+		g_countdown = n;
+		try { t = m; }
+		catch (const std::bad_alloc&) { thrown = true; }
+		g_countdown = -1;
+		if (thrown)
+			assert(t.at(7).v == 70 || t.at(7).v == 7);
+		t = ft::lsm_map<int, faultyValue>(4);
+		t.insert_or_assign(7, faultyValue(70));
+		t.flush();
+	}
+}
+
+int main()
+{
+	srand(9);
+	differential(1, 50, 3000);
+	differential(4, 300, 20000);
+	differential(16, 2000, 40000);
+	differential(4096, 500, 10000);
+	failingCopies();
+	printf("lsm_map ok\n");
+	return (0);
+}
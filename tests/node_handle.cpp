@@ -0,0 +1,195 @@
+// extract, insert(node_handle&&) and merge against std::map: handles inserted onto free and
+// taken keys (with and without a hint), keys rewritten in between, empty handles, handles
+// dropped while owning a node, and merges that leave the duplicates behind in the source;
+// no node is allocated and no value copied. Across layouts, with order statistics, and with
+// a Bloom filter
+#include <map>
+#include <memory>
+#include <string>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include "map.hpp"
+
+static size_t g_allocations;	// by the maps' allocator: nodes (the filter keeps its own)
+
+template <class T>
+struct countingAllocator: public std::allocator<T>
+{
+	template <class U> struct rebind { typedef countingAllocator<U> other; };
+
+	countingAllocator() {}
+	countingAllocator(const countingAllocator&): std::allocator<T>() {}
+	template <class U> countingAllocator(const countingAllocator<U>&) {}
+
+	T* allocate(size_t n, const void* = 0) {
+		++g_allocations;
+		return (std::allocator<T>::allocate(n)); }
+};
+
+typedef std::map<int, std::string> S;
+
+template <class M>
+static void same(const M& m, const S& s)
+{
+	S::const_iterator j = s.begin();
+
+	for (typename M::const_iterator i = m.begin(); i != m.end(); ++i, ++j)
+		assert(j != s.end() && i->first == j->first && i->second == j->second);
+	assert(j == s.end() && m.size() == s.size());
+	for (S::const_iterator k = s.begin(); k != s.end(); ++k)
+		assert(m.count(k->first) == 1);
+}
+
+static std::string name(int k) { return (std::string(40, static_cast<char>('a' + k % 26))); }
+
+template <class M>
+static void fill(M& m, S& s, int n, int range, int step)
+{
+	for (int i = 0; i < n; ++i){
+		int k = (rand() % range) * step;
+
+		m.insert(ft::make_pair(k, name(k)));
+		s.insert(std::make_pair(k, name(k)));}
+}
+
+template <class M>
+static void handles()
+{
+	typedef typename M::node_handle			handle;
+	typedef typename M::insert_return_type	result;
+	M										m, t;
+	S										s, st;
+	size_t									before;
+
+	fill(m, s, 300, 200, 1);
+	fill(t, st, 100, 200, 1);
+	// absent keys and empty handles
+	{
+		handle	h = m.extract(-1);
+		result	r = t.insert(std::move(h));
+
+		assert(h.empty() && !h && !r.inserted && r.position == t.end() && r.node.empty());
+		assert(t.insert(t.begin(), handle()) == t.end());
+	}
+	for (int round = 0; round < 400 && !m.empty(); ++round){
+		typename M::iterator	it = m.find(s.begin()->first);
+		int						k, nk;
+		std::string				was, v;
+		const std::string*		value;	// the node's own value: it is never copied
+		handle					h;
+
+		for (int j = rand() % static_cast<int>(m.size()); j > 0; --j)
+			++it;
+		k = it->first;
+		was = v = name(k);
+		nk = round % 5 == 0 ? k + 1000 : k;
+		if (round % 5 == 0)
+			v[0] = '#';
+		s.erase(k);
+		before = g_allocations;
+		h = round % 2 ? m.extract(it) : m.extract(k);
+		assert(!h.empty() && h.key() == k && h.mapped() == was);
+		value = &h.mapped();
+		if (round % 5 == 0){
+			// a rewritten key goes in under its new value
+			h.key() = nk;
+			h.mapped()[0] = '#';}
+		if (round % 3 == 0){
+			result r = t.insert(std::move(h));
+
+			assert(g_allocations == before && h.empty());
+			if (st.count(nk)){
+				// taken: the existing element stays, the handle comes back owning the node
+				assert(!r.inserted && r.position->first == nk && r.position->second == st[nk]);
+				assert(!r.node.empty() && r.node.key() == nk && &r.node.mapped() == value && *value == v);
+				if (round % 2)
+					h = std::move(r.node); // dropped at the end of the round
+				else {
+					r.node.key() = nk + 5000;
+					before = g_allocations;
+					assert(t.insert(std::move(r.node)).inserted && g_allocations == before);
+					st[nk + 5000] = v;}}
+			else {
+				assert(r.inserted && r.position->first == nk && &r.position->second == value && r.node.empty());
+				st[nk] = v;}}
+		else {
+			typename M::iterator	hint = t.lower_bound(nk);
+			bool					taken = st.count(nk) != 0;
+			typename M::iterator	p = t.insert(round % 2 ? hint : t.begin(), std::move(h));
+
+			assert(g_allocations == before && p != t.end() && p->first == nk);
+			if (taken)
+				assert(!h.empty() && h.key() == nk && &h.mapped() == value && p->second == st[nk]);
+			else {
+				assert(h.empty() && &p->second == value && *value == v);
+				st[nk] = v;}}
+	}
+	same(m, s);
+	same(t, st);
+	// a handle that still owns its node frees it (LeakSanitizer checks)
+	if (!t.empty()){
+		handle h = t.extract(t.begin());
+
+		st.erase(st.begin());
+		handle g(std::move(h));
+		assert(h.empty() && !g.empty());
+		h.swap(g);
+		assert(!h.empty() && g.empty());
+	}
+	same(t, st);
+}
+
+template <class M>
+static void merges()
+{
+	for (int round = 0; round < 100; ++round){
+		M		a, b;
+		S		sa, sb;
+		size_t	before;
+
+		fill(a, sa, rand() % 200, 300, 1);
+		fill(b, sb, rand() % 200, 300, 1);
+		for (typename M::iterator it = b.begin(); it != b.end(); ++it)
+			it->second[1] = '#';
+		for (S::iterator it = sb.begin(); it != sb.end(); ++it)
+			it->second[1] = '#';
+		before = g_allocations;
+		a.merge(b);
+		assert(g_allocations == before);
+		// the keys a already had stay in b with b's values
+		for (S::iterator it = sb.begin(); it != sb.end();)
+			if (sa.count(it->first))
+				++it;
+			else {
+				sa.insert(*it);
+				sb.erase(it++);}
+		same(a, sa);
+		same(b, sb);
+		for (typename M::iterator it = b.begin(); it != b.end(); ++it)
+			assert(a.count(it->first) && it->second[1] == '#' && a.find(it->first)->second[1] != '#');
+		a.merge(a);
+		same(a, sa);
+		a.merge(std::move(b));
+		same(b, sb);
+	}
+}
+
+template <class M>
+static void run()
+{
+	handles<M>();
+	merges<M>();
+}
+
+int main()
+{
+	typedef countingAllocator<ft::pair<const int, std::string> > A;
+
+	srand(23);
+	run<ft::map<int, std::string, std::less<int>, A> >();
+	run<ft::map<int, std::string, std::less<int>, A, ft::order_statistics, ft::split_values> >();
+	run<ft::map<int, std::string, std::less<int>, A, ft::no_augment, ft::inline_values, ft::avl, ft::bloom_filter> >();
+	printf("node_handle ok\n");
+	return (0);
+}
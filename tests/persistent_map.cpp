@@ -0,0 +1,180 @@
+// persistent_map against std::map with snapshots kept along the way, and updates that fail
+// part way (an allocation or a value copy throws) while a snapshot shares the tree
+#include <map>
+#include <new>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include "persistent_map.hpp"
+
+typedef std::map<int, std::string> ref;
+
+template <class M, class R>
+static void same(const M& m, const R& s)
+{
+	typename R::const_iterator			it = s.begin();
+	typename R::const_reverse_iterator	r = s.rbegin();
+	int									depth = 0;
+
+	assert(m.size() == s.size());
+	for (typename M::const_iterator i = m.begin(); i != m.end(); ++i, ++it){
+		assert(i->first == it->first && i->second == it->second);
+		if (i.depth() > depth)
+			depth = i.depth();}
+	assert(it == s.end());
+	for (typename M::const_reverse_iterator i = m.rbegin(); i != m.rend(); ++i, ++r)
+		assert(i->first == r->first);
+	// red-black height bound
+	for (size_t n = m.size() + 1; n > 1; n >>= 1)
+		depth -= 2;
+	assert(depth <= 2);
+}
+
+static void differential()
+{
+	ft::persistent_map<int, std::string>	m;
+	ref										s;
+	std::vector<ft::persistent_map<int, std::string> >	snaps;
+	std::vector<ref>						refs;
+
+	for (int i = 0; i < 30000; ++i){
+		int		k = rand() % 2000;
+		int		op = rand() % 6;
+		char	buf[16];
+
+		sprintf(buf, "v%d", i);
+		if (op < 3)
+			assert(m.insert(ft::make_pair(k, std::string(buf))).second == s.insert(std::make_pair(k, std::string(buf))).second);
+		else if (op < 5)
+			assert(m.erase(k) == s.erase(k));
+		else {
+			assert(m.insert_or_assign(k, buf) == !s.count(k));
+			s[k] = buf;}
+		if (i % 1000 == 0){
+			snaps.push_back(m.snapshot());
+			refs.push_back(s);
+			same(m, s);}
+		if (i % 3000 == 0 && snaps.size() > 3){
+			snaps.erase(snaps.begin() + 1);
+			refs.erase(refs.begin() + 1);}
+	}
+	same(m, s);
+	for (size_t i = 0; i < snaps.size(); ++i)
+		same(snaps[i], refs[i]);
+	for (int q = 0; q < 2000; ++q){
+		int									k = rand() % 2100;
+		ft::persistent_map<int, std::string>::const_iterator	a = m.lower_bound(k), b = m.upper_bound(k);
+		ref::iterator						c = s.lower_bound(k), d = s.upper_bound(k);
+
+		assert((a == m.end()) == (c == s.end()));
+		if (c != s.end())
+			assert(a->first == c->first);
+		assert((b == m.end()) == (d == s.end()));
+		if (d != s.end())
+			assert(b->first == d->first);
+	}
+	m.erase(m.lower_bound(500), m.lower_bound(1500));
+	s.erase(s.lower_bound(500), s.lower_bound(1500));
+	same(m, s);
+	m.erase(m.begin(), m.end());
+	assert(m.empty());
+	for (size_t i = 0; i < snaps.size(); ++i)
+		same(snaps[i], refs[i]);
+}
+
+// Fault injection: the n-th allocation or value copy from now throws
+static long g_countdown = -1;
+
+static void event()
+{
+	if (g_countdown > 0 && --g_countdown == 0)
+		throw std::bad_alloc();
+}
+
+template <class T>
+struct faultyAllocator: public std::allocator<T>
+{
+	template <class U> struct rebind { typedef faultyAllocator<U> other; };
+
+	faultyAllocator() {}
+	faultyAllocator(const faultyAllocator&): std::allocator<T>() {}
+	template <class U> faultyAllocator(const faultyAllocator<U>&) {}
+
+	T* allocate(size_t n, const void* = 0) {
+		event();
+		return (std::allocator<T>::allocate(n)); }
+};
+
+struct faultyValue
+{
+	int v;
+
+	faultyValue(int x = 0): v(x) {}
+	faultyValue(const faultyValue& x): v(x.v) { event(); }
+	faultyValue& operator=(const faultyValue& x) { event(); v = x.v; return (*this); }
+	bool operator==(const faultyValue& x) const { return (v == x.v); }
+};
+
+typedef ft::persistent_map<int, faultyValue, std::less<int>, faultyAllocator<ft::pair<const int, faultyValue> > > FM;
+typedef std::map<int, faultyValue> fref;
+
+// op 0 inserts, 1 erases, 2 assigns; after a throw the map must hold what it held before,
+// still balanced, and outlive the snapshot it shared its nodes with
+static void failAt(int op, long n)
+{
+	FM		m;
+	fref	s;
+	int		k = 0;
+	bool	thrown = false;
+
+	for (int i = 0; i < 200; ++i){
+		m.insert(ft::make_pair(i * 2, faultyValue(i)));
+		s[i * 2] = faultyValue(i);}
+	{
+		FM		snap = m.snapshot();
+		fref	before = s;
+
+		k = op == 0 ? 2 * (rand() % 200) + 1 : 2 * (rand() % 200);
+		g_countdown = n;
+		try {
+			if (op == 0)
+				m.insert(ft::make_pair(k, faultyValue(-1)));
+			else if (op == 1)
+				m.erase(k);
+			else
+				m.insert_or_assign(k, faultyValue(-1));
+		}
+		catch (const std::bad_alloc&) { thrown = true; }
+		g_countdown = -1;
+		if (!thrown){
+			if (op == 1)
+				s.erase(k);
+			else
+				s[k] = faultyValue(-1);}
+		same(m, s);
+		same(snap, before);
+	}
+	same(m, s);
+	// later updates must still find a consistent tree
+	for (int i = 0; i < 2000; ++i){
+		int key = rand() % 500;
+		if (rand() % 2)
+			assert(m.insert(ft::make_pair(key, faultyValue(i))).second == s.insert(std::make_pair(key, faultyValue(i))).second);
+		else
+			assert(m.erase(key) == s.erase(key));}
+	same(m, s);
+}
+
+int main()
+{
+	srand(2);
+	differential();
+	for (int op = 0; op < 3; ++op)
+		for (long n = 1; n < 120; ++n)
+			for (int rep = 0; rep < 4; ++rep)
+				failAt(op, n);
+	printf("persistent_map ok\n");
+	return (0);
+}
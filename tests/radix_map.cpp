@@ -0,0 +1,141 @@
+// radix_map against std::map for string, signed, unsigned and short keys: updates, bounds,
+// iteration both ways (the iterators step by descending from the root) and prefix ranges
+#include <map>
+#include <string>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include "radix_map.hpp"
+
+template <class R, class M>
+static void same(const R& r, const M& m)
+{
+	typename M::const_iterator			j = m.begin();
+	typename M::const_reverse_iterator	rj = m.rbegin();
+
+	assert(r.size() == m.size());
+	for (typename R::const_iterator i = r.begin(); i != r.end(); ++i, ++j)
+		assert(i->first == j->first && i->second == j->second);
+	assert(j == m.end());
+	for (typename R::const_reverse_iterator i = r.rbegin(); i != r.rend(); ++i, ++rj)
+		assert(i->first == rj->first);
+	assert(rj == m.rend());
+	if (!m.empty()){
+		typename R::const_iterator last = r.end();
+		assert((--last)->first == m.rbegin()->first);}
+}
+
+// shared prefixes, keys that are prefixes of others, 0x00 and 0xff bytes
+static std::string stringKey()
+{
+	static const char*	parts[] = {"", "a", "ab", "abc", "http://x.com/", "http://x.com/aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", "\xff", "zz", "http://y.org/"};
+	static const char	bytes[] = {'a', 'b', '\xff', '\0', '/'};
+	std::string			s = parts[rand() % 9];
+	int					n = rand() % 4;
+
+	for (int i = 0; i < n; ++i)
+		s += bytes[rand() % 5];
+	if (rand() % 3 == 0)
+		s = parts[rand() % 9] + s;
+	return (s);
+}
+
+static int intKey() { return (rand() % 4000 - 2000 + (rand() % 5 == 0 ? (rand() % 0x7fffff) * 256 : 0)); }
+static unsigned long long wideKey() { return ((static_cast<unsigned long long>(rand()) << (rand() % 32)) ^ (rand() % 300)); }
+static short shortKey() { return (static_cast<short>(rand() % 600 - 300)); }
+
+template <class K>
+static void differential(K (*key)(), int rounds)
+{
+	typedef ft::radix_map<K, int>	R;
+	R								r;
+	std::map<K, int>				m;
+
+	for (int i = 0; i < rounds; ++i){
+		K	k = key();
+		int	op = rand() % 10;
+
+		if (op < 5)
+			assert(r.insert(ft::make_pair(k, i)).second == m.insert(std::make_pair(k, i)).second);
+		else if (op < 6){
+			r[k] = i;
+			m[k] = i;}
+		else if (op < 9)
+			assert(r.erase(k) == m.erase(k));
+		else {
+			typename R::iterator				a = r.lower_bound(k), b = r.upper_bound(k);
+			typename std::map<K, int>::iterator	c = m.lower_bound(k), d = m.upper_bound(k);
+
+			assert((a == r.end()) == (c == m.end()) && (c == m.end() || a->first == c->first));
+			assert((b == r.end()) == (d == m.end()) && (d == m.end() || b->first == d->first));
+			if (a != r.begin())
+				assert((--a)->first == (--c)->first);
+			assert(r.count(k) == m.count(k));
+			assert(m.count(k) ? r.find(k)->second == m[k] : r.find(k) == r.end());
+		}
+		if (i % 997 == 0){
+			R c(r);
+
+			same(r, m);
+			same(c, m);
+			assert(c == r);
+			c.erase(c.begin(), c.end());
+			assert(c.empty());
+			c = r;
+			R e;
+			e.swap(c);
+			same(e, m);
+			assert(c.empty());}
+	}
+	same(r, m);
+	// erasing one element leaves iterators to the others valid
+	while (!m.empty()){
+		typename R::iterator	it = r.find(m.begin()->first);
+		typename R::iterator	next = it;
+
+		++next;
+		r.erase(it);
+		m.erase(m.begin());
+		assert(next == r.begin());
+	}
+	same(r, m);
+}
+
+static void prefixRanges()
+{
+	typedef ft::radix_map<std::string, int>	R;
+	R										r;
+	std::map<std::string, int>				m;
+
+	for (int i = 0; i < 20000; ++i){
+		std::string k = stringKey();
+		r[k] = i;
+		m[k] = i;}
+	for (int i = 0; i < 3000; ++i){
+		std::string		p = stringKey();
+		size_t			n = 0, expected = 0;
+
+		if (i % 3 == 0 && p.size())
+			p.resize(rand() % p.size());
+		ft::pair<R::iterator, R::iterator> range = r.prefix_range(p);
+		for (; range.first != range.second; ++range.first, ++n)
+			assert(range.first->first.compare(0, p.size(), p) == 0);
+		for (std::map<std::string, int>::iterator it = m.lower_bound(p); it != m.end() && it->first.compare(0, p.size(), p) == 0; ++it)
+			++expected;
+		assert(n == expected);
+	}
+}
+
+int main()
+{
+	for (int seed = 1; seed < 6; ++seed){
+		srand(seed);
+		differential(stringKey, 30000);
+		differential(intKey, 30000);
+		differential(wideKey, 30000);
+		differential(shortKey, 20000);}
+	srand(7);
+	prefixRanges();
+	printf("radix_map ok\n");
+	return (0);
+}
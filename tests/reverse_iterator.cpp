@@ -0,0 +1,96 @@
+// reverse iteration with operator-> over the containers whose iterators hand out a pairRef
+// proxy instead of a reference (flat_map, btree_map, small_map, frozen_map), const and not,
+// plus ft::map and ft::vector whose pointers are raw
+#include <map>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include "map.hpp"
+#include "vector.hpp"
+#include "flat_map.hpp"
+#include "btree_map.hpp"
+#include "small_map.hpp"
+#include "frozen_map.hpp"
+
+typedef std::map<int, int> ref;
+
+template <class M>
+static void readBack(const M& m, const ref& s)
+{
+	typename ref::const_reverse_iterator r = s.rbegin();
+
+	for (typename M::const_reverse_iterator it = m.rbegin(); it != m.rend(); ++it, ++r)
+		assert(it->first == r->first && it->second == r->second);
+	assert(r == s.rend());
+}
+
+// it->second writes through the proxy into the container
+template <class M>
+static void writeBack(M& m, ref& s)
+{
+	typename ref::reverse_iterator r = s.rbegin();
+
+	for (typename M::reverse_iterator it = m.rbegin(); it != m.rend(); ++it, ++r){
+		assert(it->first == r->first);
+		it->second += it->first;
+		r->second += r->first;}
+	readBack(m, s);
+}
+
+template <class M>
+static void run(int n)
+{
+	M	m;
+	ref	s;
+
+	for (int i = 0; i < n; ++i){
+		int k = rand() % (n * 4 + 1);
+		m[k] = i;
+		s[k] = i;}
+	readBack(m, s);
+	writeBack(m, s);
+	readBack(m.freeze(), s);
+}
+
+template <class M>
+static void runUnfrozen(int n)
+{
+	M	m;
+	ref	s;
+
+	for (int i = 0; i < n; ++i){
+		int k = rand() % (n * 4 + 1);
+		m[k] = i;
+		s[k] = i;}
+	readBack(m, s);
+	writeBack(m, s);
+}
+
+static void vectors()
+{
+	ft::vector<ft::pair<int, int> >	v;
+	int								n = 0;
+
+	for (int i = 0; i < 100; ++i)
+		v.push_back(ft::make_pair(i, -i));
+	for (ft::vector<ft::pair<int, int> >::reverse_iterator it = v.rbegin(); it != v.rend(); ++it, ++n){
+		assert(it->first == 99 - n);
+		it->second = it->first * 2;}
+	for (int i = 0; i < 100; ++i)
+		assert(v[i].second == i * 2);
+}
+
+int main()
+{
+	static const int sizes[] = { 0, 1, 7, 64, 1000 };
+
+	srand(11);
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(*sizes); ++i){
+		run<ft::map<int, int> >(sizes[i]);
+		runUnfrozen<ft::flat_map<int, int> >(sizes[i]);
+		runUnfrozen<ft::btree_map<int, int> >(sizes[i]);
+		runUnfrozen<ft::small_map<int, int> >(sizes[i]);}
+	vectors();
+	printf("reverse_iterator ok\n");
+	return (0);
+}
@@ -0,0 +1,141 @@
+// small_map against std::map across the move from inline arrays to an ft::map, for integer
+// and string keys; an empty map, max_size and the first N inserts must not allocate
+#include <map>
+#include <new>
+#include <string>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include "small_map.hpp"
+
+static size_t g_allocations;
+
+void* operator new(size_t n)
+{
+	void* p = malloc(n);
+
+	++g_allocations;
+	if (!p)
+		throw std::bad_alloc();
+	return (p);
+}
+
+void operator delete(void* p) throw() { free(p); }
+void operator delete(void* p, size_t) throw() { free(p); }
+
+template <class M, class K>
+static void same(const M& m, const std::map<K, int>& s)
+{
+	typename std::map<K, int>::const_iterator si = s.begin();
+
+	assert(m.size() == s.size());
+	for (typename M::const_iterator it = m.begin(); it != m.end(); ++it, ++si)
+		assert((*it).first == si->first && (*it).second == si->second);
+	assert(si == s.end());
+	for (typename M::const_reverse_iterator it = m.rbegin(); it != m.rend(); ++it)
+		assert((*it).first == (--si)->first);
+}
+
+template <class K> K key(int i);
+template <> int key<int>(int i) { return (i); }
+template <> unsigned key<unsigned>(int i) { return (static_cast<unsigned>(i) * 0x9E3779B9u); }
+template <> long key<long>(int i) { return (i * -1000003L); }
+template <> std::string key<std::string>(int i) {
+	char b[32];
+
+	sprintf(b, "k%05d", i);
+	return (b);
+}
+
+template <class K>
+static void run()
+{
+	typedef ft::small_map<K, int, 8> M;
+
+	for (int round = 0; round < 300; ++round){
+		M					m;
+		std::map<K, int>	s;
+		int					range = 4 + rand() % 30;
+
+		for (int i = 0; i < 200; ++i){
+			K	k = key<K>(rand() % range);
+			int	op = rand() % 6;
+
+			if (op < 2)
+				assert(m.insert(ft::make_pair(k, i)).second == s.insert(std::make_pair(k, i)).second);
+			else if (op == 2)
+				assert(m.erase(k) == s.erase(k));
+			else if (op == 3){
+				m[k] = i;
+				s[k] = i;}
+			else if (op == 4){
+				typename M::iterator					lb = m.lower_bound(k);
+				typename M::iterator					ub = m.upper_bound(k);
+				typename std::map<K, int>::iterator	slb = s.lower_bound(k);
+				typename std::map<K, int>::iterator	sub = s.upper_bound(k);
+
+				assert(m.count(k) == s.count(k));
+				assert((m.find(k) == m.end()) == (s.find(k) == s.end()));
+				assert(slb == s.end() ? lb == m.end() : lb->first == slb->first);
+				assert(sub == s.end() ? ub == m.end() : ub->first == sub->first);}
+			else if (s.size() > 1 && rand() % 4 == 0){
+				m.erase(m.begin(), ++m.begin());
+				s.erase(s.begin());}
+			if (i % 17 == 0)
+				same(m, s);
+		}
+		same(m, s);
+
+		M					c(m);
+		M					d;
+		M					e;
+		std::map<K, int>	se;
+		same(c, s);
+		assert(c == m);
+		d = m;
+		same(d, s);
+		e[key<K>(1)] = 5;
+		se[key<K>(1)] = 5;
+		e.swap(m);
+		same(e, s);
+		same(m, se);
+		m.swap(e);
+		same(m, s);
+		same(e, se);
+		m.clear();
+		assert(m.empty() && m.is_inline());
+	}
+}
+
+int main()
+{
+	size_t before;
+
+	srand(5);
+	run<int>();
+	run<unsigned>();
+	run<long>();
+	run<std::string>();
+
+	before = g_allocations;
+	{
+		ft::small_map<int, int> m;
+
+		assert(m.max_size() > 0 && m.empty());
+		for (int i = 0; i < 16; ++i)
+			m.insert(ft::make_pair(i * 7 % 16, i));
+		assert(m.is_inline());
+		for (int i = 0; i < 16; ++i)
+			assert(m.find(i) != m.end());
+	}
+	assert(g_allocations == before);
+	{
+		ft::small_map<int, int> m;
+
+		for (int i = 0; i < 17; ++i)
+			m[i] = i;
+		assert(!m.is_inline() && m.size() == 17);
+	}
+	printf("small_map ok\n");
+	return (0);
+}
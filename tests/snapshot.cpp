@@ -0,0 +1,113 @@
+// snapshot round trips of map and vector from a stream and from memory, and failed loads:
+// a flipped byte, a short payload, the wrong type or a header claiming a huge count must
+// throw std::runtime_error and leave the destination as it was
+#include <sstream>
+#include <string>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include "snapshot.hpp"
+
+typedef ft::map<long, double>	map_type;
+typedef ft::vector<long>		vector_type;
+
+template <class C>
+static bool fails(const std::string& s, C& c, bool stream)
+{
+	try {
+		if (stream){
+			std::istringstream is(s);
+			ft::load_snapshot(is, c);}
+		else
+			ft::load_snapshot(s.data(), s.size(), c);
+	}
+	catch (std::runtime_error&) { return (true); }
+	return (false);
+}
+
+// the saved bytes with the header's count replaced
+static std::string withCount(std::string s, uint64_t count)
+{
+	ft::snapshotHeader h;
+
+	std::memcpy(&h, s.data(), sizeof(h));
+	h.count = count;
+	s.replace(0, sizeof(h), reinterpret_cast<const char*>(&h), sizeof(h));
+	return (s);
+}
+
+template <class C>
+static void rejected(const std::string& good, const C& before)
+{
+	std::string bad = good;
+
+	bad[sizeof(ft::snapshotHeader) + 100] ^= 1;
+	for (int stream = 0; stream < 2; ++stream){
+		C c(before);
+		assert(fails(bad, c, stream) && c == before);
+		assert(fails(good.substr(0, good.size() - 5), c, stream) && c == before);
+		assert(fails(good.substr(0, 10), c, stream) && c == before);
+		assert(fails(withCount(good, 1ULL << 60), c, stream) && c == before);
+		assert(fails(withCount(good, ~0ULL), c, stream) && c == before);
+		assert(fails(withCount(good, 10000000), c, stream) && c == before);
+	}
+}
+
+int main()
+{
+	map_type	m;
+	map_type	before;
+	vector_type	v;
+	vector_type	vbefore;
+
+	for (int n = 0; n < 300; n += 7){
+		map_type	r;
+		std::string	s;
+
+		m.clear();
+		for (int i = 0; i < n; ++i)
+			m[i * 3] = i * 0.5;
+		std::ostringstream os;
+		ft::save_snapshot(os, m);
+		s = os.str();
+		r[5] = 1;
+		std::istringstream is(s);
+		ft::load_snapshot(is, r);
+		assert(r == m);
+		r[5] = 1;
+		ft::load_snapshot(s.data(), s.size(), r);
+		assert(r == m && r.size() == static_cast<size_t>(n));
+	}
+
+	for (long i = 0; i < 1000; ++i){
+		m[i] = i;
+		v.push_back(i * i);}
+	for (long i = 0; i < 10; ++i){
+		before[-i] = i;
+		vbefore.push_back(-i);}
+	std::ostringstream ms;
+	std::ostringstream vs;
+	ft::save_snapshot(ms, m);
+	ft::save_snapshot(vs, v);
+	rejected(ms.str(), before);
+	rejected(vs.str(), vbefore);
+
+	// the type is part of the header
+	ft::map<int, double>	wrongMap;
+	vector_type				wrongVector(vbefore);
+	assert(fails(ms.str(), wrongMap, false) && wrongMap.empty());
+	assert(fails(ms.str(), wrongVector, true) && wrongVector == vbefore);
+
+	// a vector longer than the stream loader's step
+	vector_type big;
+	for (long i = 0; i < 300000; ++i)
+		big.push_back(i ^ 0x5555);
+	std::ostringstream bs;
+	ft::save_snapshot(bs, big);
+	std::istringstream bis(bs.str());
+	vector_type back(vbefore);
+	ft::load_snapshot(bis, back);
+	assert(back == big);
+	printf("snapshot ok\n");
+	return (0);
+}
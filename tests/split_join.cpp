@@ -0,0 +1,224 @@
+// split, extract_range and erase(first, last) at both ends and in the middle of a map, into
+// empty and non-empty targets; set_union, set_intersection and set_difference against
+// std::set_union and friends on random, disjoint, nested, empty and identical operands. The
+// maps carry order statistics so the summaries rebuilt by join are checked too
+#include <map>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include "map.hpp"
+
+typedef ft::map<int, int, std::less<int>, std::allocator<ft::pair<const int, int> >, ft::order_statistics>	M;
+typedef std::map<int, int>																				S;
+
+static void same(const M& m, const S& s)
+{
+	S::const_iterator	j = s.begin();
+	size_t				i = 0;
+
+	for (M::const_iterator it = m.begin(); it != m.end(); ++it, ++j, ++i){
+		assert(j != s.end() && it->first == j->first && it->second == j->second);
+		assert(m.nth(i)->first == j->first && m.rank(j->first) == i);}
+	assert(j == s.end() && m.size() == s.size() && m.nth(m.size()) == m.end());
+}
+
+static void fill(M& m, S& s, int n, int range, int tag)
+{
+	for (int i = 0; i < n; ++i){
+		int k = rand() % range;
+
+		m[k] = k * 10 + tag;
+		s[k] = k * 10 + tag;}
+}
+
+// split at k, with greater holding junk beforehand; then joined back with set_union
+static void splitAt(int n, int k)
+{
+	M	m, g;
+	S	s, sg;
+
+	fill(m, s, n, n * 3 + 1, 0);
+	g[-5] = -5;
+	m.split(k, g);
+	sg.insert(s.lower_bound(k), s.end());
+	s.erase(s.lower_bound(k), s.end());
+	same(m, s);
+	same(g, sg);
+	m.set_union(g);
+	s.insert(sg.begin(), sg.end());
+	same(m, s);
+	assert(g.empty() && g.begin() == g.end());
+}
+
+// [a, b) by index, with out holding junk beforehand
+static void extractAt(int n, size_t a, size_t b)
+{
+	M	m, out;
+	S	s, so;
+
+	fill(m, s, n, n * 3 + 1, 0);
+	if (b > m.size())
+		b = m.size();
+	if (a > b)
+		a = b;
+	out[1 << 20] = 0;
+	S::iterator	sa = s.begin(), sb = s.begin();
+	std::advance(sa, a);
+	std::advance(sb, b);
+	m.extract_range(m.nth(a), m.nth(b), out);
+	so.insert(sa, sb);
+	s.erase(sa, sb);
+	same(m, s);
+	same(out, so);
+}
+
+static void eraseAt(int n, size_t a, size_t b)
+{
+	M	m;
+	S	s;
+
+	fill(m, s, n, n * 3 + 1, 0);
+	if (b > m.size())
+		b = m.size();
+	if (a > b)
+		a = b;
+	S::iterator	sa = s.begin(), sb = s.begin();
+	std::advance(sa, a);
+	std::advance(sb, b);
+	m.erase(m.nth(a), m.nth(b));
+	s.erase(sa, sb);
+	same(m, s);
+}
+
+static void ends()
+{
+	static const int sizes[] = { 0, 1, 2, 5, 100, 2000 };
+
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(*sizes); ++i){
+		int		n = sizes[i];
+		size_t	mid = static_cast<size_t>(n) / 3;
+
+		// below everything, at the first key's neighbourhood, the middle, the top, above
+		splitAt(n, -1);
+		splitAt(n, 0);
+		splitAt(n, 1);
+		splitAt(n, n);
+		splitAt(n, n * 3);
+		splitAt(n, n * 3 + 1);
+		splitAt(n, n * 4);
+		extractAt(n, 0, 0);
+		extractAt(n, 0, 1);
+		extractAt(n, 0, mid);
+		extractAt(n, mid, mid * 2);
+		extractAt(n, mid, static_cast<size_t>(n));
+		extractAt(n, 0, static_cast<size_t>(n));
+		extractAt(n, static_cast<size_t>(n) - 1, static_cast<size_t>(n));
+		eraseAt(n, 0, 1);
+		eraseAt(n, 0, mid);
+		eraseAt(n, mid, static_cast<size_t>(n));
+		eraseAt(n, 0, static_cast<size_t>(n));
+		eraseAt(n, static_cast<size_t>(n) - 1, static_cast<size_t>(n));}
+}
+
+// std::set_* on the key/value pairs, comparing keys only; on equal keys std::set_union and
+// std::set_intersection take the element of the first range, as the map keeps its own value
+struct byKey
+{
+	bool operator()(const std::pair<int, int>& a, const std::pair<int, int>& b) const { return (a.first < b.first); }
+};
+
+static S expected(int op, const S& a, const S& b)
+{
+	std::vector<std::pair<int, int> > r;
+
+	if (op == 0)
+		std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(r), byKey());
+	else if (op == 1)
+		std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(r), byKey());
+	else
+		std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(r), byKey());
+	return (S(r.begin(), r.end()));
+}
+
+static void setOp(int op, M& a, S& sa, M& b, S& sb)
+{
+	S r = expected(op, sa, sb);
+
+	if (op == 0){
+		a.set_union(b);
+		assert(b.empty());
+		sb.clear();}
+	else if (op == 1)
+		a.set_intersection(b);
+	else
+		a.set_difference(b);
+	same(a, r);
+	same(b, sb);
+	sa = r;
+}
+
+static void setOps()
+{
+	for (int round = 0; round < 300; ++round){
+		int op = round % 3;
+		int na = rand() % 200, nb = rand() % 200;
+		M	a, b;
+		S	sa, sb;
+
+		switch (round / 3 % 5){
+		case 0: // overlapping
+			fill(a, sa, na, 300, 1);
+			fill(b, sb, nb, 300, 2);
+			break ;
+		case 1: // disjoint, b above a
+			fill(a, sa, na, 300, 1);
+			for (int i = 0; i < nb; ++i){
+				b[1000 + i] = i;
+				sb[1000 + i] = i;}
+			break ;
+		case 2: // b inside a
+			fill(a, sa, na + 50, 300, 1);
+			for (S::iterator it = sa.begin(); it != sa.end(); ++it)
+				if (rand() % 3 == 0){
+					b[it->first] = -it->second;
+					sb[it->first] = -it->second;}
+			break ;
+		case 3: // one side empty
+			fill(round % 2 ? a : b, round % 2 ? sa : sb, na, 300, 1);
+			break ;
+		default: // the same keys
+			fill(a, sa, na, 300, 1);
+			for (S::iterator it = sa.begin(); it != sa.end(); ++it){
+				b[it->first] = 7;
+				sb[it->first] = 7;}
+		}
+		setOp(op, a, sa, b, sb);
+		// and the other way round on what is left
+		setOp((op + 1) % 3, b, sb, a, sa);
+	}
+	// an operand that is the map itself
+	{
+		M	a;
+		S	s;
+
+		fill(a, s, 100, 300, 1);
+		a.set_union(a);
+		same(a, s);
+		a.set_intersection(a);
+		same(a, s);
+		a.set_difference(a);
+		assert(a.empty());
+	}
+}
+
+int main()
+{
+	srand(17);
+	ends();
+	setOps();
+	printf("split_join ok\n");
+	return (0);
+}
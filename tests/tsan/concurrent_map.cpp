@@ -0,0 +1,87 @@
+// concurrent_map under ThreadSanitizer (make tsan): writers own disjoint key ranges so the
+// end state is known, while readers, batch readers and ordered walks run alongside
+#include <vector>
+#include <cassert>
+#include <cstdio>
+#include <pthread.h>
+#include "concurrent_map.hpp"
+
+typedef ft::concurrent_map<int, long> CM;
+
+static const int	writers = 4;
+static const int	readers = 4;
+static const int	span = 2000;	// keys per writer
+static CM			g_map(8);
+
+struct counter
+{
+	size_t	n;
+	int		last;
+	bool	sorted;
+	void operator()(const ft::pair<const int, long>& p) {
+		sorted = sorted && (n == 0 || last < p.first);
+		last = p.first;
+		++n; }
+};
+
+// each writer inserts its range, erases the odd keys, then bumps the even ones with update
+static void* writer(void* arg)
+{
+	int						base = static_cast<int>(reinterpret_cast<size_t>(arg)) * span;
+	std::vector<int>		odd;
+	std::vector<ft::pair<int, long> >	batch;
+
+	for (int k = base; k < base + span; k += 2)
+		g_map.insert(ft::make_pair(k, 0L));
+	for (int k = base + 1; k < base + span; k += 2)
+		batch.push_back(ft::make_pair(k, 0L));
+	g_map.insert_batch(batch.begin(), batch.end());
+	for (int k = base + 1; k < base + span; k += 2)
+		odd.push_back(k);
+	g_map.erase_batch(odd.begin(), odd.end());
+	for (int k = base; k < base + span; k += 2){
+		long v = k;
+		g_map.insert_or_assign(k, v);}
+	return (0);
+}
+
+static void* reader(void* arg)
+{
+	unsigned							seed = static_cast<unsigned>(reinterpret_cast<size_t>(arg));
+	std::vector<int>					q;
+	std::vector<ft::pair<bool, long> >	out;
+	long								v;
+
+	for (int i = 0; i < 5000; ++i){
+		int k = rand_r(&seed) % (writers * span);
+		if (g_map.find(k, v))
+			assert(v == 0 || v == k);
+		g_map.count(k);}
+	for (int i = 0; i < 200; ++i)
+		q.push_back(rand_r(&seed) % (writers * span));
+	g_map.find_batch(q.begin(), q.end(), std::back_inserter(out));
+	for (int i = 0; i < 5; ++i){
+		counter c = { 0, 0, true };
+		g_map.for_each(c);
+		assert(c.sorted);
+		g_map.size();}
+	return (0);
+}
+
+int main()
+{
+	pthread_t	th[writers + readers];
+	long		v;
+
+	for (int i = 0; i < writers; ++i)
+		pthread_create(&th[i], 0, writer, reinterpret_cast<void*>(static_cast<size_t>(i)));
+	for (int i = 0; i < readers; ++i)
+		pthread_create(&th[writers + i], 0, reader, reinterpret_cast<void*>(static_cast<size_t>(i + 1)));
+	for (int i = 0; i < writers + readers; ++i)
+		pthread_join(th[i], 0);
+	assert(g_map.size() == static_cast<size_t>(writers * span / 2));
+	for (int k = 0; k < writers * span; ++k)
+		assert(g_map.find(k, v) == (k % 2 == 0) && (k % 2 || v == k));
+	printf("concurrent_map tsan ok\n");
+	return (0);
+}
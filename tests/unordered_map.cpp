@@ -0,0 +1,126 @@
+// unordered_map against std::map: random inserts, erases and operator[], copies, erase while
+// iterating, and churn on a hash that sends every key to one of seven chains
+#include <map>
+#include <string>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include "unordered_map.hpp"
+
+typedef std::map<int, std::string> ref;
+
+// all keys with the same k % 7 collide, whatever the bucket count
+struct collidingHash
+{
+	size_t operator()(int k) const { return (static_cast<size_t>(k % 7) * 0x9e3779b97f4a7c15ULL); }
+};
+
+template <class U>
+static void same(const U& u, const ref& s)
+{
+	size_t n = 0;
+
+	assert(u.size() == s.size());
+	for (typename U::const_iterator it = u.begin(); it != u.end(); ++it, ++n){
+		ref::const_iterator f = s.find(it->first);
+		assert(f != s.end() && f->second == it->second);}
+	assert(n == s.size());
+	for (ref::const_iterator it = s.begin(); it != s.end(); ++it)
+		assert(u.at(it->first) == it->second);
+}
+
+static void differential()
+{
+	ft::unordered_map<int, std::string>	u;
+	ref									s;
+
+	assert(u.begin() == u.end() && u.find(3) == u.end() && u.erase(3) == 0);
+	for (int i = 0; i < 200000; ++i){
+		int		k = rand() % 20000;
+		int		op = rand() % 5;
+		char	b[16];
+
+		sprintf(b, "%d", i);
+		if (op < 2)
+			assert(u.insert(ft::make_pair(k, std::string(b))).second == s.insert(std::make_pair(k, std::string(b))).second);
+		else if (op < 4)
+			assert(u.erase(k) == s.erase(k));
+		else {
+			u[k] = b;
+			s[k] = b;}
+		if (i % 20000 == 0)
+			same(u, s);
+	}
+	same(u, s);
+
+	ft::unordered_map<int, std::string> c(u);
+	same(c, s);
+	assert(c == u);
+	c.erase(c.begin(), c.end());
+	assert(c.empty());
+	c = u;
+	same(c, s);
+	for (ft::unordered_map<int, std::string>::iterator it = c.begin(); it != c.end();){
+		if (it->first & 1)
+			c.erase(it++);
+		else
+			++it;}
+	for (ref::iterator it = s.begin(); it != s.end();){
+		if (it->first & 1)
+			s.erase(it++);
+		else
+			++it;}
+	same(c, s);
+
+	// reserve leaves room for that many entries without a rehash
+	c.clear();
+	assert(c.size() == 0 && c.begin() == c.end());
+	c.reserve(1000);
+	size_t buckets = c.bucket_count();
+	for (int i = 0; i < 1000; ++i)
+		c[i] = "x";
+	assert(c.bucket_count() == buckets);
+}
+
+static void collidingChurn()
+{
+	ft::unordered_map<int, int, collidingHash>	m;
+	std::map<int, int>							s;
+
+	for (int i = 0; i < 3000; ++i)
+		m[i] = i;
+	for (int i = 0; i < 3000; i += 2)
+		m.erase(i);
+	for (int i = 0; i < 3000; ++i)
+		assert(m.count(i) == static_cast<size_t>(i & 1));
+	for (int i = 0; i < 3000; ++i)
+		if (i & 1)
+			s[i] = i;
+	for (int i = 0; i < 100000; ++i){
+		m[i % 5000] = i;
+		s[i % 5000] = i;
+		assert(m.erase((i * 7) % 5000) == s.erase((i * 7) % 5000));}
+	assert(m.size() == s.size());
+	for (std::map<int, int>::iterator it = s.begin(); it != s.end(); ++it)
+		assert(m.at(it->first) == it->second);
+
+	ft::unordered_map<int, int, collidingHash> moved(std::move(m));
+	assert(moved.size() == s.size());
+	assert(m.empty() && m.begin() == m.end());
+	m[1] = 1;
+	assert(m.size() == 1);
+}
+
+int main()
+{
+	srand(6);
+	differential();
+	collidingChurn();
+
+	ft::unordered_map<std::string, int> su;
+	su["a"] = 1;
+	su["bb"] = 2;
+	assert(su["a"] == 1 && su.size() == 2);
+	printf("unordered_map ok\n");
+	return (0);
+}
@@ -0,0 +1,41 @@
+// vector: resize growth (from empty and past twice the capacity), reserve, assignment
+#include <vector>
+#include <string>
+#include <cassert>
+#include <cstdio>
+#include "vector.hpp"
+
+int main()
+{
+	ft::vector<int>			v;
+	ft::vector<std::string>	s;
+
+	// from empty: twice a capacity of 0 is still 0
+	v.resize(10, 7);
+	assert(v.size() == 10 && v.capacity() >= 10);
+	for (size_t i = 0; i < v.size(); ++i)
+		assert(v[i] == 7);
+	// past twice the capacity in one step
+	v.resize(v.capacity() * 2 + 5, 3);
+	assert(v.capacity() >= v.size() && v[0] == 7 && v[v.size() - 1] == 3);
+	// geometric growth for small steps
+	size_t cap = v.capacity();
+	v.resize(cap + 1);
+	assert(v.capacity() >= 2 * cap);
+	v.resize(4);
+	assert(v.size() == 4 && v[3] == 7);
+
+	s.resize(100, "x");
+	assert(s.size() == 100 && s[99] == "x");
+	s.resize(1);
+	s.resize(1000, "y");
+	assert(s[0] == "x" && s[999] == "y");
+
+	ft::vector<int> a(v);
+	assert(a == v);
+	a.push_back(1);
+	v = a;
+	assert(v == a && v.size() == 5);
+	printf("vector ok\n");
+	return (0);
+}
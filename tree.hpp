@@ -2,8 +2,13 @@
 #define TREE_HPP
 
 #include <memory>
+#include <new>
+#include <utility>
+#include <stdint.h>
+#include <stdexcept>
 #include "utils.hpp"
 #include "iterator.hpp"
+#include "vector.hpp"
 
 #define BLACK 0
 #define RED 1
@@ -11,27 +16,321 @@
 
 namespace ft
 {
-	template<class T>
-	struct node
+	// Augmentation policies: a summary kept in every node and recomputed from the node and
+	// its two children whenever the shape below it changes (rotations, insert, erase, join).
+	// The summary is a base of the node, so an empty one costs nothing.
+
+	struct no_augment
+	{
+		struct summary {};
+		static const bool enabled = false;
+		template <class Node> static void update(Node*) {}
+	};
+
+	// subtree sizes: map::nth, map::rank, O(log n) map::distance
+	struct order_statistics
+	{
+		struct summary
+		{
+			size_t count;
+			summary(): count(0){};
+		};
+		static const bool enabled = true;
+		template <class Value> static summary make(const Value&) { summary s; s.count = 1; return s; }
+		static summary combine(const summary& a, const summary& b) { summary s; s.count = a.count + b.count; return s; }
+		template <class Node> static void update(Node* x) { x->count = x->left->count + 1 + x->right->count; }
+	};
+
+	// subtree size and sum/min/max of the mapped values: adds map::aggregate(lo, hi).
+	// The summaries read the mapped values, so after changing one in place call map::refresh(it)
+	template <class T>
+	struct range_aggregate
+	{
+		struct summary
+		{
+			size_t count;
+			T sum;
+			T min;
+			T max;
+			summary(): count(0), sum(), min(), max(){};
+		};
+		static const bool enabled = true;
+		template <class Value> static summary make(const Value& v) {
+			summary s;
+			s.count = 1;
+			s.sum = s.min = s.max = v.second;
+			return s; }
+		static summary combine(const summary& a, const summary& b) {
+			summary s;
+
+			if (a.count == 0)
+				return b;
+			if (b.count == 0)
+				return a;
+			s.count = a.count + b.count;
+			s.sum = a.sum + b.sum;
+			s.min = b.min < a.min ? b.min : a.min;
+			s.max = a.max < b.max ? b.max : a.max;
+			return s; }
+		template <class Node> static void update(Node* x) {
+			static_cast<summary&>(*x) = combine(combine(*x->left, make(x->value())), *x->right); }
+	};
+
+
+	// links first, payload right after them; the color lives in the low bit of the parent
+	// address (nodes are at least pointer aligned), bit 1 marks a node living in a nodeBlock,
+	// and nil is recognised by its address
+	template<class T, class Summary = no_augment::summary>
+	struct node : public Summary
 	{
-		int color;
-		bool isNil; // 
-		struct node* parent;
+		uintptr_t parentColor;
 		struct node* left;
 		struct node* right;
 
 		T keyValue; // allocates with notes
-		node():color(BLACK), isNil(1),parent(0), left(0), right(0){}; //for nil
-		node(T pair):color(RED), isNil(0), parent(0), left(0), right(0), keyValue(pair){};
+		node():parentColor(BLACK), left(0), right(0){}; //for nil
+		node(const T& pair):parentColor(RED), left(0), right(0), keyValue(pair){};
 		node(const node &other): 
-		color(other.color), isNil(other.isNil), parent(other.parent), left(other.left), right(other.right), keyValue(other.keyValue) {};
+		Summary(other), parentColor(other.parentColor), left(other.left), right(other.right), keyValue(other.keyValue) {};
 
 		~node(){};
+
+		const typename T::first_type& key() const { return keyValue.first; }
+		T& value() { return keyValue; }
+		const T& value() const { return keyValue; }
+		void keyChanged() {}
+
+		node* parent() const { return reinterpret_cast<node*>(parentColor & ~static_cast<uintptr_t>(3)); }
+		int color() const { return static_cast<int>(parentColor & 1); }
+		void setParent(node* p) { parentColor = reinterpret_cast<uintptr_t>(p) | (parentColor & 3); }
+		void setColor(int c) { parentColor = (parentColor & ~static_cast<uintptr_t>(1)) | static_cast<uintptr_t>(c); }
+		bool packed() const { return ((parentColor & 2) != 0); }
+		void setPacked(bool p = true) { parentColor = (parentColor & ~static_cast<uintptr_t>(2)) | (p ? 2 : 0); }
+	};
+
+	// Values of split nodes come from one pool per value type, carved out of large chunks so
+	// they never sit between the nodes. Freed slots are reused; chunks are kept for the process.
+	template <class T>
+	class coldPool
+	{
+		union slot
+		{
+			slot*		next;
+			void*		alignPointer;
+			long double	alignFloat;
+			uint64_t	alignInt;
+			char		bytes[sizeof(T)];
+		};
+
+		static const size_t chunkSlots = sizeof(slot) < 1024 ? (1 << 16) / sizeof(slot) : 64;
+
+		slot*	_free;
+		bool	_busy;
+
+		coldPool(): _free(0), _busy(false) {}
+		coldPool(const coldPool&);
+		coldPool& operator=(const coldPool&);
+
+		void lock() { while (__atomic_test_and_set(&_busy, __ATOMIC_ACQUIRE)) ; }
+		void unlock() { __atomic_clear(&_busy, __ATOMIC_RELEASE); }
+
+	public:
+		static coldPool& instance() { static coldPool pool; return (pool); }
+
+		T* allocate() {
+			slot* s;
+
+			lock();
+			if (_free == 0){
+				try { s = static_cast<slot*>(::operator new(chunkSlots * sizeof(slot))); }
+				catch (...) { unlock(); throw ; }
+				for (size_t i = chunkSlots; i-- > 0; ){ // in address order
+					s[i].next = _free;
+					_free = s + i;}
+			}
+			s = _free;
+			_free = s->next;
+			unlock();
+			return (reinterpret_cast<T*>(s));
+		}
+
+		void deallocate(T* p) {
+			slot* s = reinterpret_cast<slot*>(p);
+
+			lock();
+			s->next = _free;
+			_free = s;
+			unlock();
+		}
+	};
+
+	// hot/cold layout: links, color and a copy of the key stay in the node, the pair lives in
+	// a coldPool, so a search touches one small block per level whatever the mapped type
+	template<class T, class Summary = no_augment::summary>
+	struct splitNode : public Summary
+	{
+		typedef typename remove_const<typename T::first_type>::type	hot_key;
+
+		uintptr_t parentColor;
+		struct splitNode* left;
+		struct splitNode* right;
+		hot_key hotKey;
+		T* cold; // 0 for nil
+
+		splitNode():parentColor(BLACK), left(0), right(0), hotKey(), cold(0){};
+		splitNode(const T& pair):parentColor(RED), left(0), right(0), hotKey(pair.first), cold(makeCold(pair)){};
+		splitNode(const splitNode &other):
+		Summary(other), parentColor(other.parentColor), left(other.left), right(other.right), hotKey(other.hotKey),
+		cold(other.cold ? makeCold(*other.cold) : 0) {};
+
+		~splitNode(){
+			if (cold){
+				cold->~T();
+				coldPool<T>::instance().deallocate(cold);}
+		};
+
+		const typename T::first_type& key() const { return hotKey; }
+		T& value() { return *cold; }
+		const T& value() const { return *cold; }
+		void keyChanged() { hotKey = cold->first; } // a node handle rewrote the key
+
+		splitNode* parent() const { return reinterpret_cast<splitNode*>(parentColor & ~static_cast<uintptr_t>(3)); }
+		int color() const { return static_cast<int>(parentColor & 1); }
+		void setParent(splitNode* p) { parentColor = reinterpret_cast<uintptr_t>(p) | (parentColor & 3); }
+		void setColor(int c) { parentColor = (parentColor & ~static_cast<uintptr_t>(1)) | static_cast<uintptr_t>(c); }
+		bool packed() const { return ((parentColor & 2) != 0); }
+		void setPacked(bool p = true) { parentColor = (parentColor & ~static_cast<uintptr_t>(2)) | (p ? 2 : 0); }
+
+	private:
+		splitNode& operator=(const splitNode&);
+
+		static T* makeCold(const T& v) {
+			T* p = coldPool<T>::instance().allocate();
+
+			try { ::new (static_cast<void*>(p)) T(v); }
+			catch (...) { coldPool<T>::instance().deallocate(p); throw ; }
+			return (p);
+		}
+	};
+
+	// Nodes relaid out by tree::compact share one allocation from the tree's allocator, cut into
+	// segments aligned to their size: each segment starts with a pointer to the block header, so
+	// a node finds it from its own address. A segment is a page for most nodes, which keeps the
+	// header on the node's page and the alignment slack (up to one segment) small next to the
+	// several segments compact() asks for before it packs at all. The block counts its live nodes
+	// and is freed with the last one, whichever tree that node has moved to by then (node
+	// handles, merge), so a few survivors of heavy churn keep their whole block alive.
+	template <class Node, class NodeAllocator>
+	struct nodeBlock
+	{
+		typedef typename NodeAllocator::template rebind<char>::other	allocatorChar;
+
+		static const size_t	head = 64;		// segment header, keeps the slots 64-byte aligned
+		static const size_t	minSegments = 4;
+
+		char*	raw;
+		size_t	bytes;
+		size_t	live;
+
+		static size_t segment() {
+			size_t s = 4096;
+
+			while (s < head + 32 * sizeof(Node))
+				s <<= 1;
+			return (s);
+		}
+
+		static size_t perSegment() { return ((segment() - head) / sizeof(Node)); }
+
+		// whether n nodes fill enough segments to be worth a block; smaller trees are relaid
+		// out node by node through the allocator
+		static bool packs(size_t n) { return (n >= minSegments * perSegment()); }
+
+		// room for n nodes; the first slot is returned, the others follow through slot()
+		static Node* create(NodeAllocator& alloc, size_t n) {
+			allocatorChar	a(alloc);
+			size_t			seg = segment();
+			size_t			count = (n + perSegment() - 1) / perSegment();
+			size_t			bytes = count * seg + seg;
+			char*			raw = a.allocate(bytes);
+			char*			base = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(raw) + seg - 1) & ~(seg - 1));
+			nodeBlock*		b = reinterpret_cast<nodeBlock*>(base + sizeof(nodeBlock*));
+
+			b->raw = raw;
+			b->bytes = bytes;
+			b->live = n;
+			for (size_t i = 0; i < count; ++i)
+				*reinterpret_cast<nodeBlock**>(base + i * seg) = b;
+			return (reinterpret_cast<Node*>(base + head));
+		}
+
+		static Node* slot(Node* first, size_t i) {
+			return (reinterpret_cast<Node*>(reinterpret_cast<char*>(first) - head
+				+ i / perSegment() * segment() + head + i % perSegment() * sizeof(Node)));
+		}
+
+		// gives back the memory of a destroyed node
+		static void release(NodeAllocator& alloc, Node* x) {
+			char*		seg = reinterpret_cast<char*>(reinterpret_cast<uintptr_t>(x) & ~(segment() - 1));
+			nodeBlock*	b = *reinterpret_cast<nodeBlock**>(seg);
+
+			if (--b->live == 0)
+				allocatorChar(alloc).deallocate(b->raw, b->bytes);
+		}
+
+		// for the slots of a block that was never filled
+		static void abandon(NodeAllocator& alloc, Node* first) {
+			nodeBlock* b = *reinterpret_cast<nodeBlock**>(reinterpret_cast<char*>(first) - head);
+
+			allocatorChar(alloc).deallocate(b->raw, b->bytes);
+		}
 	};
 
+	// destroys a node and returns its memory, to the allocator or to its nodeBlock
+	template <class Node, class NodeAllocator>
+	void releaseNode(NodeAllocator& alloc, Node* x)
+	{
+		bool packed = x->packed();
+
+		alloc.destroy(x);
+		if (packed)
+			nodeBlock<Node, NodeAllocator>::release(alloc, x);
+		else
+			alloc.deallocate(x, 1);
+	}
 
+	// Node layouts (the Layout parameter of tree and map)
+	struct inline_values
+	{
+		template <class T, class Summary> struct apply { typedef ft::node<T, Summary> type; };
+	};
 
-	template <class Pair, class Allocator, class Compare >
+	// for large mapped types: searches read only links and keys (ft::splitNode)
+	struct split_values
+	{
+		template <class T, class Summary> struct apply { typedef ft::splitNode<T, Summary> type; };
+	};
+
+	// Balancing schemes (the Balance parameter of tree and map). All of them keep one bit per
+	// node, the low bit of the parent link: the color for red_black; for avl and wavl the parity
+	// of rank + 1, which tells a rank difference of 1 from one of 2 and leaves nil (rank -1) at 0.
+	// Rotations, search, iteration, split and join are shared. The tree calls rotated() on
+	// every rotation; a policy derived from one of these can count them.
+
+	// at most 2 log n deep, O(1) rotations per insert and erase
+	struct red_black { static const int scheme = 0; static void rotated() {} };
+
+	// siblings' heights differ by at most one: at most ~1.44 log n deep, for lookup-heavy maps;
+	// erase may rotate all the way up
+	struct avl { static const int scheme = 1; static void rotated() {} };
+
+	// weak AVL: the same trees as AVL while only inserting, erase does at most two rotations
+	// and depth stays under 2 log n
+	struct wavl { static const int scheme = 2; static void rotated() {} };
+
+
+	template <class Pair, class Allocator, class Compare, class Augment = no_augment, class Layout = inline_values,
+		class Balance = red_black >
 	class tree
 	{
 	public:
@@ -40,14 +339,16 @@ namespace ft
 		typedef Allocator 																	allocator_type;
 		typedef typename value_type::first_type												key_type;
 		typedef typename value_type::second_type											mapped_type;
-		typedef typename ft::mapIterator<node<value_type>*, value_type>						iterator;
+		typedef typename Layout::template apply<value_type, typename Augment::summary>::type	node_type;
+		typedef typename Augment::summary													summary_type;
+		typedef typename ft::mapIterator<node_type*, value_type>							iterator;
 		// typedef Allocator::
 		
 
 	private:
 		key_compare					_compare;	
-		node<value_type>* 			_nil;
-		node<value_type>* 			_root;
+		node_type* 			_nil;
+		node_type* 			_root;
 		size_t						_size; //excludes nil
 
 	public:
@@ -56,44 +357,72 @@ namespace ft
 	public:
 		tree(const key_compare &comp):_compare(comp), _size(0){
 			_nil = _alloc.allocate(1);
-			_alloc.construct(_nil, node<value_type>());
-			_nil->left = _nil->right = _nil->parent = _nil;
+			_alloc.construct(_nil, node_type());
+			_nil->left = _nil->right = _nil;
+			_nil->setParent(_nil);
 			_root = _nil;
 		};		
-		tree(const tree& copy){	*this = copy;};
+		tree(const tree& copy):_compare(copy._compare), _size(0){
+			_nil = _alloc.allocate(1);
+			_alloc.construct(_nil, node_type());
+			_nil->left = _nil->right = _nil;
+			_nil->setParent(_nil);
+			_root = _nil;
+			*this = copy;};
+		// the existing nodes are reused for the new contents, only the shortfall is allocated
 		tree &operator=(const tree& copy){
 			if (this != &copy){
-				clear();
-				
-				iterator first = copy.begin();
-				iterator last = copy.end();
-				while(first!= last){
-					insertNode(*first);
-					first++;}				 
+				_compare = copy._compare;
+				buildSorted(copy.iter(copy.begin()), copy.iter(copy.end()));
 			}
 			return *this;
 
 		}
 
+#if __cplusplus >= 201103L
+		// the moved-from tree keeps a fresh empty sentinel, so it stays usable
+		tree(tree&& other):tree(other._compare){ swap(other); };
+		tree &operator=(tree&& other){
+			if (this != &other){
+				clear();
+				swap(other);}
+			return *this;
+		}
+#endif
+
 		~tree(){ clearAll(); };
 
-		// key_type root() { return _root->keyValue.first;}
+		// exchanges the whole structure through its root and sentinel, no node is touched
+		void swap(tree& other)
+		{
+			std::swap(_compare, other._compare);
+			std::swap(_nil, other._nil);
+			std::swap(_root, other._root);
+			std::swap(_size, other._size);
+			std::swap(_alloc, other._alloc);
+		}
+
+		// key_type root() { return _root->key();}
 
-		void destroy(node<value_type>* nd)
+		size_t destroy(node_type* nd)
 		{
+			size_t n = 0;
+
 			if (nd != _nil)
 			{
-				destroy(nd->left);
-				destroy(nd->right);
-				_alloc.destroy(nd);
-				_alloc.deallocate(nd, sizeof(node<value_type>));
+				n += destroy(nd->left);
+				n += destroy(nd->right);
+				releaseNode(_alloc, nd);
+				++n;
 			}
+			return (n);
 		}
 
 		void clear(void) {
 			destroy(_root);
 			_size = 0;
-			_nil->left = _nil->right = _nil->parent = _nil;
+			_nil->left = _nil->right = _nil;
+			_nil->setParent(_nil);
 			_root = _nil;
 
 		}
@@ -102,205 +431,620 @@ namespace ft
 		{
 			clear();
 			_alloc.destroy(_nil);
-			_alloc.deallocate(_nil, sizeof(ft::node<value_type>));
+			_alloc.deallocate(_nil, 1);
 
 		}
 
-		node<value_type>* begin(void) const {
-			node<value_type>* tmp = min(_root);
-			return (tmp);
-		}
+		node_type* nil(void) const { return _nil; }
+
+		iterator iter(node_type* x) const { return iterator(x, _nil); }
 
-		node<value_type>* end(void) const {
-			node<value_type>* tmp = _root;
-			while (tmp != _nil)
-				tmp = tmp->right;
+		node_type* begin(void) const {
+			node_type* tmp = min(_root);
 			return (tmp);
 		}
+
+		node_type* end(void) const { return (_nil); }
 				
-		ft::pair<node<value_type>*, bool> insertNode(const value_type& val)
+		ft::pair<node_type*, bool> insertNode(const value_type& val)
 		{
-			node<value_type>* x = _root;
-			node<value_type>* y = _nil;
+			node_type* x = _root;
+			node_type* y = _nil;
 			
 			while (x != _nil){
 				y = x;
-				if (x->keyValue.first == val.first)
+				if (x->key() == val.first)
 					return (ft::make_pair(x, false));
-				if  (_compare(val, x->keyValue))
+				if  (_compare(val.first, x->key()))
 					x = x->left;
 				else
 					x = x->right;}
-			node<value_type>* newNode = _alloc.allocate(1);
-			_alloc.construct(newNode, ft::node<value_type>(val));
-			
-			newNode->parent = y;
+			node_type* newNode = createNode(val);
+			linkNode(newNode, y);
+			return (ft::make_pair(newNode, true));
+
+		}
+
+		// constructs in place, with no temporary node (a split node would copy its value twice)
+		node_type* createNode(const value_type& val)
+		{
+			node_type* x = _alloc.allocate(1);
+
+			try { ::new (static_cast<void*>(x)) node_type(val); }
+			catch (...) { _alloc.deallocate(x, 1); throw ; }
+			return (x);
+		}
+
+		// Node recycling: detachAll empties the tree but keeps its nodes, chained through
+		// right, and recycleNode rebuilds the payload of the first one in place. The key is
+		// const, so the old value is destroyed and the new one constructed in the same memory.
+
+		// the tree is flattened by right rotations, without a stack, O(n)
+		node_type* detachAll(void)
+		{
+			node_type* chain = _nil;
+			node_type* x = _root;
+			node_type* l;
+
+			while (x != _nil){
+				if (x->left != _nil){
+					l = x->left;
+					x->left = l->right;
+					l->right = x;
+					x = l;}
+				else {
+					l = x->right;
+					x->right = chain;
+					chain = x;
+					x = l;}
+			}
+			_size = 0;
+			_nil->left = _nil->right = _nil;
+			_nil->setParent(_nil);
+			_root = _nil;
+			return (chain);
+		}
+
+		node_type* recycleNode(node_type*& spare, const value_type& val)
+		{
+			node_type* x = spare;
+
+			if (x == _nil)
+				return (createNode(val));
+			bool packed = x->packed();
+
+			spare = x->right;
+			_alloc.destroy(x);
+			try { ::new (static_cast<void*>(x)) node_type(val); }
+			catch (...) {
+				if (packed)
+					nodeBlock<node_type, Allocator>::release(_alloc, x);
+				else
+					_alloc.deallocate(x, 1);
+				throw ; }
+			if (packed)
+				x->setPacked();
+			return (x);
+		}
+
+		void freeChain(node_type* x)
+		{
+			node_type* next;
+
+			for (; x != _nil; x = next){
+				next = x->right;
+				releaseNode(_alloc, x);}
+		}
+
+		// Relayout: the nodes are copied into one nodeBlock in key order and the old ones freed,
+		// so an in-order walk reads memory front to back; a tree too small to fill a few block
+		// segments gets its copies one by one from the allocator instead, in the same order.
+		// Copies keep links, color and summary; the links are then redirected through a
+		// forwarding pointer left in each old node's left link, which the in-order walk never
+		// reads again once the node is behind it.
+		// Invalidates iterators; on an exception the tree is unchanged.
+		void compact(void)
+		{
+			typedef nodeBlock<node_type, Allocator>	block;
+			ft::vector<node_type*>					old(_size);
+			bool									packed = block::packs(_size);
+			node_type*								first = 0;
+			node_type*								x;
+			node_type*								y;
+			size_t									i = 0;
+
+			if (_size == 0)
+				return ;
+			if (packed)
+				first = block::create(_alloc, _size);
+			try {
+				for (x = min(_root); x != _nil; x = successor(x), ++i){
+					y = packed ? block::slot(first, i) : _alloc.allocate(1);
+					try { ::new (static_cast<void*>(y)) node_type(*x); }
+					catch (...) {
+						if (!packed)
+							_alloc.deallocate(y, 1);
+						throw ; }
+					y->setPacked(packed);
+					old[i] = x;
+					x->left = y;}
+			}
+			catch (...) {
+				while (i-- > 0){
+					y = old[i]->left;
+					old[i]->left = y->left;
+					_alloc.destroy(y);
+					if (!packed)
+						_alloc.deallocate(y, 1);}
+				if (packed)
+					block::abandon(_alloc, first);
+				throw ;
+			}
+			for (i = 0; i < _size; ++i){
+				y = old[i]->left;
+				if (y->left != _nil)
+					y->left = y->left->left;
+				if (y->right != _nil)
+					y->right = y->right->left;
+				if (y->parent() != _nil)
+					y->setParent(y->parent()->left);
+			}
+			_root = _root->left;
+			_nil->left = _root;
+			for (i = 0; i < _size; ++i)
+				releaseNode(_alloc, old[i]);
+		}
+
+		// Node handles: extractNode takes a node out without freeing it, insertDetached links
+		// such a node into a tree of the same type. Neither allocates or copies the value.
+
+		// hangs the detached node z below y (nil for an empty tree) and rebalances
+		void linkNode(node_type* z, node_type* y)
+		{
+			z->setParent(y);
 			if (y == _nil){
-				_root = newNode;
-				_root->parent = _nil; //different from algor
+				_root = z;
 				_nil->left = _root;} 
-			else if  (_compare(val, y->keyValue))
-				y->left = newNode;
+			else if  (_compare(z->key(), y->key()))
+				y->left = z;
 			else
-				y->right = newNode;
-			newNode->left = newNode->right = _nil;
-			newNode->color = RED;
-			insertFixup(newNode);
+				y->right = z;
+			z->left = z->right = _nil;
+			z->setColor(RED); // for avl and wavl: a leaf has rank 0, so its bit is 1 as well
+			augmentPath(z);
+			if (Balance::scheme == red_black::scheme)
+				insertFixup(z);
+			else
+				rankInsertFixup(z);
 			++_size;
-			return (ft::make_pair(newNode, true));
+		}
+
+		// the node holding k, or with found false the parent a new node for k would hang from
+		ft::pair<node_type*, bool> findSlot(const key_type& k) const { return (findSlotFrom(_root, k)); }
+
+		// the same below x, whose key range must hold k (see fingerStart)
+		ft::pair<node_type*, bool> findSlotFrom(node_type* x, const key_type& k) const
+		{
+			node_type* y = _nil;
 
+			while (x != _nil){
+				y = x;
+				if (x->key() == k)
+					return (ft::make_pair(x, true));
+				if  (_compare(k, x->key()))
+					x = x->left;
+				else
+					x = x->right;}
+			return (ft::make_pair(y, false));
+		}
+
+		// the node holding z's key and whether z was linked (z stays detached when the key exists);
+		// a hint is used as by hintSlot
+		ft::pair<node_type*, bool> insertDetached(node_type* z, node_type* hint = 0)
+		{
+			z->keyChanged();
+			ft::pair<node_type*, bool> slot = hintSlot(hint, z->key());
+
+			if (slot.second)
+				return (ft::make_pair(slot.first, false));
+			linkNode(z, slot.first);
+			return (ft::make_pair(z, true));
+		}
+
+		node_type* extractNode(node_type* z)
+		{
+			unlinkNode(z);
+			if (--_size == 0)
+				_root = _nil;
+			return (z);
+		}
+
+		// moves every node of other whose key is not here yet; the rest stays in other
+		void mergeFrom(tree& other)
+		{
+			node_type* x = other.begin();
+			node_type* next;
+
+			while (x != other._nil){
+				next = other.successor(x); // unlinking moves nodes, never the values, so next stays valid
+				ft::pair<node_type*, bool> slot = findSlot(x->key());
+				if (!slot.second)
+					linkNode(other.extractNode(x), slot.first);
+				x = next;}
 		}
 		
-		void insertFixup(node<value_type> *z)
-		{
-			node<value_type>* y;
-
-			while (z->parent->color == RED){ // parent is red 
-				if (z->parent == z->parent->parent->left){ // z parent is left child
-					y = z->parent->parent->right;
-					if (y->color == RED){ // y is red case
-						z->parent->color = BLACK;
-						y->color = BLACK;
-						z->parent->parent->color = RED;
-						z = z->parent->parent;}
+		void insertFixup(node_type *z)
+		{
+			node_type* y;
+
+			while (z->parent()->color() == RED){ // parent is red 
+				if (z->parent() == z->parent()->parent()->left){ // z parent is left child
+					y = z->parent()->parent()->right;
+					if (y->color() == RED){ // y is red case
+						z->parent()->setColor(BLACK);
+						y->setColor(BLACK);
+						z->parent()->parent()->setColor(RED);
+						z = z->parent()->parent();}
 					else {
-						if (z == z->parent->right){ //y is black case, triangle relationship
-							z = z->parent;
+						if (z == z->parent()->right){ //y is black case, triangle relationship
+							z = z->parent();
 							leftRotate(z);}
-						z->parent->color = BLACK;
-						z->parent->parent->color = RED;
-						rightRotate(z->parent->parent);}
+						z->parent()->setColor(BLACK);
+						z->parent()->parent()->setColor(RED);
+						rightRotate(z->parent()->parent());}
 				}
 				else {
-					y = z->parent->parent->left;
-					if (y->color == RED){ // y (uncle) is red case
-						z->parent->color = BLACK;
-						y->color = BLACK;
-						z->parent->parent->color = RED;
-						z = z->parent->parent;}
+					y = z->parent()->parent()->left;
+					if (y->color() == RED){ // y (uncle) is red case
+						z->parent()->setColor(BLACK);
+						y->setColor(BLACK);
+						z->parent()->parent()->setColor(RED);
+						z = z->parent()->parent();}
 					else {
-						if (z == z->parent->left){ //y is black case, triangle relationship
-							z = z->parent;
+						if (z == z->parent()->left){ //y is black case, triangle relationship
+							z = z->parent();
 							rightRotate(z);}
-						z->parent->color = BLACK;
-						z->parent->parent->color = RED;
-						leftRotate(z->parent->parent);}
+						z->parent()->setColor(BLACK);
+						z->parent()->parent()->setColor(RED);
+						leftRotate(z->parent()->parent());}
+				}
+			}
+			_root->setColor(BLACK); // case 0
+		}
+
+		// Rank-balanced trees (avl, wavl): promote and demote change a rank by one, which flips
+		// the bit; every rank difference is 1 or 2 outside the node being fixed
+
+		int rankDiff(const node_type* p, const node_type* c) const { return (p->color() != c->color() ? 1 : 2); }
+
+		void setRank(node_type* x, int r) { x->setColor((r + 1) & 1); }
+
+		void flipRank(node_type* x) { x->setColor(x->color() ^ 1); }
+
+		// rotates the child c of p above p
+		void rotateUp(node_type* c, node_type* p)
+		{
+			if (c == p->left)
+				rightRotate(p);
+			else
+				leftRotate(p);
+		}
+
+		// x has rank difference 0 below its parent (a new leaf or a joined subtree) and its own
+		// rank differences are 1 or 2 with at least one 1; shared by avl and wavl
+		void rankInsertFixup(node_type* x)
+		{
+			node_type* p = x->parent();
+			node_type* s;
+			node_type* y;
+
+			while (p != _nil && x->color() == p->color()){ // here an even difference can only be 0
+				s = (x == p->left) ? p->right : p->left;
+				if (rankDiff(p, s) == 1){ // promote p, the problem moves up
+					flipRank(p);
+					x = p;
+					p = p->parent();
+					continue;}
+				y = (x == p->left) ? x->right : x->left; // inner child
+				if (rankDiff(x, y) == 2){
+					rotateUp(x, p);
+					flipRank(p);}
+				else {
+					rotateUp(y, x);
+					rotateUp(y, p);
+					flipRank(y);
+					flipRank(x);
+					flipRank(p);}
+				return ;
+			}
+		}
+
+		// x took the place of a removed node, so its rank difference grew by one to d (2 or 3)
+		void rankEraseFixup(node_type* x, int d)
+		{
+			const bool	weak = (Balance::scheme == wavl::scheme);
+			node_type*	p = x->parent();
+			node_type*	s;
+			node_type*	t;
+			node_type*	u;
+			int			up;
+
+			while (p != _nil){
+				s = (x == p->left) ? p->right : p->left;
+				up = rankDiff(p->parent(), p);
+				if (d == 2){ // avl: p must not be 2,2; wavl: only a leaf must not be
+					if (weak ? (p->left != _nil || p->right != _nil) : rankDiff(p, s) == 1)
+						return ;
+					flipRank(p);}
+				else if (rankDiff(p, s) == 2) // wavl only: demote p
+					flipRank(p);
+				else {
+					t = (s == p->right) ? s->right : s->left; // outer child of s
+					u = (s == p->right) ? s->left : s->right;
+					if (weak && rankDiff(s, t) == 2 && rankDiff(s, u) == 2){ // demote p and s
+						flipRank(p);
+						flipRank(s);}
+					else if (rankDiff(s, t) == 1){
+						rotateUp(s, p);
+						if (weak || rankDiff(s, u) == 1){ // promote s, demote p: heights are restored
+							flipRank(s);
+							flipRank(p);
+							if (weak && p->left == _nil && p->right == _nil)
+								flipRank(p); // a leaf has rank 0
+							return ;}
+						x = s; // avl, s was 1,2: p drops two ranks and the subtree one
+						p = s->parent();
+						d = up + 1;
+						continue ;}
+					else {
+						rotateUp(u, s);
+						rotateUp(u, p);
+						flipRank(s); // p drops two ranks; u rises two (wavl) or one (avl)
+						if (weak)
+							return ;
+						flipRank(u);
+						x = u;
+						p = u->parent();
+						d = up + 1;
+						continue ;}
 				}
+				x = p; // p was demoted
+				p = p->parent();
+				d = up + 1;
+				if (d == 2 && weak)
+					return ; // p has a child now, so it is no leaf
 			}
-			_root->color = BLACK; // case 0
 		}
 
-		void rightRotate(node<value_type> *x)
+		void rightRotate(node_type *x)
 		{
-			node<value_type>* y = x->left;
+			node_type* y = x->left;
+
+			Balance::rotated();
 			x->left = y->right;
 			if (y->right != _nil)
-				y->right->parent = x;
-			y->parent = x->parent;
-			if (x->parent == _nil){
+				y->right->setParent(x);
+			y->setParent(x->parent());
+			if (x->parent() == _nil){
 				_root = y;
 				_nil->left = _root;} 			
-			else if (x == x->parent->right)
-				x->parent->right = y;
-			else x->parent->left = y;
+			else if (x == x->parent()->right)
+				x->parent()->right = y;
+			else x->parent()->left = y;
 			y->right = x;
-			x->parent = y;
+			x->setParent(y);
+			augment(x);
+			augment(y);
 			
 		}
 
-		void leftRotate(node<value_type> *x)
+		void leftRotate(node_type *x)
 		{	
-			node<value_type>* y = x->right;
+			node_type* y = x->right;
+
+			Balance::rotated();
 			x->right = y->left;
 			if (y->left != _nil)
-				y->left->parent = x;
-			y->parent = x->parent;
-			if (x->parent == _nil){
+				y->left->setParent(x);
+			y->setParent(x->parent());
+			if (x->parent() == _nil){
 				_root = y;
 				_nil->left = _root;} 
-			else if (x == x->parent->left)
-				x->parent->left = y;
-			else x->parent->right = y;
+			else if (x == x->parent()->left)
+				x->parent()->left = y;
+			else x->parent()->right = y;
 			y->left = x;
-			x->parent = y;
+			x->setParent(y);
+			augment(x);
+			augment(y);
+		}
+
+		void augment(node_type* x)
+		{
+			if (Augment::enabled)
+				Augment::update(x);
+		}
+
+		// recomputes the summaries from x up to the root
+		void augmentPath(node_type* x)
+		{
+			if (Augment::enabled)
+				for (; x != _nil; x = x->parent())
+					Augment::update(x);
+		}
+
+		// Queries on the summaries; select, rank and position need a policy with a count
+
+		// the element at in-order index k, nil when k >= size()
+		node_type* select(size_t k) const
+		{
+			node_type* x = _root;
+
+			while (x != _nil){
+				if (k < x->left->count)
+					x = x->left;
+				else if (k == x->left->count)
+					return (x);
+				else {
+					k -= x->left->count + 1;
+					x = x->right;}
+			}
+			return (_nil);
+		}
+
+		// number of keys less than k
+		size_t rank(const key_type& k) const
+		{
+			node_type*	x = _root;
+			size_t		r = 0;
+
+			while (x != _nil){
+				if (_compare(x->key(), k)){
+					r += x->left->count + 1;
+					x = x->right;}
+				else
+					x = x->left;
+			}
+			return (r);
+		}
+
+		// in-order index of x, size() for nil
+		size_t position(const node_type* x) const
+		{
+			size_t r;
+
+			if (x == _nil)
+				return (_size);
+			r = x->left->count;
+			for (; x != _root; x = x->parent())
+				if (x == x->parent()->right)
+					r += x->parent()->left->count + 1;
+			return (r);
 		}
 
-		void transplant(node<value_type> *u, node<value_type> *v)
+		// combined summary of the keys in [lo, hi): the two boundary paths below the node
+		// where they fork, O(log n)
+		summary_type aggregate(const key_type& lo, const key_type& hi) const
 		{
-			if (u->parent == _nil){
+			node_type*		x = _root;
+			node_type*		y;
+			summary_type	left;
+			summary_type	right;
+
+			while (x != _nil){
+				if (_compare(x->key(), lo))
+					x = x->right;
+				else if (!_compare(x->key(), hi))
+					x = x->left;
+				else
+					break ;}
+			if (x == _nil)
+				return (summary_type());
+			for (y = x->left; y != _nil; ){
+				if (!_compare(y->key(), lo)){
+					left = Augment::combine(Augment::combine(Augment::make(y->value()), *y->right), left);
+					y = y->left;}
+				else
+					y = y->right;
+			}
+			for (y = x->right; y != _nil; ){
+				if (_compare(y->key(), hi)){
+					right = Augment::combine(right, Augment::combine(*y->left, Augment::make(y->value())));
+					y = y->right;}
+				else
+					y = y->left;
+			}
+			return (Augment::combine(Augment::combine(left, Augment::make(x->value())), right));
+		}
+
+		void transplant(node_type *u, node_type *v)
+		{
+			if (u->parent() == _nil){
 				_root = v;
 				_nil->left = _root;} 
-			else if (u == u->parent->left)
-				u->parent->left = v;
+			else if (u == u->parent()->left)
+				u->parent()->left = v;
 			else
-				u->parent->right = v;
-			v->parent = u->parent;
+				u->parent()->right = v;
+			v->setParent(u->parent());
 		}
 
 		
 
-		void deleteFixup(node<value_type> *x){
-			node<value_type> *w;
-
-			while (x != _root && x->color == BLACK){
-				if (x == x->parent->left){
-					w = x->parent->right;
-					if (w->color == RED){
-						w->color = BLACK;
-						x->parent->color = RED;
-						leftRotate(x->parent);
-						w = x->parent->right; }
-					if (w->left->color == BLACK && w->right->color == BLACK){
-						w->color = RED;
-						x = x->parent; }
+		void deleteFixup(node_type *x){
+			node_type *w;
+
+			while (x != _root && x->color() == BLACK){
+				if (x == x->parent()->left){
+					w = x->parent()->right;
+					if (w->color() == RED){
+						w->setColor(BLACK);
+						x->parent()->setColor(RED);
+						leftRotate(x->parent());
+						w = x->parent()->right; }
+					if (w->left->color() == BLACK && w->right->color() == BLACK){
+						w->setColor(RED);
+						x = x->parent(); }
 					else {
-						if (w->right->color == BLACK) {
-							w->left->color = BLACK;
-							w->color = RED;
+						if (w->right->color() == BLACK) {
+							w->left->setColor(BLACK);
+							w->setColor(RED);
 							rightRotate(w);
-							w = x->parent->right; }
-						w->color = x->parent->color;
-						x->parent->color = BLACK;
-						w->right->color = BLACK;
-						leftRotate(x->parent);
+							w = x->parent()->right; }
+						w->setColor(x->parent()->color());
+						x->parent()->setColor(BLACK);
+						w->right->setColor(BLACK);
+						leftRotate(x->parent());
 						x = _root;
 					}		
 				}
 				else {
-					w = x->parent->left;
-					if (w->color == RED){
-						w->color = BLACK;
-						x->parent->color = RED;
-						rightRotate(x->parent);
-						w = x->parent->left; }
-					if (w->right->color == BLACK && w->left->color == BLACK){
-						w->color = RED;
-						x = x->parent; }
+					w = x->parent()->left;
+					if (w->color() == RED){
+						w->setColor(BLACK);
+						x->parent()->setColor(RED);
+						rightRotate(x->parent());
+						w = x->parent()->left; }
+					if (w->right->color() == BLACK && w->left->color() == BLACK){
+						w->setColor(RED);
+						x = x->parent(); }
 					else {
-						if (w->left->color == BLACK) {
-							w->right->color = BLACK;
-							w->color = RED;
+						if (w->left->color() == BLACK) {
+							w->right->setColor(BLACK);
+							w->setColor(RED);
 							leftRotate(w);
-							w = x->parent->left; }
-						w->color = x->parent->color;
-						x->parent->color = BLACK;
-						w->left->color = BLACK;
-						rightRotate(x->parent);
+							w = x->parent()->left; }
+						w->setColor(x->parent()->color());
+						x->parent()->setColor(BLACK);
+						w->left->setColor(BLACK);
+						rightRotate(x->parent());
 						x = _root;}
 				}
 			}
-			x->color = BLACK;
+			x->setColor(BLACK);
 		}
 		
-		void rbTreeDelete(node<value_type> *z)
+		void rbTreeDelete(node_type *z)
 		{
-			node<value_type> 	*x;
-			node<value_type> 	*y = z;
-			int 				yOriginalColor = y->color;
-
 			if (z == _nil){
 				std::cerr << "Tree end() cannot be erased" << std::endl;
 				throw ; }
+			unlinkNode(z);
+			releaseNode(_alloc, z);
+			--_size;
+			if (_size == 0)
+				_root = _nil;
+			
+		}
+
+		// takes z out of the tree and rebalances, z itself is left allocated
+		void unlinkNode(node_type *z)
+		{
+			node_type 	*x;
+			node_type 	*y = z;
+			int 				yOriginalColor = y->color();
+			int					yDiff = rankDiff(y->parent(), y); // avl, wavl: read before y moves
+
 			if (z->left == _nil){
 				x = z->right; 
 				transplant(z, z->right); }
@@ -309,35 +1053,673 @@ namespace ft
 				transplant(z, z->left);}
 			else {
 				y = min(z->right);
-				yOriginalColor = y->color;
+				yOriginalColor = y->color();
+				yDiff = rankDiff(y->parent(), y);
 				x = y->right;
-				if (y->parent == z)
-					x->parent = y;
+				if (y->parent() == z)
+					x->setParent(y);
 				else{
 					transplant(y, y->right);
 					y->right = z->right;
-					y->right->parent = y;}
+					y->right->setParent(y);}
 				transplant(z, y);
 				y->left = z->left;
-				y->left->parent = y;
-				y->color = z->color; }
-			if (yOriginalColor == BLACK)
+				y->left->setParent(y);
+				y->setColor(z->color()); }
+			augmentPath(x->parent()); // x (possibly nil) hangs where the shape changed
+			if (Balance::scheme != red_black::scheme)
+				rankEraseFixup(x, yDiff + 1); // y had at most one child and it was a 1-child
+			else if (yOriginalColor == BLACK)
 				deleteFixup(x);
-			_alloc.destroy(z);
-			_alloc.deallocate(z, sizeof(node<value_type>));
-			--_size;
-			if (_size == 0)
-				_root = _nil;
-			
 		}
 
-		node<value_type>* treeSearch(const key_type& k) const
+		node_type* successor(node_type* x) const
+		{
+			node_type* y;
+
+			if (x->right != _nil)
+				return (min(x->right));
+			y = x->parent();
+			while (y != _nil && x == y->right){
+				x = y;
+				y = y->parent();}
+			return (y);
+		}
+
+		node_type* predecessor(node_type* x) const
+		{
+			node_type* y;
+
+			if (x->left != _nil)
+				return (max(x->left));
+			y = x->parent();
+			while (y != _nil && x == y->left){
+				x = y;
+				y = y->parent();}
+			return (y);
+		}
+
+		// Linear build from sorted input: the nodes are created in key order and chained
+		// through right, then hung into a balanced shape. Every nil sits at depth d or d + 1
+		// for d = floor(log2(n + 1)), so the levels above d are black and level d is red.
+
+		// replaces the contents with [first, last), which must be strictly increasing, reusing
+		// the current nodes before allocating; on an exception the tree is left empty
+		template <class InputIterator>
+		void buildSorted(InputIterator first, InputIterator last)
+		{
+			node_type*	spare = detachAll();
+			node_type*	head = _nil;
+			node_type*	tail = _nil;
+			size_t		n = 0;
+			int			red = 0;
+
+			try {
+				for (; first != last; ++first){
+					node_type* x = recycleNode(spare, value_type(first->first, first->second));
+					x->left = x->right = _nil;
+					if (tail == _nil)
+						head = x;
+					else
+						tail->right = x;
+					if (n++ && !_compare(tail->key(), x->key()))
+						throw std::invalid_argument("ft::tree: input is not strictly increasing");
+					tail = x;
+				}
+			}
+			catch (...) {
+				freeChain(head);
+				freeChain(spare);
+				throw ;
+			}
+			freeChain(spare);
+			while ((static_cast<size_t>(2) << red) <= n + 1)
+				++red;
+			setRoot(shapeChain(head, n, 0, red));
+			_size = n;
+		}
+
+		// hangs the next n nodes of the chain into a balanced subtree
+		node_type* shapeChain(node_type*& head, size_t n, int depth, int red)
+		{
+			node_type* x;
+			node_type* l;
+
+			if (n == 0)
+				return (_nil);
+			l = shapeChain(head, n / 2, depth + 1, red);
+			x = head;
+			head = head->right;
+			x->left = l;
+			if (l != _nil)
+				l->setParent(x);
+			x->right = shapeChain(head, n - n / 2 - 1, depth + 1, red);
+			if (x->right != _nil)
+				x->right->setParent(x);
+			if (Balance::scheme == red_black::scheme)
+				x->setColor(depth >= red ? RED : BLACK);
+			else
+				setRank(x, floorLog2(n)); // the height of a subtree of n nodes split evenly
+			augment(x);
+			return (x);
+		}
+
+		static int floorLog2(size_t n)
+		{
+			int r = 0;
+
+			while (n >>= 1)
+				++r;
+			return (r);
+		}
+
+		// Split and join.
+		// They work on detached subtrees (root parent is nil) that all share this tree's nil.
+		// Rotations and fixups keep _root pointing at the subtree being balanced, so _root is
+		// scratch while they run and setRoot() publishes the final tree.
+
+		// black nodes on every path from x down to nil, x included
+		int blackHeight(node_type* x) const
 		{
-			node<value_type>* x = _root;
-			ft::pair<key_type, mapped_type> kPair = ft::make_pair(k, 0);
+			int h = 0;
 
-			while (x != _nil && k != x->keyValue.first) {	
-				if (_compare(kPair, x->keyValue) == true )
+			for (; x != _nil; x = x->left)
+				if (x->color() == BLACK)
+					++h;
+			return (h);
+		}
+
+		void setRoot(node_type* x)
+		{
+			_root = x;
+			if (x != _nil){
+				x->setParent(_nil);
+				if (Balance::scheme == red_black::scheme)
+					x->setColor(BLACK);}
+			_nil->left = _root;
+		}
+
+		// all keys of l < k->value() < all keys of r
+		node_type* join(node_type* l, node_type* k, node_type* r)
+		{
+			if (Balance::scheme == red_black::scheme)
+				return (redBlackJoin(l, k, r));
+			return (rankJoin(l, k, r));
+		}
+
+		// O(|bh(l) - bh(r)| + 1)
+		node_type* redBlackJoin(node_type* l, node_type* k, node_type* r)
+		{
+			node_type*	c;
+			node_type*	p = _nil;
+			int					hl;
+			int					hr;
+
+			if (l != _nil)
+				l->setColor(BLACK);
+			if (r != _nil)
+				r->setColor(BLACK);
+			hl = blackHeight(l);
+			hr = blackHeight(r);
+			k->setColor(RED);
+			if (hl == hr){
+				k->left = l;
+				k->right = r;
+				if (l != _nil)
+					l->setParent(k);
+				if (r != _nil)
+					r->setParent(k);
+				k->setParent(_nil);
+				k->setColor(BLACK);
+				augment(k);
+				return (k);}
+			if (hl > hr){ // hang k and r off the right spine of l, at a black node of height hr
+				c = l;
+				while (c->color() == RED || hl > hr){
+					if (c->color() == BLACK)
+						--hl;
+					p = c;
+					c = c->right;}
+				k->left = c;
+				k->right = r;
+				p->right = k;
+				_root = l;}
+			else {
+				c = r;
+				while (c->color() == RED || hr > hl){
+					if (c->color() == BLACK)
+						--hr;
+					p = c;
+					c = c->left;}
+				k->left = l;
+				k->right = c;
+				p->left = k;
+				_root = r;}
+			if (k->left != _nil)
+				k->left->setParent(k);
+			if (k->right != _nil)
+				k->right->setParent(k);
+			k->setParent(p);
+			_root->setParent(_nil);
+			augmentPath(k);
+			insertFixup(k);
+			return (_root);
+		}
+
+		// rank of a subtree from the differences down its left spine, O(log n)
+		int rankOf(node_type* x) const
+		{
+			int r = -1;
+
+			for (; x != _nil; x = x->left)
+				r += rankDiff(x, x->left);
+			return (r);
+		}
+
+		// k goes down the spine of the higher tree to a node c whose rank is within one of the
+		// lower tree's, takes c and the lower tree as children and is fixed up like an inserted
+		// node; O(|rank(l) - rank(r)| + log n)
+		node_type* rankJoin(node_type* l, node_type* k, node_type* r)
+		{
+			node_type*	c;
+			node_type*	p = _nil;
+			int			rl = rankOf(l);
+			int			rr = rankOf(r);
+			int			rc;
+			int			rp = 0;
+
+			if (rl - rr <= 1 && rr - rl <= 1){
+				k->left = l;
+				k->right = r;
+				if (l != _nil)
+					l->setParent(k);
+				if (r != _nil)
+					r->setParent(k);
+				k->setParent(_nil);
+				setRank(k, (rl > rr ? rl : rr) + 1);
+				augment(k);
+				return (k);}
+			if (rl > rr){
+				for (c = l, rc = rl; rc > rr + 1; c = c->right){
+					p = c;
+					rp = rc;
+					rc -= rankDiff(c, c->right);}
+				k->left = c;
+				k->right = r;
+				p->right = k;
+				_root = l;}
+			else {
+				for (c = r, rc = rr; rc > rl + 1; c = c->left){
+					p = c;
+					rp = rc;
+					rc -= rankDiff(c, c->left);}
+				k->left = l;
+				k->right = c;
+				p->left = k;
+				_root = r;}
+			if (k->left != _nil)
+				k->left->setParent(k);
+			if (k->right != _nil)
+				k->right->setParent(k);
+			k->setParent(p);
+			_root->setParent(_nil);
+			rc = (rl < rr ? rl : rr) > rc ? (rl < rr ? rl : rr) : rc; // the higher of k's children
+			setRank(k, rc + 1);
+			augmentPath(k);
+			if (rc + 1 == rp)
+				rankInsertFixup(k);
+			return (_root);
+		}
+
+		// join without a middle node: the minimum of r is taken out and used as pivot
+		node_type* join(node_type* l, node_type* r)
+		{
+			node_type* m;
+
+			if (l == _nil)
+				return (r);
+			if (r == _nil)
+				return (l);
+			_root = r;
+			r->setParent(_nil);
+			m = min(r);
+			unlinkNode(m);
+			return (join(l, m, _root));
+		}
+
+		// l gets the keys < k, r the keys > k; the node equal to k is returned detached (or nil)
+		node_type* split(node_type* t, const key_type& k, node_type*& l, node_type*& r)
+		{
+			node_type* tl;
+			node_type* tr;
+			node_type* m;
+
+			if (t == _nil){
+				l = r = _nil;
+				return (_nil);}
+			tl = t->left;
+			tr = t->right;
+			if (tl != _nil)
+				tl->setParent(_nil);
+			if (tr != _nil)
+				tr->setParent(_nil);
+			if (_compare(k, t->key())){
+				m = split(tl, k, l, r);
+				r = join(r, t, tr);
+				return (m);}
+			if (_compare(t->key(), k)){
+				m = split(tr, k, l, r);
+				l = join(tl, t, l);
+				return (m);}
+			l = tl;
+			r = tr;
+			t->left = t->right = _nil;
+			return (t);
+		}
+
+		// points the nil leaves of a subtree taken from another tree at this tree's nil
+		size_t relink(node_type* x, node_type* otherNil)
+		{
+			size_t n = 1;
+
+			if (x->left == otherNil)
+				x->left = _nil;
+			else
+				n += relink(x->left, otherNil);
+			if (x->right == otherNil)
+				x->right = _nil;
+			else
+				n += relink(x->right, otherNil);
+			return (n);
+		}
+
+		// moves a detached subtree of this tree into the empty tree out
+		void give(node_type* x, tree& out)
+		{
+			size_t n = 0;
+
+			if (x != _nil)
+				n = out.relink(x, _nil);
+			out.setRoot(x == _nil ? out._nil : x);
+			out._size = n;
+			_size -= n;
+		}
+
+		// erases [first, last): O(log n) to cut the range out, O(k) to free it
+		void eraseRange(node_type* first, node_type* last)
+		{
+			node_type*	l;
+			node_type*	r;
+			node_type*	mid;
+			size_t				n = 0;
+
+			for (node_type* x = first; x != last && n < 16; x = successor(x))
+				++n;
+			if (n < 16){ // short ranges are cheaper node by node
+				while (first != last){
+					node_type* next = successor(first);
+					rbTreeDelete(first);
+					first = next;}
+				return ;}
+			split(_root, first->key(), l, r);
+			n = destroy(first);
+			if (last == _nil){
+				n += destroy(r);
+				setRoot(l);}
+			else {
+				split(r, last->key(), mid, r);
+				n += destroy(mid);
+				setRoot(join(l, last, r));}
+			_size -= n;
+		}
+
+		// moves the elements with key >= k into out, replacing its contents
+		void splitTo(const key_type& k, tree& out)
+		{
+			node_type* l;
+			node_type* r;
+			node_type* m;
+
+			out.clear();
+			m = split(_root, k, l, r);
+			if (m != _nil)
+				r = join(_nil, m, r);
+			setRoot(l);
+			give(r, out);
+		}
+
+		// moves [first, last) into out, replacing its contents
+		void extractRange(node_type* first, node_type* last, tree& out)
+		{
+			node_type* l;
+			node_type* r;
+			node_type* mid;
+
+			out.clear();
+			if (first == last)
+				return ;
+			split(_root, first->key(), l, r);
+			if (last == _nil){
+				mid = join(_nil, first, r);
+				setRoot(l);}
+			else {
+				split(r, last->key(), mid, r);
+				mid = join(_nil, first, mid);
+				setRoot(join(l, last, r));}
+			give(mid, out);
+		}
+
+		// set operations, O(m log(n/m + 1)) for sizes m <= n
+		node_type* unionSub(node_type* t1, node_type* t2, size_t& dups)
+		{
+			node_type* l1;
+			node_type* r1;
+			node_type* l2;
+			node_type* r2;
+			node_type* m;
+			node_type* l;
+
+			if (t1 == _nil)
+				return (t2);
+			if (t2 == _nil)
+				return (t1);
+			l1 = t1->left;
+			r1 = t1->right;
+			if (l1 != _nil)
+				l1->setParent(_nil);
+			if (r1 != _nil)
+				r1->setParent(_nil);
+			m = split(t2, t1->key(), l2, r2);
+			if (m != _nil)
+				dups += destroy(m);
+			l = unionSub(l1, l2, dups);
+			return (join(l, t1, unionSub(r1, r2, dups)));
+		}
+
+		node_type* intersectSub(node_type* t1, const node_type* t2, const node_type* otherNil, size_t& removed)
+		{
+			node_type* l1;
+			node_type* r1;
+			node_type* m;
+			node_type* l;
+
+			if (t1 == _nil)
+				return (_nil);
+			if (t2 == otherNil){
+				removed += destroy(t1);
+				return (_nil);}
+			m = split(t1, t2->key(), l1, r1);
+			l = intersectSub(l1, t2->left, otherNil, removed);
+			r1 = intersectSub(r1, t2->right, otherNil, removed);
+			if (m != _nil)
+				return (join(l, m, r1));
+			return (join(l, r1));
+		}
+
+		node_type* subtractSub(node_type* t1, const node_type* t2, const node_type* otherNil, size_t& removed)
+		{
+			node_type* l1;
+			node_type* r1;
+			node_type* m;
+			node_type* l;
+
+			if (t1 == _nil || t2 == otherNil)
+				return (t1);
+			m = split(t1, t2->key(), l1, r1);
+			if (m != _nil)
+				removed += destroy(m);
+			l = subtractSub(l1, t2->left, otherNil, removed);
+			return (join(l, subtractSub(r1, t2->right, otherNil, removed)));
+		}
+
+		// moves every element of other into this tree, keys already present keep this tree's value
+		void unite(tree& other)
+		{
+			size_t dups = 0;
+
+			if (other._root == other._nil)
+				return ;
+			relink(other._root, other._nil);
+			other._root->setParent(_nil);
+			setRoot(unionSub(_root, other._root, dups));
+			_size += other._size - dups;
+			other._root = other._nil;
+			other._nil->left = other._nil;
+			other._size = 0;
+		}
+
+		// keeps only the keys that are also in other
+		void intersect(const tree& other)
+		{
+			size_t removed = 0;
+
+			setRoot(intersectSub(_root, other._root, other._nil, removed));
+			_size -= removed;
+		}
+
+		// drops the keys that are in other
+		void subtract(const tree& other)
+		{
+			size_t removed = 0;
+
+			setRoot(subtractSub(_root, other._root, other._nil, removed));
+			_size -= removed;
+		}
+
+		// Batched upserts and erases (map::apply_batch): the ops are sorted, so each search starts
+		// from where the previous op left off (fingerStart) and climbs only to the common
+		// ancestor of the two keys instead of coming down from the root. The climb is a chain of
+		// dependent loads, and sorted descents from the root already find the shared top of
+		// their paths in cache, so the finger only pays off once the ops are at most a few
+		// entries apart: sparser batches search from the root. The insert and erase fixups are
+		// amortized O(1) and stay per op.
+		// ops[0, n) sorted by key, equal keys applied in order; each has .key, .value and .erase.
+		// results, when not 0, gets one entry per op: 1 inserted or erased, 0 updated or absent.
+		// If an insert throws, the ops before it are applied.
+		template <class RandomIt>
+		void applyBatch(RandomIt ops, size_t n, char* results)
+		{
+			node_type*	finger = 0;
+			const bool	sparse = n * 4 < _size; // more than 4 entries per op: from the root
+
+			for (size_t i = 1; i < n; ++i)
+				if (_compare(ops[i].key, ops[i - 1].key))
+					throw std::invalid_argument("ft::tree: batch is not sorted by key");
+			for (size_t i = 0; i < n; ++i){
+				ft::pair<node_type*, bool> slot = findSlotFrom(fingerStart(sparse ? 0 : finger, ops[i].key).first, ops[i].key);
+
+				if (results)
+					results[i] = ops[i].erase ? slot.second : !slot.second;
+				if (ops[i].erase){
+					finger = slot.first;
+					if (slot.second){ // unlinking moves nodes, not values: the successor stays put
+						finger = successor(slot.first);
+						rbTreeDelete(slot.first);}
+				}
+				else if (slot.second){
+					slot.first->value().second = ops[i].value;
+					augmentPath(slot.first); // summaries may read the value
+					finger = slot.first;}
+				else {
+					finger = createNode(value_type(ops[i].key, ops[i].value));
+					linkNode(finger, slot.first);}
+			}
+		}
+
+		// Finger search: from the finger f (nil stands for the maximum, 0 for none) climb to the
+		// lowest ancestor whose key range holds k, then search down from it as from the root.
+		// Returns that subtree and, when k is right of f, the node bounding its range from above
+		// (nil if none). Climbing over a link that points the other way leaves the range bound on
+		// the side of k as it is, so only links pointing toward k cost a comparison. O(log d) for d
+		// keys between f and k, except when the two sit on both sides of an ancestor far up: the
+		// climb then goes all the way to it.
+		ft::pair<node_type*, node_type*> fingerStart(const node_type* finger, const key_type& k) const
+		{
+			node_type* f = const_cast<node_type*>(finger); // const iterators hold const nodes
+			node_type* start;
+			node_type* p;
+			bool toward;
+
+			if (f == 0) // no finger
+				return (ft::make_pair(_root, _nil));
+			if (f == _nil){ // appending past the maximum needs no climb
+				f = max(_root);
+				if (f == _nil || _compare(f->key(), k))
+					return (ft::make_pair(f, _nil));}
+			if (k == f->key())
+				return (ft::make_pair(f, f));
+			start = f;
+			if (_compare(f->key(), k)){
+				for (; (p = f->parent()) != _nil; f = p){
+					toward = (f == p->left);
+					if (toward && !_compare(p->key(), k)) // p->key() >= k > everything below f
+						return (ft::make_pair(k == p->key() ? p : start, p));
+					if (toward)
+						start = p;}
+			}
+			else {
+				for (; (p = f->parent()) != _nil; f = p){
+					toward = (f == p->right);
+					if (toward && !_compare(k, p->key()))
+						return (ft::make_pair(k == p->key() ? p : start, _nil));
+					if (toward)
+						start = p;}
+			}
+			return (ft::make_pair(start, _nil)); // no bound on the side of k
+		}
+
+		node_type* searchFrom(const node_type* finger, const key_type& k) const
+		{
+			node_type* x = fingerStart(finger, k).first;
+
+			while (x != _nil && k != x->key()){
+				if (_compare(k, x->key()))
+					x = x->left;
+				else
+					x = x->right;}
+			return (x);
+		}
+
+		node_type* lowerBoundFrom(const node_type* finger, const key_type& k) const
+		{
+			ft::pair<node_type*, node_type*> start = fingerStart(finger, k);
+			node_type* x = start.first;
+			node_type* result = start.second;
+
+			while (x != _nil){
+				if (!_compare(x->key(), k)){
+					result = x;
+					x = x->left;}
+				else
+					x = x->right;}
+			return (result);
+		}
+
+		// findSlot next to a hint (nil for end(), 0 for none): when k falls between the hint and
+		// its neighbour the new node hangs below one of the two, O(1) amortized; any other hint
+		// costs a comparison or two and the search starts from the root, so a hinted insert is
+		// never much slower than a plain one. Unlike fingerStart it does not climb.
+		ft::pair<node_type*, bool> hintSlot(node_type* hint, const key_type& k) const
+		{
+			node_type* n;
+
+			if (hint == 0)
+				return (findSlot(k));
+			if (hint == _nil){ // appending past the maximum
+				n = max(_root);
+				if (n == _nil || _compare(n->key(), k))
+					return (ft::make_pair(n, false));}
+			else if (_compare(k, hint->key())){
+				n = predecessor(hint);
+				if (n == _nil || _compare(n->key(), k))
+					return (ft::make_pair(hint->left == _nil ? hint : n, false));}
+			else if (_compare(hint->key(), k)){
+				n = successor(hint);
+				if (n == _nil || _compare(k, n->key()))
+					return (ft::make_pair(hint->right == _nil ? hint : n, false));}
+			else
+				return (ft::make_pair(hint, true));
+			return (findSlot(k));
+		}
+
+		ft::pair<node_type*, bool> insertNodeFrom(node_type* hint, const value_type& val)
+		{
+			ft::pair<node_type*, bool> slot = hintSlot(hint, val.first);
+			node_type* z;
+
+			if (slot.second)
+				return (ft::make_pair(slot.first, false));
+			z = createNode(val);
+			linkNode(z, slot.first);
+			return (ft::make_pair(z, true));
+		}
+
+		node_type* treeSearch(const key_type& k) const
+		{
+			node_type* x = _root;
+
+			while (x != _nil && k != x->key()) {	
+				if (_compare(k, x->key()) == true )
 					x = x->left;			
 				else 
 					x = x->right; }
@@ -345,17 +1727,61 @@ namespace ft
 
 		}
 
+		// Batched lookup: a group of searches advances one level per round and each one
+		// prefetches the node it moves to, so the cache misses of the group overlap instead of
+		// coming one after another. visit(x) gets the node (or nil) of every key, in order.
+		static const size_t batchWidth = 16;
+
+		template <class KeyIterator, class Visit>
+		void searchBatch(KeyIterator first, KeyIterator last, Visit& visit) const
+		{
+			const key_type*	keys[batchWidth];
+			node_type*		x[batchWidth];
+			size_t			n;
+
+			while (first != last){
+				for (n = 0; n < batchWidth && first != last; ++n, ++first){
+					keys[n] = &*first;
+					x[n] = _root;}
+				searchGroup(keys, x, n);
+				for (size_t i = 0; i < n; ++i)
+					visit(x[i]);
+			}
+		}
+
+		void searchGroup(const key_type* const* keys, node_type** x, size_t n) const
+		{
+			size_t active = n;
+
+			while (active){
+				active = 0;
+				for (size_t i = 0; i < n; ++i){
+					if (x[i] == _nil || *keys[i] == x[i]->key())
+						continue ;
+					x[i] = _compare(*keys[i], x[i]->key()) ? x[i]->left : x[i]->right;
+					prefetch(x[i]);
+					++active;}
+			}
+		}
+
+		static void prefetch(const node_type* p) {
+		#ifdef __GNUC__
+			__builtin_prefetch(p);
+		#else
+			(void)p;
+		#endif
+		}
+
 		size_t size(void) const { return _size; }
 
-		node<value_type>* lower_bound (const key_type & k) const
+		node_type* lower_bound (const key_type & k) const
 		{
-			node<value_type>* rootp = _root;
-			node<value_type>* result = _nil;
-			ft::pair<key_type, mapped_type> kPair = ft::make_pair(k, 0);
+			node_type* rootp = _root;
+			node_type* result = _nil;
 			
 			while (rootp != _nil)
 			{
-			    if (!_compare(rootp->keyValue, kPair)) {
+			    if (!_compare(rootp->key(), k)) {
 			        result = rootp;
 			        rootp = rootp->left; }
 			    else
@@ -364,15 +1790,14 @@ namespace ft
 		    return (result);
 		}
 
-		node<value_type>* upper_bound (const key_type & k) const
+		node_type* upper_bound (const key_type & k) const
 		{
-			node<value_type>* rootp = _root;
-			node<value_type>* result = _nil;
-			ft::pair<key_type, mapped_type> kPair = ft::make_pair(k, 0);
+			node_type* rootp = _root;
+			node_type* result = _nil;
 			
 			while (rootp != _nil)
 			{
-			    if (_compare(kPair, rootp->keyValue)) {
+			    if (_compare(k, rootp->key())) {
 			        result = rootp;
 			        rootp = rootp->left; }
 			    else
@@ -381,29 +1806,28 @@ namespace ft
 		    return (result);
 		}
 
-		ft::pair<iterator, iterator> equal_range_unique(const key_type& k) 
+		ft::pair<iterator, iterator> equal_range_unique(const key_type& k) const
 		{
 			typedef ft::pair<iterator, iterator> _Pp;
 
-			ft::pair<key_type, mapped_type> kPair = ft::make_pair(k, 0);
-			node<value_type>* result = _nil;
-			node<value_type>* rootp = _root;
+			node_type* result = _nil;
+			node_type* rootp = _root;
 
 			while (rootp != _nil)
 			{
-				if (_compare(kPair, rootp->keyValue)){
+				if (_compare(k, rootp->key())){
 					result =rootp;
 					rootp = rootp->left;}
-				else if (_compare(rootp->keyValue, kPair))
+				else if (_compare(rootp->key(), k))
 					rootp = rootp->right;
 				else
-					return _Pp(iterator(rootp), iterator(rootp->right != _nil ? min(rootp->right) : result));
+					return _Pp(iter(rootp), iter(rootp->right != _nil ? min(rootp->right) : result));
 			}
 
-			return _Pp(iterator(result), iterator(result));
+			return _Pp(iter(result), iter(result));
 		}
 
-		void printBT(const std::string& prefix, const node<value_type>* nodeV, bool isLeft) const
+		void printBT(const std::string& prefix, const node_type* nodeV, bool isLeft) const
 		{
 				std::cout << prefix;
 
@@ -414,10 +1838,10 @@ namespace ft
 					return ;
 				}
 				// print the value of the node
-				if (nodeV->color == 0)
-					std::cout <<"\033[0;36m"<< nodeV->keyValue.first<<"\033[0m"<<std::endl;
+				if (nodeV->color() == 0)
+					std::cout <<"\033[0;36m"<< nodeV->key()<<"\033[0m"<<std::endl;
 				else
-					std::cout <<"\033[0;31m"<< nodeV->keyValue.first << "\033[0m"<<std::endl;
+					std::cout <<"\033[0;31m"<< nodeV->key() << "\033[0m"<<std::endl;
 				printBT( prefix + (isLeft ? "│   " : "    "), nodeV->left, true);
 				printBT( prefix + (isLeft ? "│   " : "    "), nodeV->right, false);		
 		}
@@ -427,20 +1851,26 @@ namespace ft
 		}
 
 
-		node<value_type>* min(node<value_type>* x) const {
-			while (x->left->isNil != true)
+		node_type* min(node_type* x) const {
+			while (x->left != _nil)
 				x = x->left;
 			return (x);
 		}
+
+		node_type* max(node_type* x) const {
+			while (x != _nil && x->right != _nil)
+				x = x->right;
+			return (x);
+		}
 		
 		friend bool	operator==(const tree& x, const tree& y){
 			if (x.size() != y.size())
 				return false;
-			return (ft::equal(iterator(x.begin()), iterator(x.end()), iterator(y.begin())));
+			return (ft::equal(x.iter(x.begin()), x.iter(x.end()), y.iter(y.begin())));
 		};
 		
 	};
 	 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,531 @@
+#ifndef UNORDERED_MAP_HPP
+#define UNORDERED_MAP_HPP
+
+#include <memory>
+#include <functional>
+#include <utility>
+#include <stdexcept>
+#include "utils.hpp"
+#include "iterator.hpp"
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
+namespace ft
+{
+	// Control bytes of a swiss table: one per slot, a full slot stores the low 7 bits of its
+	// key's hash (0..127), the others are negative. The sentinel ends the array for iterators.
+	enum
+	{
+		swissEmpty = -128,
+		swissDeleted = -2,
+		swissSentinel = -1
+	};
+
+	// 16 control bytes compared at once: one SSE2 compare and movemask per probe, or a plain
+	// loop building the same bit mask when SSE2 is not available
+	struct swissGroup
+	{
+		static const size_t width = 16;
+
+	#ifdef __SSE2__
+		__m128i ctrl;
+
+		explicit swissGroup(const signed char* p): ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+		unsigned match(signed char h) const {
+			return (static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h), ctrl)))); }
+
+		unsigned matchEmptyOrDeleted() const {
+			return (static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(swissSentinel), ctrl)))); }
+	#else
+		const signed char* ctrl;
+
+		explicit swissGroup(const signed char* p): ctrl(p) {}
+
+		unsigned match(signed char h) const {
+			unsigned m = 0;
+
+			for (size_t i = 0; i < width; ++i)
+				m |= static_cast<unsigned>(ctrl[i] == h) << i;
+			return (m); }
+
+		unsigned matchEmptyOrDeleted() const {
+			unsigned m = 0;
+
+			for (size_t i = 0; i < width; ++i)
+				m |= static_cast<unsigned>(ctrl[i] < swissSentinel) << i;
+			return (m); }
+	#endif
+
+		unsigned matchEmpty() const { return (match(swissEmpty)); }
+
+		// index of the lowest set bit, m != 0
+		static unsigned first(unsigned m) {
+		#ifdef __GNUC__
+			return (static_cast<unsigned>(__builtin_ctz(m)));
+		#else
+			unsigned i = 0;
+
+			for (; !(m & 1); m >>= 1)
+				++i;
+			return (i);
+		#endif
+		}
+
+		// zero bits above the highest set bit of a group mask
+		static unsigned leadingZeros(unsigned m) {
+			unsigned n = width;
+
+			for (; m; m >>= 1)
+				--n;
+			return (n);
+		}
+	};
+
+	template <class Value>
+	class swissIterator
+	{
+		public:
+			typedef Value							value_type;
+			typedef Value&							reference;
+			typedef Value*							pointer;
+			typedef forward_iterator_tag			iterator_category;
+			typedef ptrdiff_t						difference_type;
+
+		private:
+			const signed char*	_ctrl;
+			Value*				_slot;
+
+		public:
+			swissIterator(const signed char* ctrl = 0, Value* slot = 0): _ctrl(ctrl), _slot(slot){};
+
+			template <class V>
+			swissIterator(const swissIterator<V>& cp): _ctrl(cp.ctrl()), _slot(cp.base()){};
+
+			const signed char* ctrl() const { return _ctrl; }
+			Value* base() const { return _slot; }
+
+			reference operator*() const { return *_slot; }
+			pointer operator->() const { return _slot; }
+
+			// stops on a full slot or on the sentinel
+			void skipFree() {
+				while (*_ctrl < swissSentinel){
+					++_ctrl;
+					++_slot;}
+			}
+
+			swissIterator& operator++() { ++_ctrl; ++_slot; skipFree(); return (*this); }
+			swissIterator operator++(int) { swissIterator tmp(*this); ++(*this); return tmp; }
+
+			template <class V>
+			bool operator==(const swissIterator<V>& it) const { return (_ctrl == it.ctrl()); }
+			template <class V>
+			bool operator!=(const swissIterator<V>& it) const { return !(*this == it); }
+	};
+
+
+	// Unordered map on an open-addressing swiss table: a control byte array probed one
+	// 16-byte group at a time and a flat array of pair<const Key, T> slots.
+	// The capacity is 2^k - 1; the control array holds capacity bytes, the sentinel and a copy
+	// of its first 15 bytes, so a group load never wraps. At most 7/8 of the slots are used.
+	// Erasing never moves elements: only the erased element's iterators are invalidated.
+	// Inserting invalidates all iterators when it rehashes.
+	template <class Key, class T, class Hash = ft::hash<Key>, class KeyEqual = std::equal_to<Key>,
+		class Allocator = std::allocator<pair<const Key, T> > >
+	class unordered_map
+	{
+
+	public:
+		typedef Key																key_type;
+		typedef T																mapped_type;
+		typedef ft::pair<const key_type, mapped_type>							value_type;
+		typedef Hash															hasher;
+		typedef KeyEqual														key_equal;
+		typedef Allocator														allocator_type;
+		typedef size_t															size_type;
+		typedef ptrdiff_t														difference_type;
+		typedef value_type&														reference;
+		typedef const value_type&												const_reference;
+
+		typedef ft::swissIterator<value_type>									iterator;
+		typedef ft::swissIterator<const value_type>								const_iterator;
+
+	private:
+		typedef typename Allocator::template rebind<value_type>::other			allocatorSlot;
+		typedef typename Allocator::template rebind<signed char>::other			allocatorCtrl;
+
+		static const size_t		width = swissGroup::width;
+
+		hasher				_hash;
+		key_equal			_eq;
+		allocatorSlot		_alloc;
+		allocatorCtrl		_ctrlAlloc;
+		signed char*		_ctrl;
+		value_type*			_slots;
+		size_type			_capacity;		// 0 or 2^k - 1, also the probe mask
+		size_type			_size;
+		size_type			_growthLeft;	// inserts into empty slots before a rehash
+
+	public:
+
+		explicit unordered_map (size_type bucket_count = 0, const hasher& hash = hasher(), const key_equal& equal = key_equal(),
+			const allocator_type& alloc = allocator_type()):
+			_hash(hash), _eq(equal), _alloc(alloc), _ctrlAlloc(alloc), _ctrl(emptyGroup()), _slots(0),
+			_capacity(0), _size(0), _growthLeft(0)
+		{ if (bucket_count) reserve(bucket_count); };
+
+		template <class InputIterator>
+			unordered_map (InputIterator first, InputIterator last, size_type bucket_count = 0, const hasher& hash = hasher(),
+			const key_equal& equal = key_equal(), const allocator_type& alloc = allocator_type()):
+			_hash(hash), _eq(equal), _alloc(alloc), _ctrlAlloc(alloc), _ctrl(emptyGroup()), _slots(0),
+			_capacity(0), _size(0), _growthLeft(0)
+		{
+			if (bucket_count)
+				reserve(bucket_count);
+			insert(first, last);
+		};
+
+		unordered_map(const unordered_map& x):
+			_hash(x._hash), _eq(x._eq), _alloc(x._alloc), _ctrlAlloc(x._ctrlAlloc), _ctrl(emptyGroup()), _slots(0),
+			_capacity(0), _size(0), _growthLeft(0)
+		{
+			reserve(x.size());
+			insert(x.begin(), x.end());
+		};
+
+		unordered_map &operator=(const unordered_map& x) {
+			if (this != &x){
+				unordered_map tmp(x);
+				swap(tmp);}
+			return *this;
+		};
+
+#if __cplusplus >= 201103L
+		// the moved-from map is left empty with no table
+		unordered_map(unordered_map&& x):
+			_hash(x._hash), _eq(x._eq), _alloc(x._alloc), _ctrlAlloc(x._ctrlAlloc), _ctrl(emptyGroup()), _slots(0),
+			_capacity(0), _size(0), _growthLeft(0)
+		{ swap(x); };
+
+		unordered_map &operator=(unordered_map&& x) {
+			if (this != &x){
+				clear();
+				swap(x);}
+			return *this;
+		};
+#endif
+
+		~unordered_map(){ release(); };
+
+		// Iterators
+		iterator begin() { iterator it(_ctrl, _slots); it.skipFree(); return (it); };
+		const_iterator begin() const { const_iterator it(_ctrl, _slots); it.skipFree(); return (it); };
+		iterator end() { return iterator(_ctrl + _capacity, _slots + _capacity); };
+		const_iterator end() const { return const_iterator(_ctrl + _capacity, _slots + _capacity); };
+
+		// Capacity
+		bool empty() const { return (_size == 0); };
+		size_type size() const { return (_size); };
+		size_type max_size() const { return (_alloc.max_size()); };
+
+		// Element access
+		mapped_type& operator[] (const key_type& k) {
+			size_t h = _hash(k);
+			size_t i = findIndex(k, h);
+
+			if (i == _capacity)
+				i = insertNew(value_type(k, mapped_type()), h);
+			return (_slots[i].second);
+		}
+
+		mapped_type& at (const key_type& k) {
+			size_t i = findIndex(k, _hash(k));
+
+			if (i == _capacity)
+				throw std::out_of_range("");
+			return (_slots[i].second);
+		}
+
+		const mapped_type& at (const key_type& k) const {
+			size_t i = findIndex(k, _hash(k));
+
+			if (i == _capacity)
+				throw std::out_of_range("");
+			return (_slots[i].second);
+		}
+
+		// Modifiers
+		ft::pair<iterator, bool> insert(const value_type& v) {
+			size_t h = _hash(v.first);
+			size_t i = findIndex(v.first, h);
+
+			if (i != _capacity)
+				return (ft::make_pair(iterAt(i), false));
+			return (ft::make_pair(iterAt(insertNew(v, h)), true));
+		}
+
+		iterator insert (iterator position, const value_type& val) {
+			(void)position;
+			return (insert(val).first);
+		}
+
+		template <class InputIterator>
+		void insert (InputIterator first, InputIterator last) {
+			for (; first != last; ++first)
+				insert(value_type(first->first, first->second));
+		}
+
+		void erase (iterator position) { eraseAt(position.base() - _slots); }
+
+		size_type erase (const key_type& k) {
+			size_t i = findIndex(k, _hash(k));
+
+			if (i == _capacity)
+				return (0);
+			eraseAt(i);
+			return (1);
+		}
+
+		void erase (iterator first, iterator last) {
+			while (first != last)
+				erase(first++);
+		}
+
+		void swap (unordered_map& x) {
+			std::swap(_hash, x._hash);
+			std::swap(_eq, x._eq);
+			std::swap(_alloc, x._alloc);
+			std::swap(_ctrlAlloc, x._ctrlAlloc);
+			std::swap(_ctrl, x._ctrl);
+			std::swap(_slots, x._slots);
+			std::swap(_capacity, x._capacity);
+			std::swap(_size, x._size);
+			std::swap(_growthLeft, x._growthLeft);
+		}
+
+		// keeps the table
+		void clear() {
+			if (_capacity == 0)
+				return ;
+			destroyAll();
+			resetCtrl();
+			_size = 0;
+			_growthLeft = growth(_capacity);
+		}
+
+		// Lookup
+		iterator find (const key_type& k) { return (iterAt(findIndex(k, _hash(k)))); }
+		const_iterator find (const key_type& k) const { return (iterAt(findIndex(k, _hash(k)))); }
+
+		size_type count (const key_type& k) const { return (findIndex(k, _hash(k)) == _capacity ? 0 : 1); }
+
+		pair<iterator,iterator> equal_range (const key_type& k) {
+			iterator it = find(k);
+
+			if (it == end())
+				return (ft::make_pair(it, it));
+			iterator next = it;
+			return (ft::make_pair(it, ++next));
+		}
+
+		pair<const_iterator,const_iterator> equal_range (const key_type& k) const {
+			const_iterator it = find(k);
+
+			if (it == end())
+				return (ft::make_pair(it, it));
+			const_iterator next = it;
+			return (ft::make_pair(it, ++next));
+		}
+
+		// Hash policy
+		size_type bucket_count() const { return (_capacity); };
+		float load_factor() const { return (_capacity ? static_cast<float>(_size) / _capacity : 0.0f); };
+		float max_load_factor() const { return (0.875f); };
+
+		// room for n elements without a rehash
+		void reserve (size_type n) {
+			size_type cap = width - 1;
+
+			if (n <= _size + _growthLeft)
+				return ;
+			while (growth(cap) < n)
+				cap = cap * 2 + 1;
+			resize(cap);
+		}
+
+		void rehash (size_type n) {
+			size_type cap = width - 1;
+
+			while (cap < n || growth(cap) < _size)
+				cap = cap * 2 + 1;
+			if (cap != _capacity)
+				resize(cap);
+		}
+
+		allocator_type get_allocator() const { return (allocator_type(_alloc)); };
+
+		// Observers
+		hasher hash_function() const { return (_hash); };
+		key_equal key_eq() const { return (_eq); };
+
+		// Non-member functions:
+		friend bool	operator == (const unordered_map& x, const unordered_map& y){
+			if (x.size() != y.size())
+				return false;
+			for (const_iterator it = x.begin(); it != x.end(); ++it){
+				const_iterator other = y.find(it->first);
+				if (other == y.end() || !(other->second == it->second))
+					return false;}
+			return true;
+		};
+
+		friend bool	operator != (const unordered_map& x, const unordered_map& y){ return !(x == y); };
+
+	private:
+		// a table of capacity 0 still has one group to probe: the sentinel, then empty bytes
+		static signed char* emptyGroup() {
+			static signed char group[width] = { swissSentinel, swissEmpty, swissEmpty, swissEmpty, swissEmpty,
+				swissEmpty, swissEmpty, swissEmpty, swissEmpty, swissEmpty, swissEmpty, swissEmpty, swissEmpty,
+				swissEmpty, swissEmpty, swissEmpty };
+			return (group);
+		}
+
+		// h1 picks the first group, h2 is the control byte
+		static size_t h1(size_t h) { return (h >> 7); }
+		static signed char h2(size_t h) { return (static_cast<signed char>(h & 0x7f)); }
+
+		static size_type growth(size_type cap) { return (cap - cap / 8); }
+
+		iterator iterAt(size_t i) { return (i == _capacity ? end() : iterator(_ctrl + i, _slots + i)); }
+		const_iterator iterAt(size_t i) const { return (i == _capacity ? end() : const_iterator(_ctrl + i, _slots + i)); }
+
+		// probes group after group (triangular steps visit every group once); a group with an
+		// empty byte ends the search. Returns the slot of k or _capacity
+		size_t findIndex(const key_type& k, size_t h) const {
+			size_t		pos = h1(h) & _capacity;
+			size_t		step = 0;
+			signed char	tag = h2(h);
+
+			while (true){
+				swissGroup g(_ctrl + pos);
+				for (unsigned m = g.match(tag); m; m &= m - 1){
+					size_t i = (pos + swissGroup::first(m)) & _capacity;
+					if (_eq(_slots[i].first, k))
+						return (i);}
+				if (g.matchEmpty())
+					return (_capacity);
+				step += width;
+				pos = (pos + step) & _capacity;
+			}
+		}
+
+		// first empty or deleted slot on h's probe sequence
+		size_t findFree(size_t h) const {
+			size_t pos = h1(h) & _capacity;
+			size_t step = 0;
+
+			while (true){
+				unsigned m = swissGroup(_ctrl + pos).matchEmptyOrDeleted();
+				if (m)
+					return ((pos + swissGroup::first(m)) & _capacity);
+				step += width;
+				pos = (pos + step) & _capacity;
+			}
+		}
+
+		// writes a control byte and its copy behind the sentinel
+		void setCtrl(size_t i, signed char c) {
+			_ctrl[i] = c;
+			_ctrl[((i - (width - 1)) & _capacity) + ((width - 1) & _capacity)] = c;
+		}
+
+		// v's key is known to be absent
+		size_t insertNew(const value_type& v, size_t h) {
+			size_t i = findFree(h);
+
+			if (_growthLeft == 0 && _ctrl[i] != swissDeleted){
+				grow();
+				i = findFree(h);}
+			_alloc.construct(_slots + i, v);
+			_growthLeft -= (_ctrl[i] == swissEmpty);
+			setCtrl(i, h2(h));
+			++_size;
+			return (i);
+		}
+
+		// a slot can go back to empty when no probe sequence ever found its group full: then
+		// the empty bytes around it are less than a group apart. Otherwise it becomes a tombstone
+		void eraseAt(size_t i) {
+			unsigned after = swissGroup(_ctrl + i).matchEmpty();
+			unsigned before = swissGroup(_ctrl + ((i - width) & _capacity)).matchEmpty();
+			bool neverFull = after && before && swissGroup::first(after) + swissGroup::leadingZeros(before) < width;
+
+			_alloc.destroy(_slots + i);
+			setCtrl(i, neverFull ? static_cast<signed char>(swissEmpty) : static_cast<signed char>(swissDeleted));
+			_growthLeft += neverFull;
+			--_size;
+		}
+
+		// doubles, or only drops the tombstones when they are what filled the table
+		void grow() {
+			if (_capacity && _size * 32 <= _capacity * 25)
+				resize(_capacity);
+			else
+				resize(_capacity ? _capacity * 2 + 1 : width - 1);
+		}
+
+		void resetCtrl() {
+			for (size_t i = 0; i < _capacity + width; ++i)
+				_ctrl[i] = swissEmpty;
+			_ctrl[_capacity] = swissSentinel;
+		}
+
+		void destroyAll() {
+			for (size_t i = 0; i < _capacity; ++i)
+				if (_ctrl[i] >= 0)
+					_alloc.destroy(_slots + i);
+		}
+
+		void release() {
+			if (_capacity == 0)
+				return ;
+			destroyAll();
+			_ctrlAlloc.deallocate(_ctrl, _capacity + width);
+			_alloc.deallocate(_slots, _capacity);
+		}
+
+		// moves every element into a new table of capacity cap; on an exception the old table stays
+		void resize(size_type cap) {
+			unordered_map tmp(0, _hash, _eq, allocator_type(_alloc));
+
+			tmp._ctrl = tmp._ctrlAlloc.allocate(cap + width);
+			try { tmp._slots = tmp._alloc.allocate(cap); }
+			catch (...) { tmp._ctrlAlloc.deallocate(tmp._ctrl, cap + width); tmp._ctrl = emptyGroup(); throw ; }
+			tmp._capacity = cap;
+			tmp.resetCtrl();
+			tmp._growthLeft = growth(cap) - _size;
+			for (size_t i = 0; i < _capacity; ++i){
+				if (_ctrl[i] < 0)
+					continue ;
+				size_t h = _hash(_slots[i].first);
+				size_t j = tmp.findFree(h);
+				tmp._alloc.construct(tmp._slots + j, _slots[i]);
+				tmp.setCtrl(j, h2(h));
+				++tmp._size;
+			}
+			swap(tmp);
+		}
+
+	};
+
+	template <class Key, class T, class Hash, class KeyEqual, class Allocator>
+	void swap (unordered_map<Key, T, Hash, KeyEqual, Allocator>& x, unordered_map<Key, T, Hash, KeyEqual, Allocator>& y)
+	{
+		x.swap(y);
+	}
+
+}
+
+#endif
@@ -2,6 +2,11 @@
 #define UTILS_HPP
 
 #include <memory> 
+#include <string>
+#include <stdint.h>
+#if __cplusplus >= 201103L
+# include <type_traits>
+#endif
 
 namespace ft
 {
@@ -125,17 +130,65 @@ namespace ft
 	bool operator>= (const pair<T1,T2>& lhs, const pair<T1,T2>& rhs)
 	{ return !(lhs<rhs); }
 
-	// template <class T>
-	// struct remove_const {
-	// 	typedef T type;	};
+	template <class T>
+	struct remove_const {
+		typedef T type;	};
 		
-	// template <class T>
-	// struct remove_const <const T>{
-	// 	typedef T type;	};
+	template <class T>
+	struct remove_const <const T>{
+		typedef T type;	};
 	
 
+	// __is_convertible_to is a clang/MSVC builtin; other compilers get the library trait
+#if defined(__clang__) || __cplusplus < 201103L
 	template <class _T1, class _T2> 
 	struct is_convertible: public ft::integral_constant<bool,  __is_convertible_to(_T1, _T2)> {};
+#else
+	template <class _T1, class _T2> 
+	struct is_convertible: public ft::integral_constant<bool,  std::is_convertible<_T1, _T2>::value> {};
+#endif
+
+	// hash: integral keys go through a 64-bit finalizer, so consecutive keys land far apart
+	// in the low and the high bits alike (shards and tables may use either)
+	inline size_t hashMix(uint64_t x)
+	{
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdULL;
+		x ^= x >> 33;
+		x *= 0xc4ceb9fe1a85ec53ULL;
+		x ^= x >> 33;
+		return (static_cast<size_t>(x));
+	}
+
+	// FNV-1a over a byte range, finalized like the integral keys
+	inline size_t hashBytes(const void* p, size_t n)
+	{
+		const unsigned char*	b = static_cast<const unsigned char*>(p);
+		uint64_t				h = 0xcbf29ce484222325ULL;
+
+		for (size_t i = 0; i < n; ++i){
+			h ^= b[i];
+			h *= 0x100000001b3ULL;}
+		return (hashMix(h));
+	}
+
+	template <class T>
+	struct hash
+	{
+		size_t operator()(const T& v) const { return (hashMix(static_cast<uint64_t>(v))); }
+	};
+
+	template <class T>
+	struct hash<T*>
+	{
+		size_t operator()(T* p) const { return (hashMix(reinterpret_cast<uintptr_t>(p))); }
+	};
+
+	template <class Char, class Traits, class Alloc>
+	struct hash<std::basic_string<Char, Traits, Alloc> >
+	{
+		size_t operator()(const std::basic_string<Char, Traits, Alloc>& s) const { return (hashBytes(s.data(), s.size() * sizeof(Char))); }
+	};
 
 	
 
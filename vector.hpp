@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <iostream>
+#include <utility>
 #include "iterator.hpp"
 #include "utils.hpp"
 
@@ -54,20 +55,57 @@ namespace ft
 			vector &operator=(const vector& x)
 			{
 
-				if (this != &x)
+				if (this != &x && x._size > _capacity)
 				{
 					clear();
 					_alloc.deallocate(_p, _capacity);
-					_size = x._size;
+					_p = 0;
+					_capacity = 0;
+					_p = _alloc.allocate(x._capacity);
 					_capacity = x._capacity;
-					_p = _alloc.allocate(_capacity);
 
-					for (size_type i = 0; i < _size; ++i)
-						_alloc.construct(_p + i, *(x._p + i));
+					for (; _size < x._size; ++_size)
+						_alloc.construct(_p + _size, *(x._p + _size));
+				}
+				else if (this != &x)
+				{
+					// the buffer fits: live elements are assigned over, the rest constructed or destroyed
+					size_type i = 0;
+
+					for (; i < _size && i < x._size; ++i)
+						_p[i] = x._p[i];
+					for (; _size < x._size; ++_size)
+						_alloc.construct(_p + _size, *(x._p + _size));
+					while (_size > x._size)
+						pop_back();
 				}
 				return (*this);
 			};
 			
+#if __cplusplus >= 201103L
+			vector (vector&& x): _alloc(x._alloc), _p(x._p), _size(x._size), _capacity(x._capacity){
+				x._p = 0;
+				x._size = 0;
+				x._capacity = 0;
+			};
+
+			vector &operator=(vector&& x)
+			{
+				if (this != &x)
+				{
+					clear();
+					_alloc.deallocate(_p, _capacity);
+					_p = x._p;
+					_size = x._size;
+					_capacity = x._capacity;
+					x._p = 0;
+					x._size = 0;
+					x._capacity = 0;
+				}
+				return (*this);
+			};
+#endif
+
 			~vector(){
 				clear();
 				_alloc.deallocate(_p, _capacity);
@@ -84,7 +122,7 @@ namespace ft
 			void resize (size_type n, value_type val = value_type())
 			{
 				if (_capacity < n)
-					reserve(_capacity*2);
+					reserve(n > _capacity * 2 ? n : _capacity * 2);
 				for (; _size < n; _size++)
 					_alloc.construct(_p + _size, val);
 				for (; _size > n;)
@@ -100,7 +138,7 @@ namespace ft
 					throw (std::bad_alloc());
 				if (n <= _capacity)
 					return ;
-					pointer _oldp = _p;
+				pointer _oldp = _p;
 				size_type _oldcap = _capacity;
 				_capacity = n;
 				_p = _alloc.allocate(_capacity);
@@ -362,7 +400,7 @@ namespace ft
 			const_reverse_iterator rend() const {return const_reverse_iterator(begin());};
 
 			// Allocator:
-			allocator_type get_allocator() const {}
+			allocator_type get_allocator() const { return (_alloc); }
 
 			// Non-member function overloads
 			template <class TF, class AllocF>